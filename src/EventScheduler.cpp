@@ -61,4 +61,35 @@ bool EventScheduler::isPending(const Event &event) const
     return false;
 }
 
+#ifdef ENABLE_STATS
+void EventScheduler::account(const Event &event, uint_least64_t nanoseconds)
+{
+    // Events are grouped by name, the CPU ones come first
+    // so the search is usually short
+    unsigned int i = 0;
+    while ((i < m_eventTypes) && (m_stats[i].name != event.name()))
+        i++;
+
+    if (i == m_eventTypes)
+    {
+        if (m_eventTypes == MAX_EVENT_TYPES)
+        {
+            // Table is full, lump the rest into the last slot
+            i = MAX_EVENT_TYPES - 1;
+            m_stats[i].name = "Other";
+        }
+        else
+        {
+            m_stats[i].name = event.name();
+            m_stats[i].count = 0;
+            m_stats[i].nanoseconds = 0;
+            m_eventTypes++;
+        }
+    }
+
+    m_stats[i].count++;
+    m_stats[i].nanoseconds += nanoseconds;
+}
+#endif
+
 }
@@ -27,6 +27,9 @@
 
 #include "sidcxx11.h"
 
+#ifdef ENABLE_STATS
+#  include <chrono>
+#endif
 
 namespace libsidplayfp
 {
@@ -60,6 +63,33 @@ using event_phase_t = enum
  */
 class EventScheduler
 {
+#ifdef ENABLE_STATS
+public:
+    /// Dispatch counters for a type of event.
+    struct EventStats
+    {
+        const char *name;
+        uint_least64_t count;
+        uint_least64_t nanoseconds;
+    };
+
+    static constexpr unsigned int MAX_EVENT_TYPES = 32;
+
+private:
+    EventStats m_stats[MAX_EVENT_TYPES];
+
+    unsigned int m_eventTypes = 0;
+
+private:
+    /**
+     * Account a dispatched event.
+     *
+     * @param event the event
+     * @param nanoseconds the time spent
+     */
+    void account(const Event &event, uint_least64_t nanoseconds);
+#endif
+
 private:
     /// The first event of the chain.
     Event *firstEvent = nullptr;
@@ -138,7 +168,14 @@ public:
         Event &event = *firstEvent;
         firstEvent = firstEvent->next;
         currentTime = event.triggerTime;
+#ifdef ENABLE_STATS
+        const auto start = std::chrono::steady_clock::now();
+        event.event();
+        const auto end = std::chrono::steady_clock::now();
+        account(event, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+#else
         event.event();
+#endif
     }
 
     /**
@@ -168,6 +205,23 @@ public:
     event_phase_t phase() const { return static_cast<event_phase_t>(currentTime & 1); }
 
     event_clock_t remaining(const Event &event) const { return event.triggerTime - currentTime; }
+
+#ifdef ENABLE_STATS
+    /**
+     * Get the number of event types dispatched so far.
+     */
+    unsigned int eventTypes() const { return m_eventTypes; }
+
+    /**
+     * Get the counters for a type of event.
+     */
+    const EventStats &eventStats(unsigned int i) const { return m_stats[i]; }
+
+    /**
+     * Clear the dispatch counters.
+     */
+    void resetStats() { m_eventTypes = 0; }
+#endif
 };
 
 }
@@ -22,8 +22,6 @@
 
 #include "residfp-emu.h"
 
-#include <cmath>
-
 #include "residfp/residfp.h"
 #include "sidplayfp/siddefs.h"
 
@@ -126,9 +124,7 @@ void reSIDfpEmu::sampling(float systemclock, float freq,
     if (m_buffer)
         delete[] m_buffer;
 
-    // 20ms buffer
-    const int buffersize = std::ceil((freq / 1000.f) * 20.f);
-    m_buffer = new short[buffersize];
+    m_buffer = new short[bufferSize(systemclock, freq, m_bufferCycles)];
     m_status = true;
 }
 
@@ -22,7 +22,7 @@
 
 #include "sidlite-emu.h"
 
-#include <cmath>
+#include "simpleMixer.h"
 
 //#include "sidlite/siddefs.h"
 #include "sidplayfp/siddefs.h"
@@ -53,6 +53,7 @@ SIDLiteEmu::SIDLiteEmu(sidbuilder *builder) :
 
 SIDLiteEmu::~SIDLiteEmu()
 {
+    ungroup();
     delete &m_sid;
     delete[] m_buffer;
 }
@@ -79,11 +80,108 @@ void SIDLiteEmu::write(uint_least8_t addr, uint8_t data)
 
 void SIDLiteEmu::clock()
 {
+    if (m_leader)
+    {
+        m_leader->clockGroup();
+        return;
+    }
+
     const event_clock_t cycles = eventScheduler->getTime(EVENT_CLOCK_PHI1) - m_accessClk;
     m_accessClk += cycles;
     m_bufferpos += m_sid.clock(cycles, m_buffer+m_bufferpos);
 }
 
+void SIDLiteEmu::clockGroup()
+{
+    // any access brings all the chips up to date
+    const event_clock_t cycles = eventScheduler->getTime(EVENT_CLOCK_PHI1) - m_accessClk;
+    m_accessClk += cycles;
+    const int samples = m_multiSid->clock(cycles, m_buffer + m_bufferpos * m_channels);
+
+    for (SIDLiteEmu *s: m_group)
+        s->m_bufferpos += samples;
+}
+
+bool SIDLiteEmu::premix(const SimpleMixer &mixer, const std::vector<sidemu*> &chips)
+{
+    if ((chips.size() > SIDLite::MultiSID::MAX_CHIPS)
+        || (mixer.channels() > SIDLite::MultiSID::MAX_CHANNELS))
+        return false;
+
+    std::vector<SIDLiteEmu*> group;
+    SIDLite::SID *sids[SIDLite::MultiSID::MAX_CHIPS];
+    for (sidemu *chip: chips)
+    {
+        // chips from the same builder are SIDLiteEmu,
+        // they must be in sync with nothing left to mix
+        if ((chip->builder() != builder()) || (chip->bufferpos() != 0))
+            return false;
+
+        SIDLiteEmu *emu = static_cast<SIDLiteEmu*>(chip);
+        if (emu->m_accessClk != m_accessClk)
+            return false;
+
+        sids[group.size()] = &emu->m_sid;
+        group.push_back(emu);
+    }
+
+    // a single chip goes through the mixer, keeping its own buffer
+    if ((group.size() < 2) || (group.front() != this))
+        return false;
+
+    for (SIDLiteEmu *s: group)
+        s->ungroup();
+
+    int weights[SIDLite::MultiSID::MAX_CHANNELS][SIDLite::MultiSID::MAX_CHIPS];
+    for (unsigned int c = 0; c < mixer.channels(); c++)
+    {
+        for (unsigned int k = 0; k < group.size(); k++)
+            weights[c][k] = mixer.weight(c, k);
+    }
+
+    m_multiSid.reset(new SIDLite::MultiSID(sids, group.size()));
+    m_multiSid->setMixer(mixer.channels(), weights, mixer.scale(), mixer.divisor());
+
+    m_channels = mixer.channels();
+    allocateBuffer();
+
+    for (SIDLiteEmu *s: group)
+        s->m_leader = this;
+    m_group = std::move(group);
+
+    return true;
+}
+
+void SIDLiteEmu::ungroup()
+{
+    SIDLiteEmu *leader = m_leader;
+    if (!leader)
+        return;
+
+    for (SIDLiteEmu *s: leader->m_group)
+    {
+        // the chips were clocked along with the first one
+        s->m_accessClk = leader->m_accessClk;
+        s->m_leader = nullptr;
+    }
+
+    leader->m_group.clear();
+    leader->m_multiSid.reset();
+    leader->m_channels = 1;
+}
+
+void SIDLiteEmu::unlock()
+{
+    ungroup();
+    sidemu::unlock();
+}
+
+void SIDLiteEmu::allocateBuffer()
+{
+    delete[] m_buffer;
+    m_buffer = new short[m_buffersize * m_channels];
+}
+
 int SIDLiteEmu::getLevel() const
 {
     return m_sid.getLevel();
@@ -117,14 +215,11 @@ void SIDLiteEmu::sampling(float systemclock, float freq,
     {
         m_status = false;
         m_error = ERR_UNSUPPORTED_FREQ;
+        return;
     }
 
-    if (m_buffer)
-        delete[] m_buffer;
-
-    // 20ms buffer
-    const int buffersize = std::ceil((freq / 1000.f) * 20.f);
-    m_buffer = new short[buffersize];
+    m_buffersize = bufferSize(systemclock, freq, m_bufferCycles);
+    allocateBuffer();
     m_status = true;
 }
 
@@ -24,8 +24,11 @@
 #define SIDLITE_EMU_H
 
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "sidlite/SID.h"
+#include "sidlite/MultiSID.h"
 #include "sidplayfp/SidConfig.h"
 #include "sidemu.h"
 #include "Event.h"
@@ -43,6 +46,28 @@ class SIDLiteEmu final : public sidemu
 private:
     SIDLite::SID &m_sid;
 
+    /// Lockstep renderer, owned by the first chip of a group
+    std::unique_ptr<SIDLite::MultiSID> m_multiSid;
+
+    /// The chips of the group, valid on the first chip
+    std::vector<SIDLiteEmu*> m_group;
+
+    /// The first chip of the group this one belongs to
+    SIDLiteEmu *m_leader = nullptr;
+
+    /// Buffer size in samples per channel
+    int m_buffersize = 0;
+
+    /// Interleaved channels in the buffer
+    int m_channels = 1;
+
+private:
+    void allocateBuffer();
+
+    void clockGroup();
+
+    void ungroup();
+
 public:
     static const char* getCredits();
 
@@ -61,6 +86,10 @@ public:
     // Standard SID emu functions
     void clock() override;
 
+    void unlock() override;
+
+    bool premix(const SimpleMixer &mixer, const std::vector<sidemu*> &chips) override;
+
     void sampling(float systemclock, float freq,
         SidConfig::sampling_method_t method) override;
 
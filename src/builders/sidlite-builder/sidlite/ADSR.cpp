@@ -56,7 +56,83 @@ static const unsigned char ADSRexponentPeriods[256] =
     1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
 };
 
-void ADSR::clock(char cycles)
+inline unsigned short ADSR::prescalePeriod(int Channel, unsigned char AD, unsigned char SR) const
+{
+    if (ADSRstate[Channel] & ATTACK_BITVAL)
+        return ADSRprescalePeriods[AD >> 4];
+    else if (ADSRstate[Channel] & DECAYSUSTAIN_BITVAL)
+        return ADSRprescalePeriods[AD & 0x0F];
+    else
+        return ADSRprescalePeriods[SR & 0x0F];
+}
+
+// The rate counter is advanced in batches instead of small chunks:
+// as the shortest rate period is longer than a chunk there can be
+// at most one period match per chunk and the remainder is kept
+// after the match, so the result doesn't depend on the chunk size.
+// This allows jumping straight from one period match to the next one.
+void ADSR::clockChannel(int Channel, unsigned char AD, unsigned char SR, unsigned int cycles)
+{
+    unsigned char *ADSRstatePtr = &(ADSRstate[Channel]);
+    unsigned char *EnvelopeCounterPtr = &(EnvelopeCounter[Channel]);
+    unsigned char *ExponentCounterPtr = &(ExponentCounter[Channel]);
+
+    unsigned int RateCounterVal = RateCounter[Channel];
+
+    for (;;)
+    {
+        const unsigned short PrescalePeriod = prescalePeriod(Channel, AD, SR);
+
+        if (UNLIKELY(RateCounterVal >= PrescalePeriod))
+        {
+            // period already passed, count until wrap around (ADSR delay-bug: short 1st frame)
+            const unsigned int ToWrap = 0x8000 - RateCounterVal;
+            if (LIKELY(cycles < ToWrap))
+            {
+                RateCounterVal += cycles;
+                break;
+            }
+            cycles -= ToWrap;
+            RateCounterVal = 0;
+            continue;
+        }
+
+        const unsigned int ToPeriod = PrescalePeriod - RateCounterVal;
+        if (LIKELY(cycles < ToPeriod))
+        {
+            RateCounterVal += cycles;
+            break;
+        }
+
+        // ratecounter shot (matches rateperiod) (in genuine SID ratecounter is LFSR)
+        cycles -= ToPeriod;
+        RateCounterVal = 0; // reset rate-counter on period-match
+        if ((*ADSRstatePtr & ATTACK_BITVAL) || ++(*ExponentCounterPtr) == ADSRexponentPeriods[*EnvelopeCounterPtr])
+        {
+            *ExponentCounterPtr = 0;
+            if (*ADSRstatePtr & HOLDZEROn_BITVAL)
+            {
+                if (*ADSRstatePtr & ATTACK_BITVAL)
+                {
+                    ++(*EnvelopeCounterPtr);
+                    if (*EnvelopeCounterPtr == 0xFF)
+                        *ADSRstatePtr &= ~ATTACK_BITVAL;
+                }
+                else if (!(*ADSRstatePtr & DECAYSUSTAIN_BITVAL) || *EnvelopeCounterPtr != (SR&0xF0)+(SR>>4))
+                {
+                    --(*EnvelopeCounterPtr); // resid adds 1 cycle delay, we omit that mechanism here
+                    if (*EnvelopeCounterPtr == 0)
+                        *ADSRstatePtr &= ~HOLDZEROn_BITVAL;
+                }
+            }
+        }
+    }
+
+    RateCounter[Channel] = RateCounterVal;
+}
+
+void ADSR::clock(const unsigned int *cycles, int samples, unsigned int tail,
+                 unsigned char (*envelope)[BLOCK_SAMPLES])
 {
     for (int Channel=0, ChBase=0; Channel<SID_CHANNEL_COUNT; Channel++, ChBase+=7)
     {
@@ -64,9 +140,6 @@ void ADSR::clock(char cycles)
         unsigned char AD = ChannelPtr[5];
         unsigned char SR = ChannelPtr[6];
         unsigned char *ADSRstatePtr = &(ADSRstate[Channel]);
-        unsigned short *RateCounterPtr = &(RateCounter[Channel]);
-        unsigned char *EnvelopeCounterPtr = &(EnvelopeCounter[Channel]);
-        unsigned char *ExponentCounterPtr = &(ExponentCounter[Channel]);
 
         unsigned char PrevGate = (*ADSRstatePtr & GATE_BITVAL);
         // gatebit-change?
@@ -80,44 +153,45 @@ void ADSR::clock(char cycles)
                 *ADSRstatePtr = (GATE_BITVAL | ATTACK_BITVAL | DECAYSUSTAIN_BITVAL | HOLDZEROn_BITVAL);
         }
 
-        unsigned short PrescalePeriod;
-        if (*ADSRstatePtr & ATTACK_BITVAL)
-            PrescalePeriod = ADSRprescalePeriods[AD >> 4];
-        else if (*ADSRstatePtr & DECAYSUSTAIN_BITVAL)
-            PrescalePeriod = ADSRprescalePeriods[AD & 0x0F];
-        else
-            PrescalePeriod = ADSRprescalePeriods[SR & 0x0F];
-
-        *RateCounterPtr += cycles;
-        if (UNLIKELY(*RateCounterPtr >= 0x8000))
-            // can wrap around (ADSR delay-bug: short 1st frame)
-            *RateCounterPtr -= 0x8000; //*RateCounterPtr &= 0x7FFF;
-
-        if (UNLIKELY(PrescalePeriod <= *RateCounterPtr && *RateCounterPtr < PrescalePeriod+cycles))
+        // most of the time the rate counter doesn't reach the period
+        // between two samples, only advance it then
+        unsigned int RateCounterVal = RateCounter[Channel];
+        unsigned int PrescalePeriod = prescalePeriod(Channel, AD, SR);
+        unsigned char Envelope = EnvelopeCounter[Channel];
+        unsigned char *EnvelopePtr = envelope[Channel];
+        for (int i=0; i<samples; i++)
         {
-            // ratecounter shot (matches rateperiod) (in genuine SID ratecounter is LFSR)
-            *RateCounterPtr -= PrescalePeriod; // reset rate-counter on period-match
-            if ((*ADSRstatePtr & ATTACK_BITVAL) || ++(*ExponentCounterPtr) == ADSRexponentPeriods[*EnvelopeCounterPtr])
+            if (LIKELY(RateCounterVal + cycles[i] < PrescalePeriod))
             {
-                *ExponentCounterPtr = 0;
-                if (*ADSRstatePtr & HOLDZEROn_BITVAL)
-                {
-                    if (*ADSRstatePtr & ATTACK_BITVAL)
-                    {
-                        ++(*EnvelopeCounterPtr);
-                        if (*EnvelopeCounterPtr == 0xFF)
-                            *ADSRstatePtr &= ~ATTACK_BITVAL;
-                    }
-                    else if (!(*ADSRstatePtr & DECAYSUSTAIN_BITVAL) || *EnvelopeCounterPtr != (SR&0xF0)+(SR>>4))
-                    {
-                        --(*EnvelopeCounterPtr); // resid adds 1 cycle delay, we omit that mechanism here
-                        if (*EnvelopeCounterPtr == 0)
-                            *ADSRstatePtr &= ~HOLDZEROn_BITVAL;
-                    }
-                }
+                RateCounterVal += cycles[i];
             }
+            else
+            {
+                RateCounter[Channel] = RateCounterVal;
+                clockChannel(Channel, AD, SR, cycles[i]);
+                RateCounterVal = RateCounter[Channel];
+                PrescalePeriod = prescalePeriod(Channel, AD, SR);
+                Envelope = EnvelopeCounter[Channel];
+            }
+            EnvelopePtr[i] = Envelope;
         }
+        RateCounter[Channel] = RateCounterVal;
+
+        if (tail)
+            clockChannel(Channel, AD, SR, tail);
+    }
+}
+
+bool ADSR::isSilent() const
+{
+    for (int Channel=0, ChBase=0; Channel<SID_CHANNEL_COUNT; Channel++, ChBase+=7)
+    {
+        if ((m_regs[ChBase+4] & GATE_BITVAL)
+            || (ADSRstate[Channel] & (GATE_BITVAL | HOLDZEROn_BITVAL))
+            || EnvelopeCounter[Channel])
+            return false;
     }
+    return true;
 }
 
 ADSR::ADSR(unsigned char *regs) :
@@ -23,6 +23,8 @@
 #ifndef SIDLITE_ADSR_H
 #define SIDLITE_ADSR_H
 
+#include "sl_constants.h"
+
 namespace SIDLite
 {
 
@@ -31,10 +33,31 @@ class ADSR
 public:
     explicit ADSR(unsigned char *regs);
     void reset();
-    void clock(char cycles);
+
+    /**
+     * Advance the envelope generators for a block of samples.
+     * The registers must not change during the block.
+     *
+     * @param cycles the cycles elapsed before each sample
+     * @param samples the number of samples in the block
+     * @param tail the cycles elapsed after the last sample
+     * @param envelope the envelope of each voice at every sample
+     */
+    void clock(const unsigned int *cycles, int samples, unsigned int tail,
+               unsigned char (*envelope)[BLOCK_SAMPLES]);
+
+    /**
+     * Check if all the envelopes are released and held at zero,
+     * the voices stay silent until a gate bit is set.
+     */
+    bool isSilent() const;
 
     inline unsigned char counter(int channel) const { return EnvelopeCounter[channel]; }
 
+private:
+    inline unsigned short prescalePeriod(int Channel, unsigned char AD, unsigned char SR) const;
+    void clockChannel(int Channel, unsigned char AD, unsigned char SR, unsigned int cycles);
+
 private:
     unsigned char *m_regs;
 
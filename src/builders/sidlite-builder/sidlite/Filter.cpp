@@ -30,6 +30,7 @@
 
 #include <map>
 #include <mutex>
+#include <cstdint>
 #include <cstdlib>
 #include <cmath>
 
@@ -61,16 +62,15 @@ constexpr int VUMETER_DIVSHIFTS = 4 - CRSID_WAVGEN_PRESHIFT;
 
 constexpr int Attenuation = ((SID_FULLVOLUME+26) * CRSID_PRESAT_ATT_NOM) / (CRSID_PRESAT_ATT_DENOM * CRSID_WAVGEN_PREDIV);
 
-int Filter::clock(int FilterInput, int NonFiltered)
-{
-    enum SIDspecs { HIGHPASS_BITVAL=0x40, BANDPASS_BITVAL=0x20, LOWPASS_BITVAL=0x10 };
+enum SIDspecs { HIGHPASS_BITVAL=0x40, BANDPASS_BITVAL=0x20, LOWPASS_BITVAL=0x10 };
 
-    //Filter
-    unsigned char FilterSwitchReso = m_regs[0x17];
-    unsigned char VolumeBand = m_regs[0x18];
+void Filter::latch()
+{
+    const unsigned char FilterSwitchReso = m_regs[0x17];
+    VolumeBand = m_regs[0x18];
 
-    int Cutoff = (m_regs[0x16] << 3) + (m_regs[0x15] & 7);
-    int Resonance = FilterSwitchReso >> 4;
+    Cutoff = (m_regs[0x16] << 3) + (m_regs[0x15] & 7);
+    Resonance = FilterSwitchReso >> 4;
     if (LIKELY(m_settings->is8580()))
     {
         Cutoff = CutoffMul8580[Cutoff];
@@ -78,26 +78,36 @@ int Filter::clock(int FilterInput, int NonFiltered)
     }
     else
     { // 6581
-        // MOSFET-VCR control-voltage calculation (resistance-modulation aka 6581 filter distortion) emulation
-        Cutoff += (FilterInput*105)>>16;
-        if (Cutoff > SID_CUTOFF_MAX)
-            Cutoff = SID_CUTOFF_MAX;
-        else if (Cutoff < 0)
-            Cutoff = 0;
-        Cutoff = CutoffMul6581[Cutoff];
         Resonance = Resonances6581[Resonance];
     }
+    Settled = false;
+}
+
+inline int Filter::filter(int FilterInput, int NonFiltered)
+{
+    //Filter
+    int CutoffMul = Cutoff;
+    if (!m_settings->is8580())
+    {
+        // MOSFET-VCR control-voltage calculation (resistance-modulation aka 6581 filter distortion) emulation
+        CutoffMul += (FilterInput*105)>>16;
+        if (CutoffMul > SID_CUTOFF_MAX)
+            CutoffMul = SID_CUTOFF_MAX;
+        else if (CutoffMul < 0)
+            CutoffMul = 0;
+        CutoffMul = CutoffMul6581[CutoffMul];
+    }
 
     int FilterOutput = 0;
     {
         int Tmp = FilterInput + ((PrevBandPass * Resonance) / CRSID_FILTERTABLE_MAGNITUDE) + PrevLowPass;
         if (VolumeBand & HIGHPASS_BITVAL)
             FilterOutput -= Tmp;
-        Tmp = PrevBandPass - ((Tmp * Cutoff) / CRSID_FILTERTABLE_MAGNITUDE);
+        Tmp = PrevBandPass - ((Tmp * CutoffMul) / CRSID_FILTERTABLE_MAGNITUDE);
         PrevBandPass = Tmp;
         if (VolumeBand & BANDPASS_BITVAL)
             FilterOutput -= Tmp;
-        Tmp = PrevLowPass + ((Tmp * Cutoff) / CRSID_FILTERTABLE_MAGNITUDE);
+        Tmp = PrevLowPass + ((Tmp * CutoffMul) / CRSID_FILTERTABLE_MAGNITUDE);
         PrevLowPass = Tmp;
         if (VolumeBand & LOWPASS_BITVAL)
             FilterOutput += Tmp;
@@ -129,16 +139,93 @@ int Filter::clock(int FilterInput, int NonFiltered)
     else
         MainVolume = VolumeBand & 0xF;
 
-    int Output = ((NonFiltered+FilterOutput) * MainVolume) + Digi;// / ((CHANNELS*VOLUME_MAX) + Attenuation);
+    return ((NonFiltered+FilterOutput) * MainVolume) + Digi;// / ((CHANNELS*VOLUME_MAX) + Attenuation);
+}
 
+inline void Filter::updateLevel(int Output)
+{
     if (UNLIKELY(!++VUmeterUpdateCounter))
     {
         // average level (for VU-meter)
         Level += ((std::abs(Output) >> VUMETER_DIVSHIFTS) - Level) / VUMETER_LOWPASS_DIV;
     }
+}
+
+inline int Filter::clock(int FilterInput, int NonFiltered)
+{
+    const int Output = filter(FilterInput, NonFiltered);
+    updateLevel(Output);
     return Output / Attenuation; // master output
 }
 
+int Filter::saturate(int sample)
+{
+    // saturation logic on overflow
+    if (sample > INT16_MAX)
+        return INT16_MAX;
+    if (sample < INT16_MIN)
+        return INT16_MIN;
+    return sample;
+}
+
+void Filter::clock(int samples, const int *filterInput, const int *nonFiltered, short *output)
+{
+    Settled = false;
+    for (int i=0; i<samples; i++)
+    {
+        output[i] = static_cast<short>(saturate(clock(filterInput[i], nonFiltered[i])));
+    }
+}
+
+void Filter::mix(int samples, const int *filterInput, const int *nonFiltered,
+                 int channels, const int *weights, int *mix)
+{
+    Settled = false;
+    if (channels == 1)
+    {
+        const int weight = weights[0];
+        for (int i=0; i<samples; i++)
+        {
+            mix[i] += weight * saturate(clock(filterInput[i], nonFiltered[i]));
+        }
+    }
+    else
+    {
+        for (int i=0; i<samples; i++)
+        {
+            const int sample = saturate(clock(filterInput[i], nonFiltered[i]));
+            for (int c=0; c<channels; c++)
+                mix[i * channels + c] += weights[c] * sample;
+        }
+    }
+}
+
+void Filter::silence(int samples, short *output)
+{
+    int i = 0;
+
+    // with no input the integrators and the volume lowpass
+    // decay until they stop changing
+    for (; !Settled && i<samples; i++)
+    {
+        const int BandPass = PrevBandPass;
+        const int LowPass = PrevLowPass;
+        const int Volume = PrevVolume;
+        HeldOutput = filter(0, 0);
+        updateLevel(HeldOutput);
+        output[i] = static_cast<short>(saturate(HeldOutput / Attenuation));
+        Settled = BandPass == PrevBandPass && LowPass == PrevLowPass && Volume == PrevVolume;
+    }
+
+    // from then on the output is constant
+    const short Held = static_cast<short>(saturate(HeldOutput / Attenuation));
+    for (; i<samples; i++)
+    {
+        updateLevel(HeldOutput);
+        output[i] = Held;
+    }
+}
+
 Filter::Filter(settings *s, unsigned char *regs) :
     m_regs(regs),
     m_settings(s)
@@ -151,17 +238,19 @@ void Filter::reset()
     PrevLowPass = PrevBandPass = PrevVolume = 0;
     Level = 0;
     VUmeterUpdateCounter = 0;
+    Settled = false;
+    HeldOutput = 0;
 }
 
 constexpr int CF_LEN = 0x800;
 using co_tab_t = std::array<unsigned short, CF_LEN>;
-using co_cache_t = std::map<unsigned short, co_tab_t>;
+using co_cache_t = std::map<unsigned int, co_tab_t>;
 
 static co_cache_t CUTOFF_CACHE_8580;
 static co_cache_t CUTOFF_CACHE_6581;
 static std::mutex CUTOFF_CACHE_Lock;
 
-void Filter::rebuildCutoffTables(unsigned short samplerate)
+void Filter::rebuildCutoffTables(unsigned int samplerate)
 {
     constexpr int Magnitude = (1 << CRSID_FILTERTABLE_RESOLUTION);
 
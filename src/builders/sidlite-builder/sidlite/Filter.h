@@ -33,11 +33,56 @@ class Filter
 public:
     Filter(settings *s, unsigned char *regs);
     void reset();
-    int clock(int FilterInput, int NonFiltered);
+
+    /**
+     * Filter and mix a block of samples.
+     *
+     * @param samples the number of samples
+     * @param filterInput the voices routed to the filter
+     * @param nonFiltered the voices bypassing the filter
+     * @param output the saturated output samples
+     */
+    void clock(int samples, const int *filterInput, const int *nonFiltered, short *output);
+
+    /**
+     * Filter a block of samples and add them to a mix.
+     *
+     * @param samples the number of samples
+     * @param filterInput the voices routed to the filter
+     * @param nonFiltered the voices bypassing the filter
+     * @param channels the number of interleaved channels in the mix
+     * @param weights the weight of the saturated output for each channel
+     * @param mix the interleaved mix accumulators
+     */
+    void mix(int samples, const int *filterInput, const int *nonFiltered,
+             int channels, const int *weights, int *mix);
+
+    /**
+     * Render a block of samples with no input from the voices.
+     * Once the filter has settled the output is held
+     * until the registers change.
+     *
+     * @param samples the number of samples
+     * @param output the saturated output samples
+     */
+    void silence(int samples, short *output);
+
+    /**
+     * Compute the filter parameters derived from the registers.
+     * Must be called after any register or settings change.
+     */
+    void latch();
 
     inline int getLevel() const { return Level; }
 
-    void rebuildCutoffTables(unsigned short samplerate);
+    void rebuildCutoffTables(unsigned int samplerate);
+
+private:
+    inline int clock(int FilterInput, int NonFiltered);
+    inline int filter(int FilterInput, int NonFiltered);
+    inline void updateLevel(int Output);
+
+    static inline int saturate(int sample);
 
 private:
     unsigned char *m_regs;
@@ -51,6 +96,13 @@ private:
     int            PrevBandPass;
     int            Level;      // filtered version, good for VU-meter display
     unsigned char  VUmeterUpdateCounter;
+    bool           Settled;    // the state doesn't change with no input
+    int            HeldOutput; // the output once settled, before attenuation
+
+    // Filter parameters latched from the registers
+    int            Cutoff;     // 8580: multiplier, 6581: base value for distortion
+    int            Resonance;
+    unsigned char  VolumeBand;
 };
 
 }
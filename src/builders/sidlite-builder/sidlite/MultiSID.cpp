@@ -0,0 +1,123 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2025-2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "MultiSID.h"
+
+#include "sl_defs.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace SIDLite
+{
+
+MultiSID::MultiSID(SID* const *chips, int count) :
+    ChipCount(std::min(count, MAX_CHIPS))
+{
+    for (int k=0; k<ChipCount; k++)
+    {
+        Chips[k] = chips[k];
+        // follow the schedule of the first chip from now on
+        Chips[k]->SampleCycleCnt = Chips[0]->SampleCycleCnt;
+    }
+
+    // mono by default, plain sum
+    const int weights[MAX_CHANNELS][MAX_CHIPS] = { { 1, 1, 1, 1 }, { 1, 1, 1, 1 } };
+    setMixer(1, weights, 1, 1);
+}
+
+void MultiSID::setMixer(int channels, const int (*weights)[MAX_CHIPS], int scale, int divisor)
+{
+    Channels = std::min(channels, MAX_CHANNELS);
+    for (int k=0; k<ChipCount; k++)
+    {
+        for (int c=0; c<Channels; c++)
+            Weights[k][c] = weights[c][k];
+    }
+    Scale = scale;
+    Divisor = divisor;
+}
+
+void MultiSID::mixSilence(int samples, const short *output, const int *weights)
+{
+    for (int i=0; i<samples; i++)
+    {
+        for (int c=0; c<Channels; c++)
+            Mix[i * Channels + c] += weights[c] * output[i];
+    }
+}
+
+int MultiSID::clock(unsigned int cycles, short* buf)
+{
+    if (UNLIKELY(cycles == 0))
+        return 0;
+
+    for (int k=0; k<ChipCount; k++)
+        Chips[k]->latch();
+
+    SID &first = *Chips[0];
+
+    // follow the sampling parameters of the first chip
+    Upsampling.follow(first.upsampler);
+    const bool upsample = Upsampling.isActive();
+
+    int i = 0;
+    while (cycles > 0)
+    {
+        unsigned int tail = 0;
+        const int samples = first.schedule(cycles, tail);
+        const int length = samples * Channels;
+
+        std::fill(Mix, Mix + length, 0);
+
+        for (int k=0; k<ChipCount; k++)
+        {
+            SID &sid = *Chips[k];
+            const bool silent = sid.adsr.isSilent();
+            sid.adsr.clock(first.BlockCycles, samples, tail, sid.BlockEnvelope);
+            if (UNLIKELY(silent))
+            {
+                sid.wavgen.skip(samples);
+                sid.filter.silence(samples, sid.BlockOutput);
+                mixSilence(samples, sid.BlockOutput, Weights[k]);
+            }
+            else
+            {
+                sid.wavgen.clock(samples, sid.BlockEnvelope, sid.BlockFilterInput, sid.BlockNonFiltered);
+                sid.filter.mix(samples, sid.BlockFilterInput, sid.BlockNonFiltered, Channels, Weights[k], Mix);
+            }
+        }
+
+        short *out = buf + i * Channels;
+        short *mixed = UNLIKELY(upsample) ? Output : out;
+        for (int j=0; j<length; j++)
+        {
+            mixed[j] = static_cast<short>((static_cast<int_least64_t>(Mix[j]) * Scale) / Divisor);
+        }
+        i += UNLIKELY(upsample) ? Upsampling.process(Output, samples, Channels, out) : samples;
+    }
+
+    for (int k=1; k<ChipCount; k++)
+        Chips[k]->SampleCycleCnt = first.SampleCycleCnt;
+
+    return i;
+}
+
+}
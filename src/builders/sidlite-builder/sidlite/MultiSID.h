@@ -0,0 +1,94 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2025-2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef SIDLITE_MULTISID_H
+#define SIDLITE_MULTISID_H
+
+#include "SID.h"
+#include "Upsampler.h"
+#include "sl_constants.h"
+
+namespace SIDLite
+{
+
+/**
+ * Render several chips in lockstep.
+ *
+ * The chips share the sample schedule so each stage runs
+ * over the same block for all of them, and the filter
+ * output is mixed in the same pass without per-chip buffers.
+ */
+class MultiSID
+{
+public:
+    static constexpr int MAX_CHIPS = 4;
+    static constexpr int MAX_CHANNELS = 2;
+
+public:
+    /**
+     * @param chips the chips, they must share the sampling parameters
+     * @param count the number of chips, up to MAX_CHIPS
+     */
+    MultiSID(SID* const *chips, int count);
+
+    /**
+     * Set the mixing matrix.
+     * Each output sample is the weighted sum of the chip outputs
+     * multiplied by scale and divided by divisor.
+     *
+     * @param channels the number of interleaved output channels
+     * @param weights the weights for each channel and chip
+     * @param scale the scaling factor
+     * @param divisor the divisor
+     */
+    void setMixer(int channels, const int (*weights)[MAX_CHIPS], int scale, int divisor);
+
+    /**
+     * Render and mix a block of samples.
+     *
+     * @param cycles the number of cycles to clock
+     * @param buf the interleaved output buffer
+     * @return the number of samples generated per channel
+     */
+    int clock(unsigned int cycles, short* buf);
+
+    int channels() const { return Channels; }
+
+private:
+    void mixSilence(int samples, const short *output, const int *weights);
+
+private:
+    SID          *Chips[MAX_CHIPS];
+    int           ChipCount;
+
+    int           Channels;
+    int           Weights[MAX_CHIPS][MAX_CHANNELS];  // per chip so the filter stage reads them in a row
+    int           Scale;
+    int           Divisor;
+
+    Upsampler     Upsampling;
+
+    int           Mix[BLOCK_SAMPLES * MAX_CHANNELS];
+    short         Output[BLOCK_SAMPLES * MAX_CHANNELS];  // emulated samples before upsampling
+};
+
+}
+
+#endif // SIDLITE_MULTISID_H
@@ -36,56 +36,98 @@ namespace SIDLite
 
 int SID::clock(unsigned int cycles, short* buf)
 {
+    if (UNLIKELY(cycles == 0))
+        return 0;
+
+    latch();
+
     int i = 0;
     while (cycles > 0)
     {
-        short output;
-        if (generateSample(cycles, output))
+        // Cycle-based part of emulations:
+        unsigned int tail = 0;
+        const int samples = schedule(cycles, tail);
+
+        // the envelopes can't leave zero until a gate bit is set
+        const bool silent = adsr.isSilent();
+        adsr.clock(BlockCycles, samples, tail, BlockEnvelope);
+
+        // Samplerate-based part of emulations:
+        const bool upsample = UNLIKELY(upsampler.isActive());
+        short *out = upsample ? BlockOutput : buf + i;
+        if (UNLIKELY(silent))
         {
-            buf[i] = output;
-            i++;
+            wavgen.skip(samples);
+            filter.silence(samples, out);
         }
+        else
+        {
+            wavgen.clock(samples, BlockEnvelope, BlockFilterInput, BlockNonFiltered);
+            filter.clock(samples, BlockFilterInput, BlockNonFiltered, out);
+        }
+        i += upsample ? upsampler.process(BlockOutput, samples, 1, buf + i) : samples;
     }
     return i;
 }
 
-inline bool SID::generateSample(unsigned int &cycles, short &output)
+void SID::latch()
 {
-    // Cycle-based part of emulations:
-
-    while (SampleCycleCnt <= s.SampleClockRatio)
+    // registers can't change during the block,
+    // latch the derived parameters once
+    if (UNLIKELY(RegsChanged))
     {
-        // no more cycles, can't produce output
-        if (cycles == 0)
-            return false;
-
-        unsigned char InstructionCycles = std::min(7u, cycles);
-        SampleCycleCnt += InstructionCycles << 4;
-        cycles -= InstructionCycles;
-
-        adsr.clock(InstructionCycles);
+        wavgen.latch();
+        filter.latch();
+        RegsChanged = false;
     }
+}
 
-    SampleCycleCnt -= s.SampleClockRatio;
-
-    // Samplerate-based part of emulations:
-
-    wg_output_t wg_out = wavgen.clock(&adsr);
-    int sample = filter.clock(wg_out.first, wg_out.second);
-
-    // saturation logic on overflow
-    if (sample > INT16_MAX)
-        sample = INT16_MAX;
-    else if (sample < INT16_MIN)
-        sample = INT16_MIN;
-    output = static_cast<short>(sample);
+int SID::schedule(unsigned int &cycles, unsigned int &tail)
+{
+    // Cycles are consumed in chunks of up to 7, as for
+    // the longest instructions, until the next sample is due
+    constexpr unsigned int CHUNK_CYCLES = 7;
+    constexpr unsigned int CHUNK_FRACTIONS = CHUNK_CYCLES << CRSID_CLOCK_FRACTIONAL_BITS;
+
+    const unsigned int SampleClockRatio = s.SampleClockRatio;
+    // after a sample the counter never exceeds a chunk
+    // so the number of chunks to the next one is known in advance
+    const unsigned int ChunksPerSample = SampleClockRatio / CHUNK_FRACTIONS;
+    const unsigned int ChunksRemainder = SampleClockRatio % CHUNK_FRACTIONS;
+
+    unsigned int Counter = SampleCycleCnt;
+    int samples = 0;
+    while ((cycles > 0) && (samples < BLOCK_SAMPLES))
+    {
+        unsigned int InstructionCycles = 0;
+        if (Counter <= SampleClockRatio)
+        {
+            const unsigned int chunks = LIKELY(Counter <= CHUNK_FRACTIONS)
+                ? ChunksPerSample + (Counter <= ChunksRemainder ? 1 : 0)
+                : (SampleClockRatio - Counter) / CHUNK_FRACTIONS + 1;
+            InstructionCycles = std::min(chunks * CHUNK_CYCLES, cycles);
+            Counter += InstructionCycles << CRSID_CLOCK_FRACTIONAL_BITS;
+            cycles -= InstructionCycles;
+
+            // no more cycles, can't produce output
+            if (Counter <= SampleClockRatio)
+            {
+                tail = InstructionCycles;
+                break;
+            }
+        }
 
-    return true;
+        Counter -= SampleClockRatio;
+        BlockCycles[samples++] = InstructionCycles;
+    }
+    SampleCycleCnt = Counter;
+    return samples;
 }
 
 void SID::write(int addr, int value)
 {
     regs[addr] = value;
+    RegsChanged = true;
 }
 
 int SID::read(int addr) const
@@ -113,6 +155,8 @@ SID::SID() :
 void SID::reset()
 {
     SampleCycleCnt = 0;
+    RegsChanged = true;
+    upsampler.reset();
 
     std::fill(std::begin(regs), std::end(regs), 0);
 
@@ -121,26 +165,32 @@ void SID::reset()
     wavgen.reset();
 }
 
-bool SID::setSamplingParameters(unsigned int clockFrequency, unsigned short samplingFrequency)
+bool SID::setSamplingParameters(unsigned int clockFrequency, unsigned int samplingFrequency)
 {
-    if ((samplingFrequency < 8000) || (samplingFrequency > 48000))
+    if ((samplingFrequency < 8000) || (samplingFrequency > 192000))
         return false;
 
-    filter.rebuildCutoffTables(samplingFrequency);
+    // higher rates are emulated at the capped rate and interpolated
+    const unsigned int emulatedFrequency = upsampler.setRate(samplingFrequency);
+
+    filter.rebuildCutoffTables(emulatedFrequency);
 
     // shifting (multiplication) enhances SampleClockRatio precision
-    s.SampleClockRatio = (clockFrequency << CRSID_CLOCK_FRACTIONAL_BITS) / samplingFrequency;
+    s.SampleClockRatio = (clockFrequency << CRSID_CLOCK_FRACTIONAL_BITS) / emulatedFrequency;
+    RegsChanged = true;
     return true;
 }
 
 void SID::setChipModel(model_t model)
 {
     s.sid8580 = model == model_t::MOS8580;
+    RegsChanged = true;
 }
 
 void SID::setRealSIDmode(bool mode)
 {
     s.RealSIDmode = mode;
+    RegsChanged = true;
 }
 
 }
@@ -26,6 +26,8 @@
 #include "ADSR.h"
 #include "Filter.h"
 #include "WavGen.h"
+#include "Upsampler.h"
+#include "sl_constants.h"
 #include "sl_settings.h"
 
 #include <array>
@@ -35,6 +37,8 @@ namespace SIDLite
 
 class SID
 {
+    friend class MultiSID;
+
 public:
     enum class model_t
     {
@@ -47,11 +51,21 @@ public:
     void reset();
     void write(int addr, int value);
     int read(int addr) const;
+
+    /**
+     * Render a block of samples.
+     * The registers are constant during the block
+     * so the derived parameters are computed only once.
+     *
+     * @param cycles the number of cycles to clock
+     * @param buf the output buffer
+     * @return the number of samples generated
+     */
     int clock(unsigned int cycles, short* buf);
 
     void setChipModel(model_t model);
     void setRealSIDmode(bool mode);
-    bool setSamplingParameters(unsigned int clockFrequency, unsigned short samplingFrequency);
+    bool setSamplingParameters(unsigned int clockFrequency, unsigned int samplingFrequency);
 
     int getLevel() const { return filter.getLevel(); }
 
@@ -62,11 +76,34 @@ private:
     Filter            filter;
     WavGen            wavgen;
     settings          s;
+    Upsampler         upsampler;
 
     short             SampleCycleCnt;
 
+    bool              RegsChanged;    // derived parameters must be latched again
+
+    // Block buffers
+    unsigned int      BlockCycles[BLOCK_SAMPLES];     // cycles elapsed before each sample
+    unsigned char     BlockEnvelope[SID_CHANNEL_COUNT][BLOCK_SAMPLES];
+    int               BlockFilterInput[BLOCK_SAMPLES];
+    int               BlockNonFiltered[BLOCK_SAMPLES];
+    short             BlockOutput[BLOCK_SAMPLES];     // emulated samples before upsampling
+
 private:
-    inline bool generateSample(unsigned int &cycles, short &output);
+    /**
+     * Latch the derived parameters if the registers changed.
+     */
+    void latch();
+
+    /**
+     * Consume cycles until a block of samples is due
+     * or the cycles are exhausted.
+     *
+     * @param cycles the available cycles, updated
+     * @param tail the cycles consumed after the last sample
+     * @return the number of samples in the block
+     */
+    int schedule(unsigned int &cycles, unsigned int &tail);
 };
 
 }
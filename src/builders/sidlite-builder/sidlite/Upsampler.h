@@ -0,0 +1,141 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2025-2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef SIDLITE_UPSAMPLER_H
+#define SIDLITE_UPSAMPLER_H
+
+#include <algorithm>
+#include <cstdint>
+
+namespace SIDLite
+{
+
+/**
+ * Linear interpolation for the sampling rates above
+ * the emulated one, which is capped at MAX_EMULATED_RATE.
+ * The emulation cost stays the same and the rate only
+ * affects this simple loop.
+ *
+ * The output samples are placed at the exact ratio of
+ * the two rates, so any rate above the cap is emulated
+ * at the cap itself.
+ */
+class Upsampler
+{
+public:
+    static constexpr unsigned int MAX_EMULATED_RATE = 48000;
+    static constexpr int MAX_CHANNELS = 2;
+
+public:
+    /**
+     * Set the interpolation ratio for the requested rate.
+     *
+     * @param samplingFrequency the output sampling frequency
+     * @return the emulated sampling frequency
+     */
+    unsigned int setRate(unsigned int samplingFrequency)
+    {
+        const unsigned int emulated = std::min(samplingFrequency, MAX_EMULATED_RATE);
+
+        // reduce the ratio to keep the products small
+        unsigned int a = samplingFrequency;
+        unsigned int b = emulated;
+        while (b != 0)
+        {
+            const unsigned int t = a % b;
+            a = b;
+            b = t;
+        }
+        OutputStep = samplingFrequency / a;
+        InputStep = emulated / a;
+        reset();
+        return emulated;
+    }
+
+    /**
+     * Whether the output rate is above the emulated one.
+     */
+    bool isActive() const { return InputStep < OutputStep; }
+
+    /**
+     * Use the same ratio of another upsampler.
+     */
+    void follow(const Upsampler &other)
+    {
+        if ((InputStep != other.InputStep) || (OutputStep != other.OutputStep))
+        {
+            InputStep = other.InputStep;
+            OutputStep = other.OutputStep;
+            reset();
+        }
+    }
+
+    void reset()
+    {
+        // the first output falls one output period after the previous input
+        Phase = InputStep;
+        for (int c=0; c<MAX_CHANNELS; c++)
+            Prev[c] = 0;
+    }
+
+    /**
+     * Expand a block of interleaved samples.
+     *
+     * @param input the emulated samples
+     * @param samples the number of samples per channel
+     * @param channels the number of channels
+     * @param output the interpolated samples
+     * @return the number of output samples per channel
+     */
+    int process(const short *input, int samples, int channels, short *output)
+    {
+        int n = 0;
+        for (int i=0; i<samples; i++)
+        {
+            const short *cur = input + i * channels;
+
+            // Phase is the position of the next output sample
+            // past the previous input, in 1/OutputStep units
+            for (; Phase <= OutputStep; Phase += InputStep, n++)
+            {
+                for (int c=0; c<channels; c++)
+                {
+                    const int_least64_t delta = cur[c] - Prev[c];
+                    output[n * channels + c] = static_cast<short>(Prev[c] + (delta * Phase) / OutputStep);
+                }
+            }
+            Phase -= OutputStep;
+
+            for (int c=0; c<channels; c++)
+                Prev[c] = cur[c];
+        }
+        return n;
+    }
+
+private:
+    unsigned int InputStep = 1;
+    unsigned int OutputStep = 1;
+    unsigned int Phase = 1;
+    short Prev[MAX_CHANNELS] = {0};
+};
+
+}
+
+#endif // SIDLITE_UPSAMPLER_H
@@ -22,12 +22,13 @@
 
 #include "WavGen.h"
 
-#include "ADSR.h"
 #include "sl_defs.h"
 #include "sl_constants.h"
 #include "sl_settings.h"
 #include "cw_tables.h"
 
+#include <array>
+
 namespace SIDLite
 {
 
@@ -145,236 +146,408 @@ constexpr unsigned int NOISE_MASK =
     |    0x01
 );
 
-wg_output_t WavGen::clock(const ADSR *adsr)
+// linear envelope DAC for the 8580
+static const auto ADSR_DAC_8580 = []()
 {
-    // Waveform-generator (phase accumulator and waveform-selector)
+    std::array<unsigned char, 256> dac {};
+    for (int i=0; i<256; i++)
+        dac[i] = i;
+    return dac;
+}();
 
-    unsigned int WavGenOut = 0;
-    unsigned char EnvOut = 0;
-    int FilterInput = 0;
-    int NonFiltered = 0;
+void WavGen::latch()
+{
     const unsigned char FilterSwitchReso = m_regs[0x17];
     const unsigned char VolumeBand = m_regs[0x18];
 
+    SyncVoices = 0;
+
     for (int Channel=0, ChBase=0; Channel<SID_CHANNEL_COUNT; Channel++, ChBase+=7)
     {
-        unsigned char *ChannelPtr = &(m_regs[ChBase]);
+        const unsigned char *ChannelPtr = &(m_regs[ChBase]);
+        const unsigned char WF = ChannelPtr[4];
+
+        const unsigned int Step = ((ChannelPtr[1]<<8) | ChannelPtr[0]) * m_settings->getSampleClockRatio();
+        PhaseAccuStep[Channel] = Step;
+        PhaseAccuMask[Channel] = (WF & TEST_BITVAL) ? 0 : PHASEACCU_ANDMASK;
+        if (WF & SYNC_BITVAL)
+            SyncVoices |= 1 << Channel;
+
+        // routing the channel signal to either the filter or the unfiltered master output
+        // depending on filter-switch SID-registers
+        const bool Filtered = FilterSwitchReso & (1 << Channel);
+        FilterMask[Channel] = Filtered ? ~0 : 0;
+        DirectMask[Channel] = (!Filtered && (Channel!=2 || !(VolumeBand & OFF3_BITVAL))) ? ~0 : 0;
+
+        // simple pulse
+        unsigned int PW = getPW(ChannelPtr); // PW=0000..FFF0 from SID-register
+        unsigned int Utmp = (int)(Step >> (CRSID_WAVE_SHIFTS+1));
+        // Too thin pulsewidth? Correct...
+        if (UNLIKELY(0 < PW && PW < Utmp))
+            PW = Utmp;
+        Utmp ^= CRSID_WAVE_MAX;
+        // Too thin pulsewidth? Correct it to a value representable at the current samplerate
+        if (UNLIKELY(PW > Utmp))
+            PW = Utmp;
+        PulseWidth[Channel] = PW;
 
-        auto combinedWF = [&](const cw_array_t &WFarray, unsigned short oscval)
+        // rising/falling-edge steepness (add/sub at samples)
+        int Steepness = (Step>=STEEPNESS_STEPLIMIT) ? PHASEACCU_MAX/Step : CRSID_WAVE_MAX;
+        PulseSteepness[Channel] = Steepness;
+
+        // very thin pulses don't make a full swing between 0 and max but make a little spike
+        // but adequately thick trapezoid pulses reach the maximum level
+        int PulsePeak = (CRSID_WAVE_MAX-PW) * Steepness;
+        if (PulsePeak > CRSID_WAVE_MAX)
+            PulsePeak = CRSID_WAVE_MAX;
+        PulseRisingPeak[Channel] = PulsePeak;
+
+        PulsePeak = PW * Steepness;
+        if (PulsePeak > CRSID_WAVE_MAX)
+            PulsePeak = CRSID_WAVE_MAX;
+        PulseFallingPeak[Channel] = PulsePeak;
+
+        // saw
+        Steepness = (Step>>CRSID_CLOCK_FRACTIONAL_BITS) / 288;
+        // avoid division by zero in next steps
+        if (UNLIKELY(Steepness == 0))
+            Steepness = 1;
+        SawSteepness[Channel] = Steepness;
+
+        // combined waveforms
+        CombinedPW[Channel] = getCombinedPW(ChannelPtr);
+        unsigned char Pitch = (LIKELY(ChannelPtr[1])) ? ChannelPtr[1] : 1; // avoid division by zero
+        CombinedFilt[Channel] = 0x7777 + (0x8888/Pitch);
+    }
+}
+
+void WavGen::clockPhaseAccu(int samples)
+{
+    // stepping phase-accumulators (oscillators),
+    // the voices are independent so each one is stepped
+    // for the whole block at once, test-bit keeps it reset
+    for (int Channel=0; Channel<SID_CHANNEL_COUNT; Channel++)
+    {
+        const unsigned int Start = PhaseAccu[Channel];
+        const unsigned int Step = PhaseAccuStep[Channel];
+        const int Mask = PhaseAccuMask[Channel];
+        int *Accu = BlockPhaseAccu[Channel];
+        for (int i=0; i<samples; i++)
+            Accu[i] = (Start + (i+1) * Step) & Mask;
+    }
+
+    const int Prev = samples > 1 ? BlockPhaseAccu[2][samples-2] : PhaseAccu[2];
+    SyncSourceMSBrise = (BlockPhaseAccu[2][samples-1] & PHASEACCU_MSB_BITVAL) > (Prev & PHASEACCU_MSB_BITVAL);
+}
+
+void WavGen::clockSyncedPhaseAccu(int samples)
+{
+    // hard sync chains the voices, resolve them in order
+    int Accu[3] = { PhaseAccu[0], PhaseAccu[1], PhaseAccu[2] };
+    unsigned char MSBrise = SyncSourceMSBrise;
+    for (int i=0; i<samples; i++)
+    {
+        for (int Channel=0; Channel<SID_CHANNEL_COUNT; Channel++)
         {
-            constexpr int COMBINEDWF_FILT_RESOLUTION = 16; // bits
-            constexpr int COMBINEDWF_WAVE_RESOLUTION = 8; // bits
-            constexpr int COMBINEDWF_OSC_MSB_OFF_MASK = (1 << (COMBINEDWF_SAMPLE_RESOLUTION - 1)) - 1; // 0x7FF
-            constexpr int COMBINEDWF_FILTMUL_MAX = (1 << COMBINEDWF_FILT_RESOLUTION) - 1; // 0xFFF
-            constexpr int COMBINEDWF_FILT_FRACTION_SHIFTS = 16;
-            constexpr int COMBINEDWF_WAVE_SHIFTS = CRSID_WAVE_RESOLUTION - COMBINEDWF_WAVE_RESOLUTION; // 8
-
-            if (UNLIKELY(!m_settings->is8580() && WFarray!=PulseTriangle))
-                oscval &= COMBINEDWF_OSC_MSB_OFF_MASK;
-            unsigned char Pitch = (LIKELY(ChannelPtr[1])) ? ChannelPtr[1] : 1; // avoid division by zero
-            unsigned short Filt = 0x7777 + (0x8888/Pitch);
-            PrevWavData[Channel] = (WFarray[oscval]*Filt + PrevWavData[Channel]*(COMBINEDWF_FILTMUL_MAX-Filt)) >> COMBINEDWF_FILT_FRACTION_SHIFTS;
-            return PrevWavData[Channel] << COMBINEDWF_WAVE_SHIFTS;
-        };
+            const int Prev = Accu[Channel];
+            if ((SyncVoices & (1 << Channel)) && MSBrise)
+                Accu[Channel] = 0;
+            else
+                Accu[Channel] = (Prev + PhaseAccuStep[Channel]) & PhaseAccuMask[Channel];
+            MSBrise = (Accu[Channel] & PHASEACCU_MSB_BITVAL) > (Prev & PHASEACCU_MSB_BITVAL);
+            BlockPhaseAccu[Channel][i] = Accu[Channel];
+        }
+    }
+    SyncSourceMSBrise = MSBrise;
+}
 
-        const unsigned char WF = ChannelPtr[4];
-        const unsigned char TestBit = (UNLIKELY((WF & TEST_BITVAL) != 0));
-        int *PhaseAccuPtr = &(PhaseAccu[Channel]);
+// With lastOnly set the stateless waveforms compute only the last sample
+void WavGen::clockWaveform(int Channel, int samples, bool lastOnly)
+{
+    const unsigned char *ChannelPtr = &(m_regs[Channel*7]);
+    const unsigned char WF = ChannelPtr[4];
+    const unsigned char TestBit = (UNLIKELY((WF & TEST_BITVAL) != 0));
+    const unsigned int PhaseAccuStepVal = PhaseAccuStep[Channel];
+    const int *Accu = BlockPhaseAccu[Channel];
+    int *Out = BlockWavGenOut[Channel];
+    const int First = UNLIKELY(lastOnly) ? samples-1 : 0;
+
+    // ring modulation source is the previous voice
+    auto ringSource = [&](int i) -> unsigned int
+    {
+        if (Channel)
+            return BlockPhaseAccu[Channel-1][i] & PHASEACCU_MSB_BITVAL;
+        return i ? (BlockPhaseAccu[2][i-1] & PHASEACCU_MSB_BITVAL) : RingSourceMSB;
+    };
+
+    auto combinedWF = [&](const cw_array_t &WFarray, auto oscval)
+    {
+        constexpr int COMBINEDWF_FILT_RESOLUTION = 16; // bits
+        constexpr int COMBINEDWF_WAVE_RESOLUTION = 8; // bits
+        constexpr int COMBINEDWF_OSC_MSB_OFF_MASK = (1 << (COMBINEDWF_SAMPLE_RESOLUTION - 1)) - 1; // 0x7FF
+        constexpr int COMBINEDWF_FILTMUL_MAX = (1 << COMBINEDWF_FILT_RESOLUTION) - 1; // 0xFFF
+        constexpr int COMBINEDWF_FILT_FRACTION_SHIFTS = 16;
+        constexpr int COMBINEDWF_WAVE_SHIFTS = CRSID_WAVE_RESOLUTION - COMBINEDWF_WAVE_RESOLUTION; // 8
 
-        const unsigned int PhaseAccuStep = ((ChannelPtr[1]<<8) | ChannelPtr[0]) * m_settings->getSampleClockRatio();
-        if (UNLIKELY(TestBit || ((WF & SYNC_BITVAL) && SyncSourceMSBrise)))
-            *PhaseAccuPtr = 0;
-        else
+        const bool MSBoff = !m_settings->is8580() && WFarray!=PulseTriangle;
+        const unsigned short Filt = CombinedFilt[Channel];
+        unsigned char WavData = PrevWavData[Channel];
+        for (int i=0; i<samples; i++)
         {
-            // stepping phase-accumulator (oscillator)
-            *PhaseAccuPtr += PhaseAccuStep;
-            if (UNLIKELY(*PhaseAccuPtr >= PHASEACCU_RANGE))
-                *PhaseAccuPtr -= PHASEACCU_RANGE; // 0x10000000
+            int Value = oscval(i);
+            if (Value >= 0)
+            {
+                if (UNLIKELY(MSBoff))
+                    Value &= COMBINEDWF_OSC_MSB_OFF_MASK;
+                WavData = (WFarray[Value]*Filt + WavData*(COMBINEDWF_FILTMUL_MAX-Filt)) >> COMBINEDWF_FILT_FRACTION_SHIFTS;
+                Out[i] = WavData << COMBINEDWF_WAVE_SHIFTS;
+            }
+            else
+                Out[i] = CRSID_WAVE_MIN; // 0
         }
-        *PhaseAccuPtr &= PHASEACCU_ANDMASK; // 0xFFFFFFF
-        const unsigned int MSB = *PhaseAccuPtr & PHASEACCU_MSB_BITVAL; // 0x8000000
-        SyncSourceMSBrise = (UNLIKELY(MSB > (PrevPhaseAccu[Channel] & PHASEACCU_MSB_BITVAL))) ? 1 : 0;
+        PrevWavData[Channel] = WavData;
+    };
 
-        // switch-case encourages computed-goto compiler-optimization
-        switch (WF & 0xF0)
+    // one loop per waveform, the waveform can't change during the block
+    switch (WF & 0xF0)
+    {
+        case NOISE_BITVAL:
         {
-            case NOISE_BITVAL:
+            //noise waveform
+            unsigned int Tmp = NoiseLFSR[Channel];
+            int PrevAccu = PhaseAccu[Channel];
+            // clock LFSR all time if clockrate exceeds observable at given samplerate (last term):
+            const bool ClockAlways = PhaseAccuStepVal >= NOISE_CLOCK;
+            for (int i=0; i<samples; i++)
             {
-                //noise waveform
-                int Tmp = NoiseLFSR[Channel];
-                // clock LFSR all time if clockrate exceeds observable at given samplerate (last term):
-                if (UNLIKELY(
-                    ((*PhaseAccuPtr & NOISE_CLOCK) != (PrevPhaseAccu[Channel] & NOISE_CLOCK))
-                    || (PhaseAccuStep >= NOISE_CLOCK)))
+                if (UNLIKELY(((Accu[i] ^ PrevAccu) & NOISE_CLOCK) || ClockAlways))
                 {
-                    int Feedback = ((Tmp & 0x400000) ^ ((Tmp & 0x20000) << 5)) != 0;
+                    unsigned int Feedback = ((Tmp & 0x400000) ^ ((Tmp & 0x20000) << 5)) != 0;
                     // TEST-bit turns all bits in noise LFSR to 1
                     // (on real SID slowly, in approx. 8000 microseconds ~ 300 samples)
                     Tmp = ((Tmp << 1) | Feedback|TestBit) & 0x7FFFFF;
-                    NoiseLFSR[Channel] = Tmp;
                 }
-                WavGenOut = getNoise(Tmp);
-            } break;
-            case PULSE_BITVAL:
+                Out[i] = getNoise(Tmp);
+                PrevAccu = Accu[i];
+            }
+            NoiseLFSR[Channel] = Tmp;
+        } break;
+        case PULSE_BITVAL:
+        {
+            //simple pulse
+            if (UNLIKELY(TestBit))
+            {
+                for (int i=First; i<samples; i++)
+                    Out[i] = CRSID_WAVE_MAX; // 0xFFFF;
+                break;
+            }
+            const unsigned int PW = PulseWidth[Channel];
+            const int Steepness = PulseSteepness[Channel];
+            const int RisingPeak = PulseRisingPeak[Channel];
+            const int FallingPeak = PulseFallingPeak[Channel];
+            for (int i=First; i<samples; i++)
             {
-                //simple pulse
-                unsigned int PW = getPW(ChannelPtr); // PW=0000..FFF0 from SID-register
-                unsigned int Utmp = (int)(PhaseAccuStep >> (CRSID_WAVE_SHIFTS+1));
-                // Too thin pulsewidth? Correct...
-                if (UNLIKELY(0 < PW && PW < Utmp))
-                    PW = Utmp;
-                Utmp ^= CRSID_WAVE_MAX;
-                // Too thin pulsewidth? Correct it to a value representable at the current samplerate
-                if (UNLIKELY(PW > Utmp))
-                    PW = Utmp;
-                Utmp = *PhaseAccuPtr >> CRSID_WAVE_SHIFTS; // 12
-
-                // rising/falling-edge steepness (add/sub at samples)
-                int Steepness = (PhaseAccuStep>=STEEPNESS_STEPLIMIT) ? PHASEACCU_MAX/PhaseAccuStep : CRSID_WAVE_MAX;
-                if (UNLIKELY(TestBit))
-                    WavGenOut = CRSID_WAVE_MAX; // 0xFFFF;
-                else if (Utmp<PW)
+                const unsigned int Utmp = Accu[i] >> CRSID_WAVE_SHIFTS; // 12
+                if (Utmp<PW)
                 {
                     // rising edge (interpolation)
-                    int PulsePeak = (CRSID_WAVE_MAX-PW) * Steepness;
-                    // very thin pulses don't make a full swing between 0 and max but make a little spike
-                    if (PulsePeak > CRSID_WAVE_MAX)
-                        PulsePeak = CRSID_WAVE_MAX;
-                    // but adequately thick trapezoid pulses reach the maximum level
-                    int Tmp = PulsePeak - (PW-Utmp) * Steepness; // draw the slope from the peak
-                    WavGenOut = (LIKELY(Tmp<CRSID_WAVE_MIN)) ? CRSID_WAVE_MIN : Tmp; // but stop at 0-level
+                    int Tmp = RisingPeak - (PW-Utmp) * Steepness; // draw the slope from the peak
+                    Out[i] = ((LIKELY(Tmp<CRSID_WAVE_MIN)) ? CRSID_WAVE_MIN : Tmp) & CRSID_WAVE_MASK; // but stop at 0-level
                 }
                 else
                 {
                     // falling edge (interpolation)
-                    int PulsePeak = PW * Steepness;
-                    // very thin pulses don't make a full swing between 0 and max but make a little spike
-                    if (PulsePeak > CRSID_WAVE_MAX)
-                        PulsePeak = CRSID_WAVE_MAX;
-                    // adequately thick trapezoid pulses reach the maximum level
-                    int Tmp = (CRSID_WAVE_MAX-Utmp) * Steepness - PulsePeak; // draw the slope from the peak
-                    WavGenOut = (LIKELY(Tmp>=0)) ? CRSID_WAVE_MAX : Tmp;   // but stop at max-level
+                    int Tmp = (CRSID_WAVE_MAX-Utmp) * Steepness - FallingPeak; // draw the slope from the peak
+                    Out[i] = ((LIKELY(Tmp>=0)) ? CRSID_WAVE_MAX : Tmp) & CRSID_WAVE_MASK; // but stop at max-level
                 }
-            } break;
-            case PULSAWTRI_VAL:
+            }
+        } break;
+        case PULSAWTRI_VAL:
+        {
+            // pulse+saw+triangle (waveform nearly identical to tri+saw)
+            const unsigned int PW = CombinedPW[Channel];
+            combinedWF(PulseSawTriangle, [&](int i) -> int
             {
-                // pulse+saw+triangle (waveform nearly identical to tri+saw)
-                unsigned int Utmp = *PhaseAccuPtr >> COMBINEDWF_SAMPLE_SHIFTS; // 16
-                WavGenOut = Utmp >= getCombinedPW(ChannelPtr) || UNLIKELY(TestBit)
-                    ? combinedWF(PulseSawTriangle, Utmp) : CRSID_WAVE_MIN; // 0
-            } break;
-            case PULSAW_VAL:
+                const unsigned int Utmp = Accu[i] >> COMBINEDWF_SAMPLE_SHIFTS; // 16
+                return Utmp >= PW || UNLIKELY(TestBit) ? Utmp : -1;
+            });
+        } break;
+        case PULSAW_VAL:
+        {
+            // pulse+saw
+            const unsigned int PW = CombinedPW[Channel];
+            combinedWF(PulseSawtooth, [&](int i) -> int
             {
-                // pulse+saw
-                unsigned int Utmp = *PhaseAccuPtr >> COMBINEDWF_SAMPLE_SHIFTS; // 16
-                WavGenOut = Utmp >= getCombinedPW(ChannelPtr) //|| UNLIKELY(TestBit)
-                    ? combinedWF(PulseSawtooth, Utmp) : CRSID_WAVE_MIN; // 0
-            } break;
-            case PULTRI_VAL:
+                const unsigned int Utmp = Accu[i] >> COMBINEDWF_SAMPLE_SHIFTS; // 16
+                return Utmp >= PW /*|| UNLIKELY(TestBit)*/ ? Utmp : -1;
+            });
+        } break;
+        case PULTRI_VAL:
+        {
+            // pulse+triangle
+            const unsigned int PW = CombinedPW[Channel];
+            const bool Ring = WF & RING_BITVAL;
+            combinedWF(PulseTriangle, [&](int i) -> int
             {
-                // pulse+triangle
-                int Tmp = *PhaseAccuPtr ^ ((WF&RING_BITVAL)? RingSourceMSB : 0);
-                WavGenOut = (*PhaseAccuPtr >> COMBINEDWF_SAMPLE_SHIFTS) >= getCombinedPW(ChannelPtr) || UNLIKELY(TestBit)
-                    ? combinedWF(PulseTriangle, Tmp >> COMBINEDWF_SAMPLE_SHIFTS) : CRSID_WAVE_MIN; // 0
-            } break;
-            case SAWTRI_VAL:
+                int Tmp = Accu[i] ^ (Ring ? ringSource(i) : 0);
+                return static_cast<unsigned int>(Accu[i] >> COMBINEDWF_SAMPLE_SHIFTS) >= PW || UNLIKELY(TestBit)
+                    ? (Tmp >> COMBINEDWF_SAMPLE_SHIFTS) : -1;
+            });
+        } break;
+        case SAWTRI_VAL:
+        {
+            // saw+triangle
+            combinedWF(SawTriangle, [&](int i) -> int
             {
-                // saw+triangle
-                WavGenOut = combinedWF(SawTriangle, *PhaseAccuPtr >> COMBINEDWF_SAMPLE_SHIFTS);
-            } break;
-            case SAW_BITVAL:
+                return Accu[i] >> COMBINEDWF_SAMPLE_SHIFTS;
+            });
+        } break;
+        case SAW_BITVAL:
+        {
+            // sawtooth
+            const int Steepness = SawSteepness[Channel];
+            for (int i=First; i<samples; i++)
             {
-                // sawtooth
-                WavGenOut = *PhaseAccuPtr >> CRSID_WAVE_SHIFTS; // 12
                 // saw (this row would be enough for simple but aliased-at-high-pitch saw)
-                int Steepness = (PhaseAccuStep>>CRSID_CLOCK_FRACTIONAL_BITS) / 288;
-                // avoid division by zero in next steps
-                if (UNLIKELY(Steepness == 0))
-                    Steepness = 1;
+                unsigned int Tmp = Accu[i] >> CRSID_WAVE_SHIFTS; // 12
                 // 1st half (rising edge) of asymmetric triangle-like saw waveform
-                WavGenOut += (WavGenOut * Steepness) >> STEEPNESS_FRACTION_SHIFTS; // 16
+                Tmp += (Tmp * Steepness) >> STEEPNESS_FRACTION_SHIFTS; // 16
                 // 2nd half (falling edge, reciprocal steepness
-                if (UNLIKELY(WavGenOut > CRSID_WAVE_MAX))
-                    WavGenOut = CRSID_WAVE_MAX - (((WavGenOut-CRSID_WAVE_RANGE) << STEEPNESS_FRACTION_SHIFTS) / Steepness);
-            } break;
-            case TRI_BITVAL:
+                if (UNLIKELY(Tmp > CRSID_WAVE_MAX))
+                    Tmp = CRSID_WAVE_MAX - (((Tmp-CRSID_WAVE_RANGE) << STEEPNESS_FRACTION_SHIFTS) / Steepness);
+                Out[i] = Tmp & CRSID_WAVE_MASK;
+            }
+        } break;
+        case TRI_BITVAL:
+        {
+            // triangle (this waveform has no harsh edges, so it doesn't suffer from strong aliasing at high pitches)
+            const bool RealSIDmode = m_settings->getRealSIDmode();
+            const unsigned int Ring = WF & RING_BITVAL;
+            unsigned int Prev = PrevWavGenOut[Channel];
+            // the SounDemon hack holds the previous sample, then each one must be computed
+            const int Start = (!RealSIDmode || (PrevSounDemonDigiWF[Channel] <= 0)) ? First : 0;
+            for (int i=Start; i<samples; i++)
             {
-                // triangle (this waveform has no harsh edges, so it doesn't suffer from strong aliasing at high pitches)
-                if (LIKELY(!m_settings->getRealSIDmode() || (PrevSounDemonDigiWF[Channel] <= 0)))
+                if (LIKELY(!RealSIDmode || (PrevSounDemonDigiWF[Channel] <= 0)))
                 {
-                    int Tmp = *PhaseAccuPtr ^ (UNLIKELY(WF&RING_BITVAL) ? RingSourceMSB : 0);
-                    WavGenOut = (Tmp ^ ((Tmp&PHASEACCU_MSB_BITVAL) ? PHASEACCU_MAX : 0)) >> (CRSID_WAVE_SHIFTS-1); // 11
+                    int Tmp = Accu[i] ^ (UNLIKELY(Ring) ? ringSource(i) : 0);
+                    Prev = ((Tmp ^ ((Tmp&PHASEACCU_MSB_BITVAL) ? PHASEACCU_MAX : 0)) >> (CRSID_WAVE_SHIFTS-1)) & CRSID_WAVE_MASK; // 11
                 }
                 else
                 {
                     // SounDemon digi hack: if previous waveform was 01 don't modify output in this round,
                     // so carrier noise won't be heard due to non 1MHz emulation
-                    WavGenOut = PrevWavGenOut[Channel];
                     --PrevSounDemonDigiWF[Channel];
                 }
-            } break;
-            case 0x00:
-                // emulate waveform 00 floating wave-DAC (utilized by SounDemon digis)
-                // (on real SID waveform00 decays after about 5 seconds,
-                // here we just simply keep the value to avoid clicks)
-                // (Our jittery 'seeking' waveform=$01 part of SounDemon-digi
-                // is substituted directly by frequency-high register's value (as in SwinSID))
-                if (m_settings->getRealSIDmode() && WF == SOUNDEMON_DIGI_SEEK_WAVEFORM)
-                {
-                    WavGenOut = ChannelPtr[1] << SOUNDEMON_DIGI_SHIFTS;
-                    PrevSounDemonDigiWF[Channel] = SOUNDEMON_CARRIER_ELIMINATION_SAMPLECOUNT;
-                }
-                else
-                    WavGenOut = PrevWavGenOut[Channel];
-            break;
-            default:
+                Out[i] = Prev;
+            }
+        } break;
+        case 0x00:
+        {
+            // emulate waveform 00 floating wave-DAC (utilized by SounDemon digis)
+            // (on real SID waveform00 decays after about 5 seconds,
+            // here we just simply keep the value to avoid clicks)
+            // (Our jittery 'seeking' waveform=$01 part of SounDemon-digi
+            // is substituted directly by frequency-high register's value (as in SwinSID))
+            int Value = PrevWavGenOut[Channel];
+            if (m_settings->getRealSIDmode() && WF == SOUNDEMON_DIGI_SEEK_WAVEFORM)
             {
-                // we simply zero output when other waveform is mixed with noise.
-                // LFSR continuously gets filled by zero and locks up.
-                // ($C1 waveform with pw<8 can keep it for a while.)
-                WavGenOut = CRSID_WAVE_MIN;
-                bool shift =
-                    ((*PhaseAccuPtr & NOISE_CLOCK) != (PrevPhaseAccu[Channel] & NOISE_CLOCK))
-                    || (PhaseAccuStep >= NOISE_CLOCK);
+                Value = ChannelPtr[1] << SOUNDEMON_DIGI_SHIFTS;
+                PrevSounDemonDigiWF[Channel] = SOUNDEMON_CARRIER_ELIMINATION_SAMPLECOUNT;
+            }
+            for (int i=First; i<samples; i++)
+                Out[i] = Value;
+        } break;
+        default:
+        {
+            // we simply zero output when other waveform is mixed with noise.
+            // LFSR continuously gets filled by zero and locks up.
+            // ($C1 waveform with pw<8 can keep it for a while.)
+            unsigned int Tmp = NoiseLFSR[Channel];
+            int PrevAccu = PhaseAccu[Channel];
+            const bool ClockAlways = PhaseAccuStepVal >= NOISE_CLOCK;
+            for (int i=0; i<samples; i++)
+            {
+                bool shift = ((Accu[i] ^ PrevAccu) & NOISE_CLOCK) || ClockAlways;
                 if (!shift && !TestBit)
                 {
                     // noise writeback
-                    NoiseLFSR[Channel] &= ~NOISE_MASK;
+                    Tmp &= ~NOISE_MASK;
                 }
                 else
                 {
-                    int Tmp = NoiseLFSR[Channel];
                     Tmp = ((Tmp << 1) | TestBit) & 0x7FFFFF;
-                    NoiseLFSR[Channel] = Tmp;
                 }
-            } break;
-        }
+                Out[i] = CRSID_WAVE_MIN;
+                PrevAccu = Accu[i];
+            }
+            NoiseLFSR[Channel] = Tmp;
+        } break;
+    }
 
-        WavGenOut &= CRSID_WAVE_MASK; // 0xFFFF
-        PrevWavGenOut[Channel] = WavGenOut;
-        PrevPhaseAccu[Channel] = *PhaseAccuPtr;
-        RingSourceMSB = MSB;
+    PrevWavGenOut[Channel] = Out[samples-1];
+}
 
-        // routing the channel signal to either the filter or the unfiltered master output
-        // depending on filter-switch SID-registers
-        EnvOut = adsr->counter(Channel);
-        unsigned char Envelope = (LIKELY(m_settings->is8580()))
-            ? EnvOut : ADSR_DAC_6581[EnvOut];
-        int swave = static_cast<int>(WavGenOut) - CRSID_WAVE_MID;
-        if (UNLIKELY(FilterSwitchReso & (1 << Channel)))
-        {
-            FilterInput += (swave * Envelope) / ENVELOPE_MAGNITUDE_DIV;
-        }
-        else if (LIKELY(Channel!=2 || !(VolumeBand & OFF3_BITVAL)))
+void WavGen::oscillate(int samples, bool lastOnly)
+{
+    // Waveform-generator (phase accumulator and waveform-selector)
+
+    if (LIKELY(!SyncVoices))
+        clockPhaseAccu(samples);
+    else
+        clockSyncedPhaseAccu(samples);
+
+    for (int Channel=0; Channel<SID_CHANNEL_COUNT; Channel++)
+        clockWaveform(Channel, samples, lastOnly);
+
+    for (int Channel=0; Channel<SID_CHANNEL_COUNT; Channel++)
+        PhaseAccu[Channel] = BlockPhaseAccu[Channel][samples-1];
+    RingSourceMSB = PhaseAccu[2] & PHASEACCU_MSB_BITVAL;
+}
+
+void WavGen::clock(int samples, const unsigned char (*envelope)[BLOCK_SAMPLES],
+                   int *filterInput, int *nonFiltered)
+{
+    if (UNLIKELY(samples == 0))
+        return;
+
+    oscillate(samples, false);
+
+    // routing the channel signal to either the filter or the unfiltered master output
+    // depending on filter-switch SID-registers, all the voices are mixed at once
+    const unsigned char *Dac = m_settings->is8580() ? ADSR_DAC_8580.data() : ADSR_DAC_6581;
+    for (int i=0; i<samples; i++)
+    {
+        int FilterInput = 0;
+        int NonFiltered = 0;
+        for (int Channel=0; Channel<SID_CHANNEL_COUNT; Channel++)
         {
-            NonFiltered += (swave * Envelope) / ENVELOPE_MAGNITUDE_DIV;
+            const int swave = BlockWavGenOut[Channel][i] - CRSID_WAVE_MID;
+            const int Voice = (swave * Dac[envelope[Channel][i]]) / ENVELOPE_MAGNITUDE_DIV;
+            FilterInput += Voice & FilterMask[Channel];
+            NonFiltered += Voice & DirectMask[Channel];
         }
+        filterInput[i] = FilterInput;
+        nonFiltered[i] = NonFiltered;
     }
+
     // update readable SID1-registers (some SID tunes might use 3rd channel ENV3/OSC3 value as control)
-    oscReg = WavGenOut >> WAVE_OSC3_SHIFTS; // OSC3, ENV3 (some players rely on it, unfortunately even for timing)
-    envReg = EnvOut; // Envelope
+    oscReg = PrevWavGenOut[2] >> WAVE_OSC3_SHIFTS; // OSC3, ENV3 (some players rely on it, unfortunately even for timing)
+    envReg = envelope[2][samples-1]; // Envelope
+}
 
-    return std::make_pair(FilterInput, NonFiltered);
+void WavGen::skip(int samples)
+{
+    if (UNLIKELY(samples == 0))
+        return;
+
+    // the oscillators keep running but the voices are muted
+    // by the envelopes, so only the last sample is needed
+    // where the waveform doesn't depend on the previous ones
+    oscillate(samples, true);
+
+    oscReg = PrevWavGenOut[2] >> WAVE_OSC3_SHIFTS;
+    envReg = 0;
 }
 
 WavGen::WavGen(settings *s, unsigned char *regs) :
@@ -389,13 +562,14 @@ void WavGen::reset()
     for (int Channel=0; Channel<SID_CHANNEL_COUNT; Channel++)
     {
         PhaseAccu[Channel] = 0;
-        PrevPhaseAccu[Channel] = 0;
         NoiseLFSR[Channel] = 0x7FFFFF;
         PrevWavGenOut[Channel] = 0;
         PrevWavData[Channel] = 0;
         PrevSounDemonDigiWF[Channel] = 0x00;
     }
-}
 
+    RingSourceMSB = 0;
+    SyncSourceMSBrise = 0;
 }
 
+}
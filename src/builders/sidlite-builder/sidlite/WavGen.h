@@ -23,26 +23,55 @@
 #ifndef SIDLITE_WAVGEN_H
 #define SIDLITE_WAVGEN_H
 
-#include <utility>
+#include "sl_constants.h"
 
 namespace SIDLite
 {
 
-class ADSR;
 class settings;
 
-using wg_output_t = std::pair<int, int>;
-
 class WavGen
 {
 public:
     WavGen(settings *s, unsigned char *regs);
     void reset();
-    wg_output_t clock(const ADSR *adsr);
+
+    /**
+     * Render a block of samples.
+     * The registers must not change during the block.
+     *
+     * @param samples the number of samples to render
+     * @param envelope the envelope of each voice at every sample
+     * @param filterInput the output routed to the filter
+     * @param nonFiltered the output bypassing the filter
+     */
+    void clock(int samples, const unsigned char (*envelope)[BLOCK_SAMPLES],
+               int *filterInput, int *nonFiltered);
+
+    /**
+     * Advance the oscillators for a block of silent samples,
+     * when all the envelopes are at zero.
+     * Only the state and the readable registers are updated.
+     *
+     * @param samples the number of samples to skip
+     */
+    void skip(int samples);
+
+    /**
+     * Compute the voice parameters derived from the registers.
+     * Must be called after any register or settings change.
+     */
+    void latch();
 
     inline unsigned char getOsc3() const { return oscReg; }
     inline unsigned char getEnv3() const { return envReg; }
 
+private:
+    void clockPhaseAccu(int samples);
+    void clockSyncedPhaseAccu(int samples);
+    void clockWaveform(int Channel, int samples, bool lastOnly);
+    void oscillate(int samples, bool lastOnly);
+
 private:
     unsigned char *m_regs;
     settings      *m_settings;
@@ -58,6 +87,24 @@ private:
 
     unsigned char oscReg;
     unsigned char envReg;
+
+    // Voice parameters latched from the registers
+    unsigned int  PhaseAccuStep[3];
+    int           PhaseAccuMask[3];   // zero when the test bit is set
+    int           FilterMask[3];      // voice routed to the filter
+    int           DirectMask[3];      // voice routed to the output
+    unsigned int  PulseWidth[3];
+    int           PulseSteepness[3];
+    int           PulseRisingPeak[3];
+    int           PulseFallingPeak[3];
+    int           SawSteepness[3];
+    unsigned short CombinedPW[3];
+    unsigned short CombinedFilt[3];
+    unsigned char SyncVoices;         // bitmask of voices with hard sync enabled
+
+    // Block buffers, one row per voice
+    int           BlockPhaseAccu[3][BLOCK_SAMPLES];
+    int           BlockWavGenOut[3][BLOCK_SAMPLES];
 };
 
 }
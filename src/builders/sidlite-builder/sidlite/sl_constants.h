@@ -28,6 +28,9 @@ namespace SIDLite
 
 constexpr int SID_CHANNEL_COUNT = 3;
 
+// maximum number of samples rendered in a single block
+constexpr int BLOCK_SAMPLES = 256;
+
 //attenuates wave-generator output not to overdrive resampler-input (and maybe filter-input):
 constexpr int CRSID_WAVGEN_PRESHIFT = 3;
 constexpr int CRSID_WAVGEN_PREDIV = 1 << CRSID_WAVGEN_PRESHIFT; //shift-value can be 1..4 (1..16x division)
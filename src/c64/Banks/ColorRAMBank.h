@@ -60,6 +60,8 @@ public:
     {
         return ram[address & 0x3ff];
     }
+
+    const uint8_t* data() const { return ram; }
 };
 
 }
@@ -22,6 +22,7 @@
 #ifndef SYSTEMRAMBANK_H
 #define SYSTEMRAMBANK_H
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 
@@ -43,6 +44,21 @@ private:
     /// C64 RAM area
     uint8_t ram[0x10000];
 
+    /// Pages written since the last check, one flag per 256 bytes page
+    uint8_t dirty[0x100] = {};
+
+    bool trackDirty = false;
+
+private:
+    void markDirty(uint_least16_t start, unsigned int size)
+    {
+        if (trackDirty && (size > 0)) UNLIKELY
+        {
+            const unsigned int end = std::min(start + size - 1, 0xffffu);
+            std::memset(dirty + (start >> 8), 1, (end >> 8) - (start >> 8) + 1);
+        }
+    }
+
 public:
     /**
      * Initialize RAM with powerup pattern.
@@ -67,8 +83,45 @@ public:
                 std::memset(ram+j+i, byte, 0x04);
             }
         }
+
+        markDirty(0, 0x10000);
     }
 
+    /**
+     * Enable/disable tracking of the written pages.
+     * Enabling marks all the pages as dirty.
+     */
+    void trackDirtyPages(bool enable)
+    {
+        trackDirty = enable;
+        std::memset(dirty, 1, sizeof(dirty));
+    }
+
+    /**
+     * Get the pages written since the last call and clear them.
+     *
+     * @param bitmap 32 bytes, one bit per page, LSB first
+     * @return the number of dirty pages
+     */
+    unsigned int getDirtyPages(uint8_t* bitmap)
+    {
+        unsigned int count = 0;
+        for (int i = 0; i < 0x20; i++)
+        {
+            uint8_t bits = 0;
+            for (int j = 0; j < 8; j++)
+            {
+                bits |= dirty[i * 8 + j] << j;
+                count += dirty[i * 8 + j];
+            }
+            bitmap[i] = bits;
+        }
+        std::memset(dirty, 0, sizeof(dirty));
+        return count;
+    }
+
+    const uint8_t* data() const { return ram; }
+
     uint8_t peek(uint_least16_t address) override
     {
         return ram[address];
@@ -77,6 +130,8 @@ public:
     void poke(uint_least16_t address, uint8_t value) override
     {
         ram[address] = value;
+        if (trackDirty) UNLIKELY
+            dirty[address >> 8] = 1;
     }
 };
 
@@ -226,6 +226,11 @@ void MOS652X::write(uint_least8_t addr, uint8_t data)
     timerA.syncWithCpu();
     timerB.syncWithCpu();
 
+    // The TOD ring counter depends on the 50/60 Hz flag
+    const bool todRateChanged = (addr == CRA) && ((data ^ regs[CRA]) & 0x80);
+    if (todRateChanged)
+        tod.syncWithCpu();
+
     const uint8_t oldData = regs[addr];
     regs[addr] = data;
 
@@ -285,6 +290,9 @@ void MOS652X::write(uint_least8_t addr, uint8_t data)
 
     timerA.wakeUpAfterSyncWithCpu();
     timerB.wakeUpAfterSyncWithCpu();
+
+    if (todRateChanged)
+        tod.wakeUpAfterSyncWithCpu();
 }
 
 void MOS652X::bTick()
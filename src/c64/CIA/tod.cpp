@@ -23,6 +23,7 @@
 
 #include "tod.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "mos652x.h"
@@ -30,9 +31,67 @@
 namespace libsidplayfp
 {
 
+/// Number of tenths of seconds in a full AM/PM cycle.
+constexpr int TENTHS_PER_DAY = 24 * 60 * 60 * 10;
+
+/// Longest delay we can schedule at once.
+constexpr event_clock_t MAX_DELAY = 0x7fffffff;
+
+/**
+ * Convert a BCD time to tenths of seconds since 12:00:00.0 AM.
+ *
+ * @return -1 if the time is not one that the counters reach by counting
+ */
+static int toTenths(const uint8_t time[4])
+{
+    const int ts = time[0] & 0x0f;
+    const int sl = time[1] & 0x0f;
+    const int sh = (time[1] >> 4) & 0x07;
+    const int ml = time[2] & 0x0f;
+    const int mh = (time[2] >> 4) & 0x07;
+    const int hl = time[3] & 0x0f;
+    const int hh = (time[3] >> 4) & 0x01;
+    const bool pm = time[3] & 0x80;
+
+    if ((ts > 9) || (sl > 9) || (sh > 5) || (ml > 9) || (mh > 5))
+        return -1;
+
+    const int hours = hh * 10 + hl;
+    if ((hl > 9) || (hours < 1) || (hours > 12))
+        return -1;
+
+    return ((((hours % 12) + (pm ? 12 : 0)) * 60 + (mh * 10 + ml)) * 60 + (sh * 10 + sl)) * 10 + ts;
+}
+
+/**
+ * Advance the 50/60 Hz ring counter.
+ */
+static unsigned int nextTick(unsigned int counter)
+{
+    // todtickcounter bits are mirrored to save an ANDing
+    return (counter >> 1) | ((~counter << 2) & 0x4);
+}
+
+/**
+ * Count the power line ticks before the ring counter matches.
+ *
+ * @return -1 if it never does
+ */
+static int ticksToMatch(unsigned int counter, unsigned int match)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        if (counter == match)
+            return i;
+        counter = nextTick(counter);
+    }
+    return -1;
+}
+
 void Tod::reset()
 {
-    cycles = 0;
+    tickBase = eventScheduler.getTime(EVENT_CLOCK_PHI1);
+    ticks = 0;
     todtickcounter = 0;
 
     std::memset(m_clock, 0, sizeof(m_clock));
@@ -43,7 +102,7 @@ void Tod::reset()
     isLatched = false;
     isStopped = true;
 
-    eventScheduler.schedule(*this, 0, EVENT_CLOCK_PHI1);
+    eventScheduler.cancel(*this);
 }
 
 uint8_t Tod::read(uint_least8_t reg)
@@ -52,6 +111,8 @@ uint8_t Tod::read(uint_least8_t reg)
     // upon reading Tenths of Seconds. The counter itself
     // keeps ticking all the time.
     // Also note that this latching is different from the input one.
+    syncWithCpu();
+
     if (!isLatched)
         std::memcpy(m_latch, m_clock, sizeof(m_latch));
 
@@ -65,6 +126,8 @@ uint8_t Tod::read(uint_least8_t reg)
 
 void Tod::write(uint_least8_t reg, uint8_t data)
 {
+    syncWithCpu();
+
     switch (reg)
     {
     case TENTHS: // Time Of Day clock 1/10 s
@@ -128,41 +191,106 @@ void Tod::write(uint_least8_t reg, uint8_t data)
     {
         checkAlarm();
     }
+
+    scheduleAlarm();
 }
 
-void Tod::event()
+void Tod::syncWithCpu()
 {
-    cycles += period;
+    // Ticks happen at PHI1 so the one in the current cycle
+    // has already elapsed
+    const event_clock_t elapsed = eventScheduler.getTime(EVENT_CLOCK_PHI2) - tickBase;
+    if (elapsed < 0)
+        return;
 
     // Fixed precision 25.7
-    eventScheduler.schedule(*this, cycles >> 7);
-    cycles &= 0x7F; // Just keep the decimal part
+    const event_clock_t lastTick = (((elapsed + 1) << 7) - 1) / period;
 
-    if (!isStopped)
+    if (isStopped)
     {
-        /*
-         * The divider which divides the 50 or 60 Hz power supply ticks into
-         * 10 Hz uses a 3-bit ring counter, which goes 000, 001, 011, 111, 110,
-         * 100.
-         * For 50 Hz: matches at 110 (like "4")
-         * For 60 Hz: matches at 100 (like "5")
-         * (the middle bit of the match value is CRA7)
-         * After a match there is a 1 tick delay (until the next power supply
-         * tick) and then the 1/10 seconds counter increases, and the ring
-         * resets to 000.
-         */
-        // todtickcounter bits are mirrored to save an ANDing
-        if (todtickcounter == (0x1 | ((cra & 0x80) >> 6)))
-        {
-            // reset the counter and update the timer
-            todtickcounter = 0;
-            updateCounters();
-        }
-        else
-        {
-            // Count 50/60 Hz power supply ticks
-            todtickcounter = (todtickcounter >> 1) | ((~todtickcounter << 2) & 0x4);
-        }
+        ticks = lastTick + 1;
+        return;
+    }
+
+    while (ticks <= lastTick)
+    {
+        tick();
+        ticks++;
+    }
+}
+
+void Tod::scheduleAlarm()
+{
+    eventScheduler.cancel(*this);
+
+    if (isStopped)
+        return;
+
+    // Find the next tick which updates the counters
+    const unsigned int match = 0x1 | ((cra & 0x80) >> 6);
+    const int steps = ticksToMatch(todtickcounter, match);
+    if (steps < 0)
+        return; // the ring counter never matches
+
+    const event_clock_t nextUpdate = ticks + steps;
+    const int ticksPerTenth = ticksToMatch(0, match) + 1;
+
+    event_clock_t alarmTick;
+
+    const int clock = toTenths(m_clock);
+    if (clock < 0)
+    {
+        // Not a regular time, step through the updates
+        // until the counters fall back into line
+        alarmTick = nextUpdate;
+    }
+    else
+    {
+        const int alarm = toTenths(m_alarm);
+        if (alarm < 0)
+            return; // can't be reached by counting
+
+        int distance = alarm - clock;
+        if (distance <= 0)
+            distance += TENTHS_PER_DAY;
+
+        alarmTick = nextUpdate + static_cast<event_clock_t>(distance - 1) * ticksPerTenth;
+    }
+
+    const event_clock_t delay = tickTime(alarmTick) - eventScheduler.getTime(EVENT_CLOCK_PHI1);
+    eventScheduler.schedule(*this, static_cast<unsigned int>(std::min(delay, MAX_DELAY)), EVENT_CLOCK_PHI1);
+}
+
+void Tod::event()
+{
+    syncWithCpu();
+    scheduleAlarm();
+}
+
+void Tod::tick()
+{
+    /*
+     * The divider which divides the 50 or 60 Hz power supply ticks into
+     * 10 Hz uses a 3-bit ring counter, which goes 000, 001, 011, 111, 110,
+     * 100.
+     * For 50 Hz: matches at 110 (like "4")
+     * For 60 Hz: matches at 100 (like "5")
+     * (the middle bit of the match value is CRA7)
+     * After a match there is a 1 tick delay (until the next power supply
+     * tick) and then the 1/10 seconds counter increases, and the ring
+     * resets to 000.
+     */
+    // todtickcounter bits are mirrored to save an ANDing
+    if (todtickcounter == (0x1 | ((cra & 0x80) >> 6)))
+    {
+        // reset the counter and update the timer
+        todtickcounter = 0;
+        updateCounters();
+    }
+    else
+    {
+        // Count 50/60 Hz power supply ticks
+        todtickcounter = nextTick(todtickcounter);
     }
 }
 
@@ -35,6 +35,11 @@ class MOS652X;
 
 /**
  * TOD implementation taken from Vice.
+ *
+ * The clock is not ticked by a periodic event, instead the power line
+ * ticks elapsed since the last access are accounted for lazily
+ * when the registers are accessed. An event is scheduled only
+ * to trigger a pending alarm.
  */
 class Tod : private Event
 {
@@ -57,7 +62,13 @@ private:
     const uint8_t &cra;
     const uint8_t &crb;
 
-    event_clock_t cycles;
+    /// Clock of the first power line tick.
+    event_clock_t tickBase;
+
+    /// Number of power line ticks accounted for so far.
+    event_clock_t ticks;
+
+    /// Power line tick period, fixed precision 25.7.
     event_clock_t period;
 
     unsigned int todtickcounter;
@@ -74,6 +85,18 @@ private:
 
     inline void updateCounters();
 
+    inline void tick();
+
+    /**
+     * Get the clock of the specified power line tick.
+     */
+    event_clock_t tickTime(event_clock_t tick) const { return tickBase + ((tick * period) >> 7); }
+
+    /**
+     * Schedule the event for the next alarm match, if any.
+     */
+    void scheduleAlarm();
+
     void event() override;
 
 public:
@@ -83,8 +106,12 @@ public:
         m_parent(parent),
         cra(regs[0x0e]),
         crb(regs[0x0f]),
+        tickBase(0),
+        ticks(0),
         period(~0), // Dummy
-        todtickcounter(0)
+        todtickcounter(0),
+        isLatched(false),
+        isStopped(true)
     {}
 
     /**
@@ -110,6 +137,17 @@ public:
      */
     void write(uint_least8_t reg, uint8_t data);
 
+    /**
+     * Account for the power line ticks elapsed up to the current cycle.
+     */
+    void syncWithCpu();
+
+    /**
+     * Counterpart of syncWithCpu(),
+     * schedules the alarm event if it is needed.
+     */
+    void wakeUpAfterSyncWithCpu() { scheduleAlarm(); }
+
     /**
      * Set TOD period.
      *
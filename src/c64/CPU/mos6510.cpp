@@ -32,8 +32,6 @@
 
 #include "sidcxx11.h"
 
-#include <iomanip>
-#include <sstream>
 
 
 namespace libsidplayfp
@@ -63,6 +61,9 @@ void StaticFuncWrapper(MOS6510& self)
  */
 void MOS6510::eventWithoutSteals()
 {
+#ifdef ENABLE_STATS
+    m_executedCycles++;
+#endif
     const ProcessorCycle &instr = instrTable[cycleCount++];
     (instr.func)(*this);
     eventScheduler.schedule(m_nosteal, 1);
@@ -75,12 +76,18 @@ void MOS6510::eventWithSteals()
 {
     if (instrTable[cycleCount].nosteal)
     {
+#ifdef ENABLE_STATS
+        m_executedCycles++;
+#endif
         const ProcessorCycle &instr = instrTable[cycleCount++];
         (instr.func)(*this);
         eventScheduler.schedule(m_steal, 1);
     }
     else
     {
+#ifdef ENABLE_STATS
+        m_stolenCycles++;
+#endif
         switch (cycleCount)
         {
         case (CLIn << 3):
@@ -236,14 +243,16 @@ void MOS6510::interruptsAndNextOpcode()
         if (cpu_debug) UNLIKELY
         {
             const event_clock_t cycles = eventScheduler.getTime(EVENT_CLOCK_PHI2);
-            MOS6510Debug::DumpState(cycles, *this);
-            fprintf(cpu_debug->m_fdbg, "****************************************************\n");
-            fprintf(cpu_debug->m_fdbg, " interrupt (%d)\n", static_cast<int>(cycles));
-            fprintf(cpu_debug->m_fdbg, "****************************************************\n");
+            MOS6510Debug::DumpState(cycles, *this, MOS6510Debug::INTERRUPT);
 
             cpu_debug->instrStartPC = -1;
         }
 
+        if (cpu_profile) UNLIKELY
+        {
+            profileInstruction(true, BRKn);
+        }
+
         cpuRead(Register_ProgramCounter);
         cycleCount = BRKn << 3;
         d1x1 = true;
@@ -259,7 +268,7 @@ void MOS6510::fetchNextOpcode()
 {
     if (cpu_debug) UNLIKELY
     {
-        MOS6510Debug::DumpState(eventScheduler.getTime(EVENT_CLOCK_PHI2), *this);
+        MOS6510Debug::DumpState(eventScheduler.getTime(EVENT_CLOCK_PHI2), *this, MOS6510Debug::INSTRUCTION);
 
         cpu_debug->instrStartPC = Register_ProgramCounter;
     }
@@ -267,6 +276,12 @@ void MOS6510::fetchNextOpcode()
     rdyOnThrowAwayRead = false;
 
     cycleCount = cpuRead(Register_ProgramCounter) << 3;
+
+    if (cpu_profile) UNLIKELY
+    {
+        profileInstruction(false, cycleCount >> 3);
+    }
+
     Register_ProgramCounter++;
 
     if (!checkInterrupts())
@@ -279,6 +294,28 @@ void MOS6510::fetchNextOpcode()
     }
 }
 
+void MOS6510::profileInstruction(bool interrupt, uint8_t opcode)
+{
+    const event_clock_t now = eventScheduler.getTime(EVENT_CLOCK_PHI2);
+
+    if (cpu_profile->instrStartTime >= 0)
+    {
+        const uint_least64_t cycles = now - cpu_profile->instrStartTime;
+        if (cpu_profile->instrStartPC < 0)
+            cpu_profile->interruptCycles += cycles;
+        else
+            cpu_profile->cycles[cpu_profile->instrStartPC] += cycles;
+
+        // PC now points to the subroutine
+        if (cpu_profile->opcode == JSRw)
+            cpu_profile->jsrCalls[Register_ProgramCounter]++;
+    }
+
+    cpu_profile->instrStartTime = now;
+    cpu_profile->instrStartPC = interrupt ? -1 : Register_ProgramCounter;
+    cpu_profile->opcode = opcode;
+}
+
 /**
  * Evaluate when to execute an interrupt. Calling this method can also
  * result in the decision that no interrupt at all needs to be scheduled.
@@ -699,7 +736,7 @@ void MOS6510::rti_instr()
 
     if (cpu_debug) UNLIKELY
     {
-        fprintf(cpu_debug->m_fdbg, "****************************************************\n\n");
+        MOS6510Debug::DumpState(eventScheduler.getTime(EVENT_CLOCK_PHI2), *this, MOS6510Debug::RTI);
     }
 }
 
@@ -1284,13 +1321,17 @@ void MOS6510::tya_instr()
 
 void MOS6510::invalidOpcode()
 {
-    std::ostringstream msg;
-    msg << std::setfill('0')
-        << "Illegal instruction $"
-        << std::setw(2) << std::hex << (cycleCount >> 3)
-        << " at address $"
-        << std::setw(4) << (Register_ProgramCounter-1);
-    throw haltInstruction(msg.str());
+    // The CPU locks up repeating this cycle until reset,
+    // report it only once
+    cycleCount--;
+    if (jammed)
+        return;
+
+    jammed = true;
+    std::snprintf(haltMessage, sizeof(haltMessage),
+        "Illegal instruction $%02x at address $%04x",
+        cycleCount >> 3, static_cast<unsigned int>(Register_ProgramCounter - 1) & 0xffff);
+    halt(haltMessage);
 }
 
 
@@ -1482,6 +1523,7 @@ MOS6510::MOS6510(EventScheduler &scheduler, CPUDataBus &bus) :
     eventScheduler(scheduler),
     dataBus(bus),
     cpu_debug(nullptr),
+    cpu_profile(nullptr),
     m_nosteal("CPU-nosteal", *this),
     m_steal("CPU-steal", *this),
     clearInt("Remove IRQ", *this)
@@ -2182,6 +2224,9 @@ void MOS6510::Initialise()
     rdy = true;
     d1x1 = false;
 
+    jammed = false;
+    haltReason = nullptr;
+
     eventScheduler.schedule(m_nosteal, 0, EVENT_CLOCK_PHI2);
 }
 
@@ -2229,4 +2274,69 @@ void MOS6510::debug(bool enable, FILE *out)
     }
 }
 
+void MOS6510::trace(bool enable, unsigned int size)
+{
+    if (enable)
+    {
+        cpu_debug = MAKE_UNIQUE(CPUDebug);
+        cpu_debug->m_fdbg = nullptr;
+        cpu_debug->trace = MAKE_UNIQUE_ARGS(RingBuffer<MOS6510Debug::Record>, size);
+    }
+    else
+    {
+        cpu_debug.reset();
+    }
+}
+
+unsigned int MOS6510::readTrace(MOS6510Debug::Record *records, unsigned int count)
+{
+    if (!cpu_debug || !cpu_debug->trace)
+        return 0;
+
+    return cpu_debug->trace->pop(records, count);
+}
+
+unsigned int MOS6510::traceDropped() const
+{
+    if (!cpu_debug)
+        return 0;
+
+    return cpu_debug->dropped.load(std::memory_order_relaxed);
+}
+
+void MOS6510::profile(bool enable)
+{
+    if (enable)
+    {
+        cpu_profile = MAKE_UNIQUE(CPUProfile);
+        cpu_profile->instrStartTime = -1;
+    }
+    else
+    {
+        cpu_profile.reset();
+    }
+}
+
+bool MOS6510::dumpProfile(FILE *out) const
+{
+    if (!cpu_profile)
+        return false;
+
+    for (unsigned int addr = 0; addr < 0x10000; addr++)
+    {
+        if (cpu_profile->cycles[addr])
+            fprintf(out, "C %04x %llu\n", addr, static_cast<unsigned long long>(cpu_profile->cycles[addr]));
+    }
+
+    for (unsigned int addr = 0; addr < 0x10000; addr++)
+    {
+        if (cpu_profile->jsrCalls[addr])
+            fprintf(out, "J %04x %llu\n", addr, static_cast<unsigned long long>(cpu_profile->jsrCalls[addr]));
+    }
+
+    fprintf(out, "I %llu\n", static_cast<unsigned long long>(cpu_profile->interruptCycles));
+
+    return true;
+}
+
 }
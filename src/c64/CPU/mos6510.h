@@ -23,14 +23,17 @@
 #ifndef MOS6510_H
 #define MOS6510_H
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <cstdint>
 #include <cstdio>
 
 #include "flags.h"
+#include "mos6510debug.h"
 #include "EventCallback.h"
 #include "EventScheduler.h"
+#include "ringbuffer.h"
 
 #ifdef HAVE_CONFIG_H
 #  include "config.h"
@@ -41,13 +44,6 @@ class EventContext;
 namespace libsidplayfp
 {
 
-class MOS6510;
-
-namespace MOS6510Debug
-{
-    void DumpState(event_clock_t time, MOS6510 &cpu);
-}
-
 class CPUDataBus
 {
 public:
@@ -65,9 +61,36 @@ struct CPUDebug
 
     FILE *m_fdbg;
 
+    /// Binary trace, replaces text output when present
+    std::unique_ptr<RingBuffer<MOS6510Debug::Record>> trace;
+
+    /// Records lost because the trace buffer was full
+    std::atomic<uint_least32_t> dropped;
+
     bool dodump;
 };
 
+struct CPUProfile
+{
+    /// Cycles spent per instruction address
+    uint_least64_t cycles[0x10000];
+
+    /// Calls per subroutine address
+    uint_least64_t jsrCalls[0x10000];
+
+    /// Cycles spent entering interrupts
+    uint_least64_t interruptCycles;
+
+    /// Clock of the current instruction start, -1 if not yet known
+    event_clock_t instrStartTime;
+
+    /// Address of the current instruction, -1 for interrupts
+    int_least32_t instrStartPC;
+
+    /// Opcode of the current instruction
+    uint8_t opcode;
+};
+
 /**
  * Cycle-exact 6502/6510 emulation core.
  *
@@ -79,19 +102,7 @@ struct CPUDebug
  */
 class MOS6510
 {
-    friend void MOS6510Debug::DumpState(event_clock_t time, MOS6510 &cpu);
-
-public:
-    class haltInstruction {
-private:
-    const std::string m_msg;
-
-public:
-    explicit haltInstruction(const std::string &msg) :
-        m_msg(msg) {}
-
-    std::string message() const { return m_msg; }
-};
+    friend void MOS6510Debug::DumpState(event_clock_t time, MOS6510 &cpu, MOS6510Debug::record_t type);
 
 private:
     /**
@@ -151,6 +162,9 @@ private:
     /// The RDY pin state during last throw away read.
     bool rdyOnThrowAwayRead;
 
+    /// The CPU executed a JAM opcode
+    bool jammed;
+
     /// Status register
     Flags flags;
 
@@ -168,9 +182,26 @@ private:
     /// Table of CPU opcode implementations
     struct ProcessorCycle instrTable[0x101 << 3];
 
+    /// Pending halt reason, nullptr if none
+    const char *haltReason;
+
+    /// Storage for the halt message, filled without allocating
+    char haltMessage[48];
+
     // Debug info
     std::unique_ptr<CPUDebug> cpu_debug;
 
+    // Profiling info
+    std::unique_ptr<CPUProfile> cpu_profile;
+
+#ifdef ENABLE_STATS
+    /// Executed cycles
+    uint_least64_t m_executedCycles = 0;
+
+    /// Cycles stolen by BA
+    uint_least64_t m_stolenCycles = 0;
+#endif
+
 private:
     void eventWithoutSteals();
     void eventWithSteals();
@@ -192,6 +223,14 @@ private:
     inline void interruptsAndNextOpcode();
     inline void calculateInterruptTriggerCycle();
 
+    /**
+     * Account the cycles of the instruction just completed.
+     *
+     * @param interrupt true if an interrupt sequence is starting
+     * @param opcode the opcode of the starting instruction
+     */
+    void profileInstruction(bool interrupt, uint8_t opcode);
+
     // Declare Instruction Routines
     inline void fetchNextOpcode();
     inline void throwAwayFetch();
@@ -307,7 +346,7 @@ private:
     inline void sh_instr();
 
     /**
-     * @throws haltInstruction
+     * Jam the CPU, the halt is reported through #halted().
      */
     void invalidOpcode();
 
@@ -331,13 +370,84 @@ public:
     static const char *credits();
 
     void debug(bool enable, FILE *out);
+
+    /**
+     * Enable/disable binary tracing.
+     * Each instruction is stored as a MOS6510Debug::Record
+     * into a lock-free ring buffer instead of being printed.
+     * Records are dropped if the buffer is full.
+     *
+     * @param enable
+     * @param size the buffer capacity in records
+     */
+    void trace(bool enable, unsigned int size);
+
+    /**
+     * Fetch trace records.
+     * May be called from a different thread than the emulation one.
+     *
+     * @param records destination buffer
+     * @param count maximum number of records to read
+     * @return the number of records read
+     */
+    unsigned int readTrace(MOS6510Debug::Record *records, unsigned int count);
+
+    /**
+     * Get the number of records dropped because the buffer was full.
+     */
+    unsigned int traceDropped() const;
+
+    /**
+     * Enable/disable profiling.
+     * Enabling clears the counters.
+     */
+    void profile(bool enable);
+
+    /**
+     * Write the profile in text format, one entry per line:
+     * - "C address cycles" for the cycles spent per instruction address
+     * - "J address calls" for the calls per subroutine address
+     * - "I cycles" for the cycles spent entering interrupts
+     *
+     * Addresses are in hex, counts in decimal.
+     *
+     * @return false if profiling is not enabled
+     */
+    bool dumpProfile(FILE *out) const;
+
     void setRDY(bool newRDY);
 
+    /**
+     * Stop the emulation, reported through #halted().
+     * Only the first reason is kept until it is retrieved.
+     *
+     * @param reason a string which must outlive the call to #halted()
+     */
+    void halt(const char *reason) { if (haltReason == nullptr) haltReason = reason; }
+
+    /**
+     * Get and clear the pending halt reason.
+     *
+     * @return the reason or nullptr if the emulation didn't halt
+     */
+    const char *halted()
+    {
+        const char *reason = haltReason;
+        haltReason = nullptr;
+        return reason;
+    }
+
     // Non-standard functions
     void triggerRST();
     void triggerNMI();
     void triggerIRQ();
     void clearIRQ();
+
+#ifdef ENABLE_STATS
+    uint_least64_t executedCycles() const { return m_executedCycles; }
+    uint_least64_t stolenCycles() const { return m_stolenCycles; }
+    void resetStats() { m_executedCycles = m_stolenCycles = 0; }
+#endif
 };
 
 }
@@ -1,7 +1,7 @@
 /*
  * This file is part of libsidplayfp, a SID player engine.
  *
- * Copyright 2011-2019 Leandro Nini <drfiemost@users.sourceforge.net>
+ * Copyright 2011-2026 Leandro Nini <drfiemost@users.sourceforge.net>
  * Copyright 2007-2010 Antti Lankila
  * Copyright 2000 Simon White
  *
@@ -32,36 +32,79 @@
 namespace libsidplayfp
 {
 
-void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
+void MOS6510Debug::DumpState(event_clock_t time, MOS6510 &cpu, record_t type)
 {
-    fprintf(cpu.cpu_debug->m_fdbg, " PC  I  A  X  Y  SP  DR PR NV-BDIZC  Instruction (%d)\n", static_cast<int>(time));
-    fprintf(cpu.cpu_debug->m_fdbg, "%04x ", cpu.cpu_debug->instrStartPC < 0 ? 0 : cpu.cpu_debug->instrStartPC);
-    fprintf(cpu.cpu_debug->m_fdbg, cpu.irqAssertedOnPin ? "t " : "f ");
-    fprintf(cpu.cpu_debug->m_fdbg, "%02x ",   cpu.Register_Accumulator);
-    fprintf(cpu.cpu_debug->m_fdbg, "%02x ",   cpu.Register_X);
-    fprintf(cpu.cpu_debug->m_fdbg, "%02x ",   cpu.Register_Y);
-    fprintf(cpu.cpu_debug->m_fdbg, "01%02x ", endian_16lo8(cpu.Register_StackPointer));
-    fprintf(cpu.cpu_debug->m_fdbg, "%02x ",   cpu.cpuRead (0));
-    fprintf(cpu.cpu_debug->m_fdbg, "%02x ",   cpu.cpuRead (1));
+    Record record = {};
+    record.type = type;
+    record.time = time;
 
-    fprintf(cpu.cpu_debug->m_fdbg, cpu.flags.getN() ? "1" : "0");
-    fprintf(cpu.cpu_debug->m_fdbg, cpu.flags.getV()  ? "1" : "0");
-    fprintf(cpu.cpu_debug->m_fdbg, "1");
-    fprintf(cpu.cpu_debug->m_fdbg, cpu.d1x1 ? "0" : "1");
-    fprintf(cpu.cpu_debug->m_fdbg, cpu.flags.getD() ? "1" : "0");
-    fprintf(cpu.cpu_debug->m_fdbg, cpu.flags.getI() ? "1" : "0");
-    fprintf(cpu.cpu_debug->m_fdbg, cpu.flags.getZ() ? "1" : "0");
-    fprintf(cpu.cpu_debug->m_fdbg, cpu.flags.getC() ? "1" : "0");
+    if (type != RTI)
+    {
+        const int_least32_t pc = cpu.cpu_debug->instrStartPC;
+        record.pc = pc < 0 ? 0 : pc;
+        record.operand = cpu.cpu_debug->instrOperand;
+        record.effectiveAddress = cpu.Cycle_EffectiveAddress;
+        record.data = cpu.Cycle_Data;
+        record.a = cpu.Register_Accumulator;
+        record.x = cpu.Register_X;
+        record.y = cpu.Register_Y;
+        record.sp = endian_16lo8(cpu.Register_StackPointer);
+        record.port0 = cpu.cpuRead(0);
+        record.port1 = cpu.cpuRead(1);
+        record.opcode = pc < 0 ? BRKn : cpu.cpuRead(pc);
+        record.flags =
+            (cpu.flags.getN() ? 0x80 : 0) |
+            (cpu.flags.getV() ? 0x40 : 0) |
+            (cpu.irqAssertedOnPin ? 0x20 : 0) |
+            (cpu.d1x1 ? 0 : 0x10) |
+            (cpu.flags.getD() ? 0x08 : 0) |
+            (cpu.flags.getI() ? 0x04 : 0) |
+            (cpu.flags.getZ() ? 0x02 : 0) |
+            (cpu.flags.getC() ? 0x01 : 0);
+    }
 
-    const int opcode = cpu.cpu_debug->instrStartPC < 0 ? BRKn : cpu.cpuRead(cpu.cpu_debug->instrStartPC);
+    if (cpu.cpu_debug->trace)
+    {
+        if (!cpu.cpu_debug->trace->push(record))
+            cpu.cpu_debug->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        Decode(record, cpu.cpu_debug->m_fdbg);
+        fflush(cpu.cpu_debug->m_fdbg);
+    }
+}
 
-    fprintf(cpu.cpu_debug->m_fdbg, "  %02x ", opcode);
+void MOS6510Debug::Decode(const Record &record, FILE *out)
+{
+    if (record.type == RTI)
+    {
+        fprintf(out, "****************************************************\n\n");
+        return;
+    }
+
+    fprintf(out, " PC  I  A  X  Y  SP  DR PR NV-BDIZC  Instruction (%d)\n", static_cast<int>(record.time));
+    fprintf(out, "%04x ", record.pc);
+    fprintf(out, (record.flags & 0x20) ? "t " : "f ");
+    fprintf(out, "%02x ",   record.a);
+    fprintf(out, "%02x ",   record.x);
+    fprintf(out, "%02x ",   record.y);
+    fprintf(out, "01%02x ", record.sp);
+    fprintf(out, "%02x ",   record.port0);
+    fprintf(out, "%02x ",   record.port1);
+
+    for (int bit = 0x80; bit != 0; bit >>= 1)
+        fprintf(out, (bit == 0x20) || (record.flags & bit) ? "1" : "0");
+
+    const int opcode = record.opcode;
+
+    fprintf(out, "  %02x ", opcode);
 
     switch(opcode)
     {
     // Accumulator or Implied cpu.Cycle_EffectiveAddressing
     case ASLn: case LSRn: case ROLn: case RORn:
-        fprintf(cpu.cpu_debug->m_fdbg, "      ");
+        fprintf(out, "      ");
         break;
     // Zero Page Addressing Mode Handler
     case ADCz: case ANDz: case ASLz: case BITz: case CMPz: case CPXz:
@@ -70,7 +113,7 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case ORAz: case ROLz: case RORz: case SAXz: case SBCz: case SREz:
     case STAz: case STXz: case STYz: case SLOz: case RLAz: case RRAz:
     // ASOz AXSz DCMz INSz LSEz - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "%02x    ", endian_16lo8(cpu.cpu_debug->instrOperand));
+        fprintf(out, "%02x    ", endian_16lo8(record.operand));
             break;
     // Zero Page with X Offset Addressing Mode Handler
     case ADCzx:  case ANDzx: case ASLzx: case CMPzx: case DCPzx: case DECzx:
@@ -78,12 +121,12 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case NOPzx_: case ORAzx: case RLAzx: case ROLzx: case RORzx: case RRAzx:
     case SBCzx:  case SLOzx: case SREzx: case STAzx: case STYzx:
     // ASOzx DCMzx INSzx LSEzx - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "%02x    ", endian_16lo8(cpu.cpu_debug->instrOperand));
+        fprintf(out, "%02x    ", endian_16lo8(record.operand));
             break;
     // Zero Page with Y Offset Addressing Mode Handler
     case LDXzy: case STXzy: case SAXzy: case LAXzy:
     // AXSzx - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "%02x    ", endian_16lo8(cpu.cpu_debug->instrOperand));
+        fprintf(out, "%02x    ", endian_16lo8(record.operand));
             break;
     // Absolute Addressing Mode Handler
     case ADCa: case ANDa: case ASLa: case BITa: case CMPa: case CPXa:
@@ -93,7 +136,7 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case SBCa: case SLOa: case SREa: case STAa: case STXa: case STYa:
     case RLAa: case RRAa:
     // ASOa AXSa DCMa INSa LSEa - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "%02x %02x ", endian_16lo8(cpu.cpu_debug->instrOperand), endian_16hi8 (cpu.cpu_debug->instrOperand));
+        fprintf(out, "%02x %02x ", endian_16lo8(record.operand), endian_16hi8 (record.operand));
             break;
     // Absolute With X Offset Addresing Mode Handler
     case ADCax:  case ANDax: case ASLax: case CMPax: case DCPax: case DECax:
@@ -101,7 +144,7 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case NOPax_: case ORAax: case RLAax: case ROLax: case RORax: case RRAax:
     case SBCax:  case SHYax: case SLOax: case SREax: case STAax:
     // ASOax DCMax INSax LSEax SAYax - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "%02x %02x ", endian_16lo8(cpu.cpu_debug->instrOperand), endian_16hi8 (cpu.cpu_debug->instrOperand));
+        fprintf(out, "%02x %02x ", endian_16lo8(record.operand), endian_16hi8 (record.operand));
             break;
     // Absolute With Y Offset Addresing Mode Handler
     case ADCay: case ANDay: case CMPay: case DCPay: case EORay: case ISBay:
@@ -109,7 +152,7 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case RRAay: case SBCay: case SHAay: case SHSay: case SHXay: case SLOay:
     case SREay: case STAay:
     // ASOay AXAay DCMay INSax LSEay TASay XASay - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "%02x %02x ", endian_16lo8(cpu.cpu_debug->instrOperand), endian_16hi8 (cpu.cpu_debug->instrOperand));
+        fprintf(out, "%02x %02x ", endian_16lo8(record.operand), endian_16hi8 (record.operand));
             break;
     // Immediate and Relative Addressing Mode Handler
     case ADCb: case ANDb: case ANCb_: case ANEb: case ASRb:  case ARRb:
@@ -118,28 +161,28 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case CMPb: case CPXb: case CPYb:  case EORb: case LDAb:  case LDXb:
     case LDYb: case LXAb: case NOPb_: case ORAb: case SBCb_: case SBXb:
     // OALb ALRb XAAb - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "%02x    ", endian_16lo8(cpu.Cycle_Data));
+        fprintf(out, "%02x    ", endian_16lo8(record.data));
             break;
     // Indirect Addressing Mode Handler
     case JMPi:
-        fprintf(cpu.cpu_debug->m_fdbg, "%02x %02x ", endian_16lo8(cpu.cpu_debug->instrOperand), endian_16hi8 (cpu.cpu_debug->instrOperand));
+        fprintf(out, "%02x %02x ", endian_16lo8(record.operand), endian_16hi8 (record.operand));
             break;
     // Indexed with X Preinc Addressing Mode Handler
     case ADCix: case ANDix: case CMPix: case DCPix: case EORix: case ISBix:
     case LAXix: case LDAix: case ORAix: case SAXix: case SBCix: case SLOix:
     case SREix: case STAix: case RLAix: case RRAix:
     // ASOix AXSix DCMix INSix LSEix - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "%02x    ", endian_16lo8(cpu.cpu_debug->instrOperand));
+        fprintf(out, "%02x    ", endian_16lo8(record.operand));
             break;
     // Indexed with Y Postinc Addressing Mode Handler
     case ADCiy: case ANDiy: case CMPiy: case DCPiy: case EORiy: case ISBiy:
     case LAXiy: case LDAiy: case ORAiy: case RLAiy: case RRAiy: case SBCiy:
     case SHAiy: case SLOiy: case SREiy: case STAiy:
     // AXAiy ASOiy LSEiy DCMiy INSiy - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "%02x    ", endian_16lo8(cpu.cpu_debug->instrOperand));
+        fprintf(out, "%02x    ", endian_16lo8(record.operand));
             break;
     default:
-        fprintf(cpu.cpu_debug->m_fdbg, "      ");
+        fprintf(out, "      ");
             break;
     }
 
@@ -147,183 +190,183 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     {
     case ADCb: case ADCz: case ADCzx: case ADCa: case ADCax: case ADCay:
     case ADCix: case ADCiy:
-        fprintf(cpu.cpu_debug->m_fdbg, " ADC"); break;
+        fprintf(out, " ADC"); break;
     case ANCb_:
-        fprintf(cpu.cpu_debug->m_fdbg, "*ANC"); break;
+        fprintf(out, "*ANC"); break;
     case ANDb: case ANDz: case ANDzx: case ANDa: case ANDax: case ANDay:
     case ANDix: case ANDiy:
-        fprintf(cpu.cpu_debug->m_fdbg, " AND"); break;
+        fprintf(out, " AND"); break;
     case ANEb: // Also known as XAA
-        fprintf(cpu.cpu_debug->m_fdbg, "*ANE"); break;
+        fprintf(out, "*ANE"); break;
     case ARRb:
-        fprintf(cpu.cpu_debug->m_fdbg, "*ARR"); break;
+        fprintf(out, "*ARR"); break;
     case ASLn: case ASLz: case ASLzx: case ASLa: case ASLax:
-        fprintf(cpu.cpu_debug->m_fdbg, " ASL"); break;
+        fprintf(out, " ASL"); break;
     case ASRb: // Also known as ALR
-        fprintf(cpu.cpu_debug->m_fdbg, "*ASR"); break;
+        fprintf(out, "*ASR"); break;
     case BCCr:
-        fprintf(cpu.cpu_debug->m_fdbg, " BCC"); break;
+        fprintf(out, " BCC"); break;
     case BCSr:
-        fprintf(cpu.cpu_debug->m_fdbg, " BCS"); break;
+        fprintf(out, " BCS"); break;
     case BEQr:
-        fprintf(cpu.cpu_debug->m_fdbg, " BEQ"); break;
+        fprintf(out, " BEQ"); break;
     case BITz: case BITa:
-        fprintf(cpu.cpu_debug->m_fdbg, " BIT"); break;
+        fprintf(out, " BIT"); break;
     case BMIr:
-        fprintf(cpu.cpu_debug->m_fdbg, " BMI"); break;
+        fprintf(out, " BMI"); break;
     case BNEr:
-        fprintf(cpu.cpu_debug->m_fdbg, " BNE"); break;
+        fprintf(out, " BNE"); break;
     case BPLr:
-        fprintf(cpu.cpu_debug->m_fdbg, " BPL"); break;
+        fprintf(out, " BPL"); break;
     case BRKn:
-        fprintf(cpu.cpu_debug->m_fdbg, " BRK"); break;
+        fprintf(out, " BRK"); break;
     case BVCr:
-        fprintf(cpu.cpu_debug->m_fdbg, " BVC"); break;
+        fprintf(out, " BVC"); break;
     case BVSr:
-        fprintf(cpu.cpu_debug->m_fdbg, " BVS"); break;
+        fprintf(out, " BVS"); break;
     case CLCn:
-        fprintf(cpu.cpu_debug->m_fdbg, " CLC"); break;
+        fprintf(out, " CLC"); break;
     case CLDn:
-        fprintf(cpu.cpu_debug->m_fdbg, " CLD"); break;
+        fprintf(out, " CLD"); break;
     case CLIn:
-        fprintf(cpu.cpu_debug->m_fdbg, " CLI"); break;
+        fprintf(out, " CLI"); break;
     case CLVn:
-        fprintf(cpu.cpu_debug->m_fdbg, " CLV"); break;
+        fprintf(out, " CLV"); break;
     case CMPb: case CMPz: case CMPzx: case CMPa: case CMPax: case CMPay:
     case CMPix: case CMPiy:
-        fprintf(cpu.cpu_debug->m_fdbg, " CMP"); break;
+        fprintf(out, " CMP"); break;
     case CPXb: case CPXz: case CPXa:
-        fprintf(cpu.cpu_debug->m_fdbg, " CPX"); break;
+        fprintf(out, " CPX"); break;
     case CPYb: case CPYz: case CPYa:
-        fprintf(cpu.cpu_debug->m_fdbg, " CPY"); break;
+        fprintf(out, " CPY"); break;
     case DCPz: case DCPzx: case DCPa: case DCPax: case DCPay: case DCPix:
     case DCPiy: // Also known as DCM
-        fprintf(cpu.cpu_debug->m_fdbg, "*DCP"); break;
+        fprintf(out, "*DCP"); break;
     case DECz: case DECzx: case DECa: case DECax:
-        fprintf(cpu.cpu_debug->m_fdbg, " DEC"); break;
+        fprintf(out, " DEC"); break;
     case DEXn:
-        fprintf(cpu.cpu_debug->m_fdbg, " DEX"); break;
+        fprintf(out, " DEX"); break;
     case DEYn:
-        fprintf(cpu.cpu_debug->m_fdbg, " DEY"); break;
+        fprintf(out, " DEY"); break;
     case EORb: case EORz: case EORzx: case EORa: case EORax: case EORay:
     case EORix: case EORiy:
-        fprintf(cpu.cpu_debug->m_fdbg, " EOR"); break;
+        fprintf(out, " EOR"); break;
     case INCz: case INCzx: case INCa: case INCax:
-        fprintf(cpu.cpu_debug->m_fdbg, " INC"); break;
+        fprintf(out, " INC"); break;
     case INXn:
-        fprintf(cpu.cpu_debug->m_fdbg, " INX"); break;
+        fprintf(out, " INX"); break;
     case INYn:
-        fprintf(cpu.cpu_debug->m_fdbg, " INY"); break;
+        fprintf(out, " INY"); break;
     case ISBz: case ISBzx: case ISBa: case ISBax: case ISBay: case ISBix:
     case ISBiy: // Also known as INS
-        fprintf(cpu.cpu_debug->m_fdbg, "*ISB"); break;
+        fprintf(out, "*ISB"); break;
     case JMPw: case JMPi:
-        fprintf(cpu.cpu_debug->m_fdbg, " JMP"); break;
+        fprintf(out, " JMP"); break;
     case JSRw:
-        fprintf(cpu.cpu_debug->m_fdbg, " JSR"); break;
+        fprintf(out, " JSR"); break;
     case LASay:
-        fprintf(cpu.cpu_debug->m_fdbg, "*LAS"); break;
+        fprintf(out, "*LAS"); break;
     case LAXz: case LAXzy: case LAXa: case LAXay: case LAXix: case LAXiy:
-        fprintf(cpu.cpu_debug->m_fdbg, "*LAX"); break;
+        fprintf(out, "*LAX"); break;
     case LDAb: case LDAz: case LDAzx: case LDAa: case LDAax: case LDAay:
     case LDAix: case LDAiy:
-        fprintf(cpu.cpu_debug->m_fdbg, " LDA"); break;
+        fprintf(out, " LDA"); break;
     case LDXb: case LDXz: case LDXzy: case LDXa: case LDXay:
-        fprintf(cpu.cpu_debug->m_fdbg, " LDX"); break;
+        fprintf(out, " LDX"); break;
     case LDYb: case LDYz: case LDYzx: case LDYa: case LDYax:
-        fprintf(cpu.cpu_debug->m_fdbg, " LDY"); break;
+        fprintf(out, " LDY"); break;
     case LSRz: case LSRzx: case LSRa: case LSRax: case LSRn:
-        fprintf(cpu.cpu_debug->m_fdbg, " LSR"); break;
+        fprintf(out, " LSR"); break;
     case NOPn_: case NOPb_: case NOPz_: case NOPzx_: case NOPa: case NOPax_:
-        if(opcode != NOPn) fprintf(cpu.cpu_debug->m_fdbg, "*");
-        else fprintf(cpu.cpu_debug->m_fdbg, " ");
-        fprintf(cpu.cpu_debug->m_fdbg, "NOP"); break;
+        if(opcode != NOPn) fprintf(out, "*");
+        else fprintf(out, " ");
+        fprintf(out, "NOP"); break;
     case LXAb: // Also known as OAL
-        fprintf(cpu.cpu_debug->m_fdbg, "*LXA"); break;
+        fprintf(out, "*LXA"); break;
     case ORAb: case ORAz: case ORAzx: case ORAa: case ORAax: case ORAay:
     case ORAix: case ORAiy:
-        fprintf(cpu.cpu_debug->m_fdbg, " ORA"); break;
+        fprintf(out, " ORA"); break;
     case PHAn:
-        fprintf(cpu.cpu_debug->m_fdbg, " PHA"); break;
+        fprintf(out, " PHA"); break;
     case PHPn:
-        fprintf(cpu.cpu_debug->m_fdbg, " PHP"); break;
+        fprintf(out, " PHP"); break;
     case PLAn:
-        fprintf(cpu.cpu_debug->m_fdbg, " PLA"); break;
+        fprintf(out, " PLA"); break;
     case PLPn:
-        fprintf(cpu.cpu_debug->m_fdbg, " PLP"); break;
+        fprintf(out, " PLP"); break;
     case RLAz: case RLAzx: case RLAix: case RLAa: case RLAax: case RLAay:
     case RLAiy:
-        fprintf(cpu.cpu_debug->m_fdbg, "*RLA"); break;
+        fprintf(out, "*RLA"); break;
     case ROLz: case ROLzx: case ROLa: case ROLax: case ROLn:
-        fprintf(cpu.cpu_debug->m_fdbg, " ROL"); break;
+        fprintf(out, " ROL"); break;
     case RORz: case RORzx: case RORa: case RORax: case RORn:
-        fprintf(cpu.cpu_debug->m_fdbg, " ROR"); break;
+        fprintf(out, " ROR"); break;
     case RRAa: case RRAax: case RRAay: case RRAz: case RRAzx: case RRAix:
     case RRAiy:
-        fprintf(cpu.cpu_debug->m_fdbg, "*RRA"); break;
+        fprintf(out, "*RRA"); break;
     case RTIn:
-        fprintf(cpu.cpu_debug->m_fdbg, " RTI"); break;
+        fprintf(out, " RTI"); break;
     case RTSn:
-        fprintf(cpu.cpu_debug->m_fdbg, " RTS"); break;
+        fprintf(out, " RTS"); break;
     case SAXz: case SAXzy: case SAXa: case SAXix: // Also known as AXS
-        fprintf(cpu.cpu_debug->m_fdbg, "*SAX"); break;
+        fprintf(out, "*SAX"); break;
     case SBCb_:
-        if(opcode != SBCb) fprintf(cpu.cpu_debug->m_fdbg, "*");
-        else fprintf(cpu.cpu_debug->m_fdbg, " ");
-        fprintf(cpu.cpu_debug->m_fdbg, "SBC"); break;
+        if(opcode != SBCb) fprintf(out, "*");
+        else fprintf(out, " ");
+        fprintf(out, "SBC"); break;
     case SBCz: case SBCzx: case SBCa: case SBCax: case SBCay: case SBCix:
     case SBCiy:
-        fprintf(cpu.cpu_debug->m_fdbg, " SBC"); break;
+        fprintf(out, " SBC"); break;
     case SBXb:
-        fprintf(cpu.cpu_debug->m_fdbg, "*SBX"); break;
+        fprintf(out, "*SBX"); break;
     case SECn:
-        fprintf(cpu.cpu_debug->m_fdbg, " SEC"); break;
+        fprintf(out, " SEC"); break;
     case SEDn:
-        fprintf(cpu.cpu_debug->m_fdbg, " SED"); break;
+        fprintf(out, " SED"); break;
     case SEIn:
-        fprintf(cpu.cpu_debug->m_fdbg, " SEI"); break;
+        fprintf(out, " SEI"); break;
     case SHAay: case SHAiy: // Also known as AXA
-        fprintf(cpu.cpu_debug->m_fdbg, "*SHA"); break;
+        fprintf(out, "*SHA"); break;
     case SHSay: // Also known as TAS
-        fprintf(cpu.cpu_debug->m_fdbg, "*SHS"); break;
+        fprintf(out, "*SHS"); break;
     case SHXay: // Also known as XAS
-        fprintf(cpu.cpu_debug->m_fdbg, "*SHX"); break;
+        fprintf(out, "*SHX"); break;
     case SHYax: // Also known as SAY
-        fprintf(cpu.cpu_debug->m_fdbg, "*SHY"); break;
+        fprintf(out, "*SHY"); break;
     case SLOz: case SLOzx: case SLOa: case SLOax: case SLOay: case SLOix:
     case SLOiy: // Also known as ASO
-        fprintf(cpu.cpu_debug->m_fdbg, "*SLO"); break;
+        fprintf(out, "*SLO"); break;
     case SREz: case SREzx: case SREa: case SREax: case SREay: case SREix:
     case SREiy: // Also known as LSE
-        fprintf(cpu.cpu_debug->m_fdbg, "*SRE"); break;
+        fprintf(out, "*SRE"); break;
     case STAz: case STAzx: case STAa: case STAax: case STAay: case STAix:
     case STAiy:
-        fprintf(cpu.cpu_debug->m_fdbg, " STA"); break;
+        fprintf(out, " STA"); break;
     case STXz: case STXzy: case STXa:
-        fprintf(cpu.cpu_debug->m_fdbg, " STX"); break;
+        fprintf(out, " STX"); break;
     case STYz: case STYzx: case STYa:
-        fprintf(cpu.cpu_debug->m_fdbg, " STY"); break;
+        fprintf(out, " STY"); break;
     case TAXn:
-        fprintf(cpu.cpu_debug->m_fdbg, " TAX"); break;
+        fprintf(out, " TAX"); break;
     case TAYn:
-        fprintf(cpu.cpu_debug->m_fdbg, " TAY"); break;
+        fprintf(out, " TAY"); break;
     case TSXn:
-        fprintf(cpu.cpu_debug->m_fdbg, " TSX"); break;
+        fprintf(out, " TSX"); break;
     case TXAn:
-        fprintf(cpu.cpu_debug->m_fdbg, " TXA"); break;
+        fprintf(out, " TXA"); break;
     case TXSn:
-        fprintf(cpu.cpu_debug->m_fdbg, " TXS"); break;
+        fprintf(out, " TXS"); break;
     case TYAn:
-        fprintf(cpu.cpu_debug->m_fdbg, " TYA"); break;
+        fprintf(out, " TYA"); break;
     default:
-        fprintf(cpu.cpu_debug->m_fdbg, "*HLT"); break;
+        fprintf(out, "*HLT"); break;
     }
 
     switch(opcode)
     {
     // Accumulator or Implied cpu.Cycle_EffectiveAddressing
     case ASLn: case LSRn: case ROLn: case RORn:
-        fprintf(cpu.cpu_debug->m_fdbg, "n  A");
+        fprintf(out, "n  A");
         break;
 
     // Zero Page Addressing Mode Handler
@@ -334,11 +377,11 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case ROLz: case RORz: case SBCz: case SREz: case SLOz: case RLAz:
     case RRAz:
     // ASOz AXSz DCMz INSz LSEz - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "z  %02x {%02x}", endian_16lo8(cpu.cpu_debug->instrOperand), cpu.Cycle_Data);
+        fprintf(out, "z  %02x {%02x}", endian_16lo8(record.operand), record.data);
         break;
     case SAXz: case STAz: case STXz: case STYz:
     case NOPz_:
-        fprintf(cpu.cpu_debug->m_fdbg, "z  %02x", endian_16lo8(cpu.cpu_debug->instrOperand));
+        fprintf(out, "z  %02x", endian_16lo8(record.operand));
         break;
 
     // Zero Page with X Offset Addressing Mode Handler
@@ -347,24 +390,24 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case ORAzx: case RLAzx: case ROLzx: case RORzx: case RRAzx: case SBCzx:
     case SLOzx: case SREzx:
     // ASOzx DCMzx INSzx LSEzx - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "zx %02x,X", endian_16lo8(cpu.cpu_debug->instrOperand));
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]{%02x}", cpu.Cycle_EffectiveAddress, cpu.Cycle_Data);
+        fprintf(out, "zx %02x,X", endian_16lo8(record.operand));
+        fprintf(out, " [%04x]{%02x}", record.effectiveAddress, record.data);
         break;
     case STAzx: case STYzx:
     case NOPzx_:
-        fprintf(cpu.cpu_debug->m_fdbg, "zx %02x,X", endian_16lo8(cpu.cpu_debug->instrOperand));
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "zx %02x,X", endian_16lo8(record.operand));
+        fprintf(out, " [%04x]", record.effectiveAddress);
         break;
 
     // Zero Page with Y Offset Addressing Mode Handler
     case LAXzy: case LDXzy:
     // AXSzx - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "zy %02x,Y", endian_16lo8(cpu.cpu_debug->instrOperand));
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]{%02x}", cpu.Cycle_EffectiveAddress, cpu.Cycle_Data);
+        fprintf(out, "zy %02x,Y", endian_16lo8(record.operand));
+        fprintf(out, " [%04x]{%02x}", record.effectiveAddress, record.data);
         break;
     case STXzy: case SAXzy:
-        fprintf(cpu.cpu_debug->m_fdbg, "zy %02x,Y", endian_16lo8(cpu.cpu_debug->instrOperand));
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "zy %02x,Y", endian_16lo8(record.operand));
+        fprintf(out, " [%04x]", record.effectiveAddress);
         break;
 
     // Absolute Addressing Mode Handler
@@ -374,14 +417,14 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case ROLa: case RORa: case SBCa: case SLOa: case SREa: case RLAa:
     case RRAa:
     // ASOa AXSa DCMa INSa LSEa - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "a  %04x {%02x}", cpu.cpu_debug->instrOperand, cpu.Cycle_Data);
+        fprintf(out, "a  %04x {%02x}", record.operand, record.data);
         break;
     case SAXa: case STAa: case STXa: case STYa:
     case NOPa:
-        fprintf(cpu.cpu_debug->m_fdbg, "a  %04x", cpu.cpu_debug->instrOperand);
+        fprintf(out, "a  %04x", record.operand);
         break;
     case JMPw: case JSRw:
-        fprintf(cpu.cpu_debug->m_fdbg, "w  %04x", cpu.cpu_debug->instrOperand);
+        fprintf(out, "w  %04x", record.operand);
         break;
 
     // Absolute With X Offset Addresing Mode Handler
@@ -390,13 +433,13 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case ORAax: case RLAax: case ROLax: case RORax: case RRAax: case SBCax:
     case SLOax: case SREax:
     // ASOax DCMax INSax LSEax SAYax - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "ax %04x,X", cpu.cpu_debug->instrOperand);
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]{%02x}", cpu.Cycle_EffectiveAddress, cpu.Cycle_Data);
+        fprintf(out, "ax %04x,X", record.operand);
+        fprintf(out, " [%04x]{%02x}", record.effectiveAddress, record.data);
         break;
     case SHYax: case STAax:
     case NOPax_:
-        fprintf(cpu.cpu_debug->m_fdbg, "ax %04x,X", cpu.cpu_debug->instrOperand);
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "ax %04x,X", record.operand);
+        fprintf(out, " [%04x]", record.effectiveAddress);
         break;
 
     // Absolute With Y Offset Addresing Mode Handler
@@ -404,12 +447,12 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case LASay: case LAXay: case LDAay: case LDXay: case ORAay: case RLAay:
     case RRAay: case SBCay: case SHSay: case SLOay: case SREay:
     // ASOay AXAay DCMay INSax LSEay TASay XASay - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "ay %04x,Y", cpu.cpu_debug->instrOperand);
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]{%02x}", cpu.Cycle_EffectiveAddress, cpu.Cycle_Data);
+        fprintf(out, "ay %04x,Y", record.operand);
+        fprintf(out, " [%04x]{%02x}", record.effectiveAddress, record.data);
         break;
     case SHAay: case SHXay: case STAay:
-        fprintf(cpu.cpu_debug->m_fdbg, "ay %04x,Y", cpu.cpu_debug->instrOperand);
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "ay %04x,Y", record.operand);
+        fprintf(out, " [%04x]", record.effectiveAddress);
         break;
 
     // Immediate Addressing Mode Handler
@@ -418,20 +461,20 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case LDYb: case LXAb: case ORAb: case SBCb_: case SBXb:
     // OALb ALRb XAAb - Optional Opcode Names
     case NOPb_:
-        fprintf(cpu.cpu_debug->m_fdbg, "b  #%02x", endian_16lo8(cpu.cpu_debug->instrOperand));
+        fprintf(out, "b  #%02x", endian_16lo8(record.operand));
         break;
 
     // Relative Addressing Mode Handler
     case BCCr: case BCSr: case BEQr: case BMIr: case BNEr: case BPLr:
     case BVCr: case BVSr:
-        fprintf(cpu.cpu_debug->m_fdbg, "r  #%02x", endian_16lo8(cpu.cpu_debug->instrOperand));
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "r  #%02x", endian_16lo8(record.operand));
+        fprintf(out, " [%04x]", record.effectiveAddress);
         break;
 
     // Indirect Addressing Mode Handler
     case JMPi:
-        fprintf(cpu.cpu_debug->m_fdbg, "i  (%04x)", cpu.cpu_debug->instrOperand);
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "i  (%04x)", record.operand);
+        fprintf(out, " [%04x]", record.effectiveAddress);
         break;
 
     // Indexed with X Preinc Addressing Mode Handler
@@ -439,12 +482,12 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case LAXix: case LDAix: case ORAix: case SBCix: case SLOix: case SREix:
     case RLAix: case RRAix:
     // ASOix AXSix DCMix INSix LSEix - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "ix (%02x,X)", endian_16lo8(cpu.cpu_debug->instrOperand));
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]{%02x}", cpu.Cycle_EffectiveAddress, cpu.Cycle_Data);
+        fprintf(out, "ix (%02x,X)", endian_16lo8(record.operand));
+        fprintf(out, " [%04x]{%02x}", record.effectiveAddress, record.data);
         break;
     case SAXix: case STAix:
-        fprintf(cpu.cpu_debug->m_fdbg, "ix (%02x,X)", endian_16lo8(cpu.cpu_debug->instrOperand));
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "ix (%02x,X)", endian_16lo8(record.operand));
+        fprintf(out, " [%04x]", record.effectiveAddress);
         break;
 
     // Indexed with Y Postinc Addressing Mode Handler
@@ -452,20 +495,26 @@ void MOS6510Debug::DumpState (event_clock_t time, MOS6510 &cpu)
     case LAXiy: case LDAiy: case ORAiy: case RLAiy: case RRAiy: case SBCiy:
     case SLOiy: case SREiy:
     // AXAiy ASOiy LSEiy DCMiy INSiy - Optional Opcode Names
-        fprintf(cpu.cpu_debug->m_fdbg, "iy (%02x),Y", endian_16lo8(cpu.cpu_debug->instrOperand));
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]{%02x}", cpu.Cycle_EffectiveAddress, cpu.Cycle_Data);
+        fprintf(out, "iy (%02x),Y", endian_16lo8(record.operand));
+        fprintf(out, " [%04x]{%02x}", record.effectiveAddress, record.data);
         break;
     case SHAiy: case STAiy:
-        fprintf(cpu.cpu_debug->m_fdbg, "iy (%02x),Y", endian_16lo8(cpu.cpu_debug->instrOperand));
-        fprintf(cpu.cpu_debug->m_fdbg, " [%04x]", cpu.Cycle_EffectiveAddress);
+        fprintf(out, "iy (%02x),Y", endian_16lo8(record.operand));
+        fprintf(out, " [%04x]", record.effectiveAddress);
         break;
 
     default:
         break;
     }
 
-    fprintf(cpu.cpu_debug->m_fdbg, "\n\n");
-    fflush(cpu.cpu_debug->m_fdbg);
+    fprintf(out, "\n\n");
+
+    if (record.type == INTERRUPT)
+    {
+        fprintf(out, "****************************************************\n");
+        fprintf(out, " interrupt (%d)\n", static_cast<int>(record.time));
+        fprintf(out, "****************************************************\n");
+    }
 }
 
 }
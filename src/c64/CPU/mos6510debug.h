@@ -1,7 +1,7 @@
 /*
  * This file is part of libsidplayfp, a SID player engine.
  *
- * Copyright 2011-2015 Leandro Nini <drfiemost@users.sourceforge.net>
+ * Copyright 2011-2026 Leandro Nini <drfiemost@users.sourceforge.net>
  * Copyright 2007-2010 Antti Lankila
  * Copyright 2000 Simon White
  *
@@ -27,6 +27,9 @@
 #  include "config.h"
 #endif
 
+#include <cstdint>
+#include <cstdio>
+
 #include "Event.h"
 
 namespace libsidplayfp
@@ -36,7 +39,45 @@ class MOS6510;
 
 namespace MOS6510Debug
 {
-    void DumpState(event_clock_t time, MOS6510 &cpu);
+    enum record_t : uint8_t
+    {
+        INSTRUCTION, ///< CPU state after an instruction
+        INTERRUPT,   ///< CPU state before entering an interrupt
+        RTI          ///< end of interrupt marker, no state
+    };
+
+    /**
+     * Binary trace record, stored in native byte order.
+     */
+    struct Record
+    {
+        int64_t time;
+        uint16_t pc;
+        uint16_t operand;
+        uint16_t effectiveAddress;
+        uint8_t opcode;
+        uint8_t a;
+        uint8_t x;
+        uint8_t y;
+        uint8_t sp;
+        uint8_t port0;
+        uint8_t port1;
+        /// NV-BDIZC, bit 5 holds the IRQ pin state
+        uint8_t flags;
+        uint8_t data;
+        uint8_t type;
+    };
+
+    /**
+     * Record the CPU state either to the trace buffer
+     * or to the debug file in text format.
+     */
+    void DumpState(event_clock_t time, MOS6510 &cpu, record_t type);
+
+    /**
+     * Print a record in text format.
+     */
+    void Decode(const Record &record, FILE *out);
 }
 
 }
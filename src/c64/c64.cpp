@@ -25,6 +25,10 @@
 #include "c64/CIA/mos652x.h"
 #include "c64/VIC_II/mos656x.h"
 
+#ifdef ENABLE_STATS
+#  include <cstring>
+#endif
+
 namespace libsidplayfp
 {
 
@@ -204,4 +208,77 @@ void c64::clearSids()
     deleteSids(extraSidBanks);
 }
 
+#ifdef ENABLE_STATS
+/**
+ * Map the event names to the emulated chips.
+ */
+static SidStats::subsystem_t getSubsystem(const char* name)
+{
+    static const struct
+    {
+        const char* prefix;
+        SidStats::subsystem_t subsystem;
+    } subsystems[] =
+    {
+        {"CPU",              SidStats::CPU},
+        {"Remove IRQ",       SidStats::CPU},
+        {"VIC",              SidStats::VIC},
+        {"Update AEC",       SidStats::VIC},
+        {"RasterY",          SidStats::VIC},
+        {"Trigger lightpen", SidStats::VIC},
+        {"CIA",              SidStats::CIA},
+        {"Skip CIA",         SidStats::CIA},
+        {"Serial Port",      SidStats::CIA},
+        {"flip ",            SidStats::CIA},
+        {"start SDR",        SidStats::CIA},
+    };
+
+    for (const auto &s: subsystems)
+    {
+        if (std::strncmp(name, s.prefix, std::strlen(s.prefix)) == 0)
+            return s.subsystem;
+    }
+
+    return SidStats::OTHER;
+}
+
+void c64::getStats(SidStats &stats) const
+{
+    stats.cpuCycles = cpu.executedCycles();
+    stats.stolenCycles = cpu.stolenCycles();
+
+    stats.eventTypes = 0;
+    for (unsigned int i = 0; i < eventScheduler.eventTypes(); i++)
+    {
+        const EventScheduler::EventStats &eventStats = eventScheduler.eventStats(i);
+
+        // The same name may show up from different translation units
+        unsigned int j = 0;
+        while ((j < stats.eventTypes) && std::strcmp(stats.events[j].name, eventStats.name))
+            j++;
+
+        if (j == stats.eventTypes)
+        {
+            if (j == SidStats::MAX_EVENT_TYPES)
+                break;
+
+            stats.events[j].name = eventStats.name;
+            stats.events[j].subsystem = getSubsystem(eventStats.name);
+            stats.events[j].count = 0;
+            stats.events[j].nanoseconds = 0;
+            stats.eventTypes++;
+        }
+
+        stats.events[j].count += eventStats.count;
+        stats.events[j].nanoseconds += eventStats.nanoseconds;
+    }
+}
+
+void c64::resetStats()
+{
+    cpu.resetStats();
+    eventScheduler.resetStats();
+}
+#endif
+
 }
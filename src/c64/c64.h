@@ -48,6 +48,10 @@
 #  include "config.h"
 #endif
 
+#ifdef ENABLE_STATS
+#  include "sidplayfp/SidStats.h"
+#endif
+
 namespace libsidplayfp
 {
 
@@ -198,13 +202,36 @@ public:
 
     /**
      * Clock the emulation.
-     *
-     * @throws haltInstruction
+     * Check #halted() for a CPU lockup.
      */
     void clock() { eventScheduler.clock(); }
 
+    /**
+     * Get and clear the reason the emulation halted.
+     *
+     * @return the reason or nullptr if still running
+     */
+    const char *halted()
+    {
+#ifdef VICE_TESTSUITE
+        if (const char *result = cpubus.result())
+            return result;
+#endif
+        return cpu.halted();
+    }
+
     void debug(bool enable, FILE *out) { cpu.debug(enable, out); }
 
+    void trace(bool enable, unsigned int size) { cpu.trace(enable, size); }
+
+    unsigned int readTrace(MOS6510Debug::Record *records, unsigned int count) { return cpu.readTrace(records, count); }
+
+    unsigned int traceDropped() const { return cpu.traceDropped(); }
+
+    void profile(bool enable) { cpu.profile(enable); }
+
+    bool dumpProfile(FILE *out) const { return cpu.dumpProfile(out); }
+
     void reset();
     void resetCpu() { cpu.reset(); }
 
@@ -258,8 +285,28 @@ public:
     //@}
 
     sidmemory& getMemInterface() { return mmu; }
+    const sidmemory& getMemInterface() const { return mmu; }
+
+    /**
+     * Get a read-only view of the color RAM.
+     */
+    const uint8_t* getColorRam() const { return colorRAMBank.data(); }
 
     uint_least16_t getCia1TimerA() const { return cia1.getTimerA(); }
+
+#ifdef ENABLE_STATS
+    /**
+     * Fill in the CPU cycles and the dispatched events counters.
+     *
+     * @param stats the stats to update
+     */
+    void getStats(SidStats &stats) const;
+
+    /**
+     * Clear the CPU cycles and the dispatched events counters.
+     */
+    void resetStats();
+#endif
 };
 
 void c64::interruptIRQ(bool state)
@@ -30,7 +30,6 @@
 
 #ifdef VICE_TESTSUITE
 #  include <iostream>
-#  include <cstdlib>
 #endif
 
 //#define PRINTSCREENCODES
@@ -61,6 +60,11 @@ class c64cpubus final : public CPUDataBus
 private:
     MMU &m_mmu;
 
+#ifdef VICE_TESTSUITE
+    /// Test result, pending until retrieved
+    const char *m_result = nullptr;
+#endif
+
 protected:
     uint8_t cpuRead(uint_least16_t addr) override { return m_mmu.cpuRead(addr); }
 
@@ -83,18 +87,17 @@ protected:
             std::cout << CHRtab[chr];
         }
 #  endif
-        // for VICE tests
+        // for VICE tests, the result is reported
+        // through the play() error string
         if (addr == 0xd7ff)
         {
             if (data == 0)
             {
-                std::cout << std::endl << "\x1b[0;32m" << "OK" << std::endl;
-                exit(EXIT_SUCCESS);
+                m_result = "OK";
             }
             else if (data == 0xff)
             {
-                std::cout << std::endl << "\x1b[0;31m" << "KO" << std::endl;
-                exit(EXIT_FAILURE);
+                m_result = "KO";
             }
         }
 #endif
@@ -104,6 +107,18 @@ protected:
 public:
     explicit c64cpubus (MMU &mmu) :
         m_mmu(mmu) {}
+
+#ifdef VICE_TESTSUITE
+    /**
+     * Get and clear the pending test result.
+     */
+    const char *result()
+    {
+        const char *res = m_result;
+        m_result = nullptr;
+        return res;
+    }
+#endif
 };
 
 }
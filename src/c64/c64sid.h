@@ -41,6 +41,11 @@ class c64sid : public Bank
 private:
     uint8_t lastpoke[0x20];
 
+#ifdef ENABLE_STATS
+    uint_least64_t m_writes = 0;
+    uint_least64_t m_reads = 0;
+#endif
+
 protected:
     virtual ~c64sid() = default;
 
@@ -59,12 +64,27 @@ public:
     // Bank functions
     void poke(uint_least16_t address, uint8_t value) override
     {
+#ifdef ENABLE_STATS
+        m_writes++;
+#endif
         lastpoke[address & 0x1f] = value;
         writeReg(address & 0x1f, value);
     }
-    uint8_t peek(uint_least16_t address) override { return read(address & 0x1f); }
+    uint8_t peek(uint_least16_t address) override
+    {
+#ifdef ENABLE_STATS
+        m_reads++;
+#endif
+        return read(address & 0x1f);
+    }
 
     void getStatus(uint8_t regs[0x20]) const { std::memcpy(regs, lastpoke, 0x20); }
+
+#ifdef ENABLE_STATS
+    uint_least64_t writes() const { return m_writes; }
+    uint_least64_t reads() const { return m_reads; }
+    void resetStats() { m_writes = m_reads = 0; }
+#endif
 };
 
 }
@@ -96,6 +96,9 @@ void MMU::reset()
     hiram = false;
     charen = false;
 
+    // Make the emulation reproducible
+    seed = SEED;
+
     updateMappingPHI2();
 }
 
@@ -86,7 +86,8 @@ private:
     ZeroRAMBank zeroRAMBank;
 
     /// random seed
-    mutable unsigned int seed = 3686734;
+    static constexpr unsigned int SEED = 3686734;
+    mutable unsigned int seed = SEED;
 
 private:
     void setCpuPort(uint8_t state) override;
@@ -110,17 +111,30 @@ public:
     uint_least16_t readMemWord(uint_least16_t addr) override { return endian_little16(ramBank.ram+addr); }
 
     void writeMemByte(uint_least16_t addr, uint8_t value) override { ramBank.poke(addr, value); }
-    void writeMemWord(uint_least16_t addr, uint_least16_t value) override { endian_little16(ramBank.ram+addr, value); }
+    void writeMemWord(uint_least16_t addr, uint_least16_t value) override
+    {
+        endian_little16(ramBank.ram+addr, value);
+        ramBank.markDirty(addr, 2);
+    }
 
     void fillRam(uint_least16_t start, uint8_t value, unsigned int size) override
     {
         std::memset(ramBank.ram+start, value, size);
+        ramBank.markDirty(start, size);
     }
     void fillRam(uint_least16_t start, const uint8_t* source, unsigned int size) override
     {
         std::memcpy(ramBank.ram+start, source, size);
+        ramBank.markDirty(start, size);
     }
 
+    // RAM views
+    const uint8_t* getRam() const override { return ramBank.data(); }
+
+    void trackDirtyPages(bool enable) override { ramBank.trackDirtyPages(enable); }
+
+    unsigned int getDirtyPages(uint8_t* bitmap) override { return ramBank.getDirtyPages(bitmap); }
+
     // SID specific hacks
     void installResetHook(uint_least16_t addr) override { kernalRomBank.installResetHook(addr); }
 
@@ -0,0 +1,318 @@
+#ifndef HASHLIB_ALL_IN_ONE
+#pragma once
+#include "core.hpp"
+#include <vector>
+#endif
+
+// Multi-buffer md5: independent messages are hashed in parallel
+// SIMD lanes, the widest instruction set enabled at compile time
+// is used, with a scalar fallback.
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define HASHLIB_MD5_LANES 16
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define HASHLIB_MD5_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HASHLIB_MD5_LANES 4
+#else
+#define HASHLIB_MD5_LANES 1
+#endif
+
+namespace hashlib {
+    /**
+     * A message for md5_multi, the suffix is hashed right after the data
+     * and may be empty.
+     */
+    HASHLIB_MOD_EXPORT struct md5_message {
+        const byte* data;
+        std::size_t size;
+        const byte* suffix;
+        std::size_t suffix_size;
+    };
+
+    namespace detail {
+        struct md5_lanes_scalar {
+            using type = std::uint32_t;
+            static constexpr std::size_t lanes = 1;
+            static auto load(const std::uint32_t* p) noexcept -> type { return *p; }
+            static auto store(std::uint32_t* p, type v) noexcept -> void { *p = v; }
+            static auto set1(std::uint32_t v) noexcept -> type { return v; }
+            static auto add(type a, type b) noexcept -> type { return a + b; }
+            static auto and_(type a, type b) noexcept -> type { return a & b; }
+            static auto or_(type a, type b) noexcept -> type { return a | b; }
+            static auto xor_(type a, type b) noexcept -> type { return a ^ b; }
+            static auto andnot(type a, type b) noexcept -> type { return ~a & b; }
+            template<int N>
+            static auto rotl(type a) noexcept -> type { return (a << N) | (a >> (32 - N)); }
+        };
+
+#if HASHLIB_MD5_LANES == 4
+        struct md5_lanes_simd {
+            using type = __m128i;
+            static constexpr std::size_t lanes = 4;
+            static auto load(const std::uint32_t* p) noexcept -> type { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+            static auto store(std::uint32_t* p, type v) noexcept -> void { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+            static auto set1(std::uint32_t v) noexcept -> type { return _mm_set1_epi32(static_cast<int>(v)); }
+            static auto add(type a, type b) noexcept -> type { return _mm_add_epi32(a, b); }
+            static auto and_(type a, type b) noexcept -> type { return _mm_and_si128(a, b); }
+            static auto or_(type a, type b) noexcept -> type { return _mm_or_si128(a, b); }
+            static auto xor_(type a, type b) noexcept -> type { return _mm_xor_si128(a, b); }
+            static auto andnot(type a, type b) noexcept -> type { return _mm_andnot_si128(a, b); }
+            template<int N>
+            static auto rotl(type a) noexcept -> type { return _mm_or_si128(_mm_slli_epi32(a, N), _mm_srli_epi32(a, 32 - N)); }
+        };
+#elif HASHLIB_MD5_LANES == 8
+        struct md5_lanes_simd {
+            using type = __m256i;
+            static constexpr std::size_t lanes = 8;
+            static auto load(const std::uint32_t* p) noexcept -> type { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+            static auto store(std::uint32_t* p, type v) noexcept -> void { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+            static auto set1(std::uint32_t v) noexcept -> type { return _mm256_set1_epi32(static_cast<int>(v)); }
+            static auto add(type a, type b) noexcept -> type { return _mm256_add_epi32(a, b); }
+            static auto and_(type a, type b) noexcept -> type { return _mm256_and_si256(a, b); }
+            static auto or_(type a, type b) noexcept -> type { return _mm256_or_si256(a, b); }
+            static auto xor_(type a, type b) noexcept -> type { return _mm256_xor_si256(a, b); }
+            static auto andnot(type a, type b) noexcept -> type { return _mm256_andnot_si256(a, b); }
+            template<int N>
+            static auto rotl(type a) noexcept -> type { return _mm256_or_si256(_mm256_slli_epi32(a, N), _mm256_srli_epi32(a, 32 - N)); }
+        };
+#elif HASHLIB_MD5_LANES == 16
+        struct md5_lanes_simd {
+            using type = __m512i;
+            static constexpr std::size_t lanes = 16;
+            static auto load(const std::uint32_t* p) noexcept -> type { return _mm512_loadu_si512(p); }
+            static auto store(std::uint32_t* p, type v) noexcept -> void { _mm512_storeu_si512(p, v); }
+            static auto set1(std::uint32_t v) noexcept -> type { return _mm512_set1_epi32(static_cast<int>(v)); }
+            static auto add(type a, type b) noexcept -> type { return _mm512_add_epi32(a, b); }
+            static auto and_(type a, type b) noexcept -> type { return _mm512_and_si512(a, b); }
+            static auto or_(type a, type b) noexcept -> type { return _mm512_or_si512(a, b); }
+            static auto xor_(type a, type b) noexcept -> type { return _mm512_xor_si512(a, b); }
+            static auto andnot(type a, type b) noexcept -> type { return _mm512_andnot_si512(a, b); }
+            template<int N>
+            static auto rotl(type a) noexcept -> type { return _mm512_rol_epi32(a, N); }
+        };
+#else
+        using md5_lanes_simd = md5_lanes_scalar;
+#endif
+
+        template<typename V>
+        class md5_multi {
+            using vec = typename V::type;
+            static constexpr std::size_t L = V::lanes;
+
+        public:
+            static auto hash(const md5_message* messages, std::size_t count, std::array<byte, 16>* digests) -> void {
+                // group messages of similar length so the lanes finish together
+                std::vector<std::size_t> order(count);
+                for (std::size_t i = 0; i < count; ++i) order[i] = i;
+                std::stable_sort(order.begin(), order.end(), [messages](std::size_t x, std::size_t y) {
+                    return total_(messages[x]) < total_(messages[y]);
+                });
+
+                for (std::size_t first = 0; first < count; first += L) {
+                    hash_group_(messages, order.data() + first, std::min(L, count - first), digests);
+                }
+            }
+
+        private:
+            static auto total_(const md5_message& m) noexcept -> std::uint64_t {
+                return std::uint64_t(m.size) + m.suffix_size;
+            }
+
+            static auto blocks_(const md5_message& m) noexcept -> std::uint64_t {
+                return (total_(m) + 8) / 64 + 1;
+            }
+
+            static auto load_le_(const byte* p) noexcept -> std::uint32_t {
+                return std::uint32_t(p[0]) | (std::uint32_t(p[1]) << 8) |
+                       (std::uint32_t(p[2]) << 16) | (std::uint32_t(p[3]) << 24);
+            }
+
+            /// Get the block, building it in scratch when it holds suffix or padding
+            static auto block_(const md5_message& m, std::uint64_t index, byte* scratch) noexcept -> const byte* {
+                const std::uint64_t offset = index * 64;
+                if (offset + 64 <= m.size) return m.data + offset;
+
+                const std::uint64_t total = total_(m);
+                std::size_t n = 0;
+                if (offset < m.size) {
+                    n = static_cast<std::size_t>(m.size - offset);
+                    std::memcpy(scratch, m.data + offset, n);
+                }
+                std::uint64_t pos = offset + n;
+                if (n < 64 && pos < total) {
+                    const std::size_t c = static_cast<std::size_t>(std::min<std::uint64_t>(total - pos, 64 - n));
+                    std::memcpy(scratch + n, m.suffix + (pos - m.size), c);
+                    n += c;
+                    pos += c;
+                }
+                if (n < 64) {
+                    std::memset(scratch + n, 0, 64 - n);
+                    if (pos == total) scratch[n] = 0x80;
+                }
+                if (index == blocks_(m) - 1) {
+                    const std::uint64_t bits = total * 8;
+                    for (std::size_t i = 0; i < 8; ++i) scratch[56 + i] = static_cast<byte>(bits >> (8 * i));
+                }
+                return scratch;
+            }
+
+            static auto hash_group_(const md5_message* messages, const std::size_t* index, std::size_t lanes,
+                                    std::array<byte, 16>* digests) -> void {
+                std::uint32_t state[4][L];
+                std::uint64_t blocks[L];
+                std::uint64_t max_blocks = 0;
+                for (std::size_t l = 0; l < L; ++l) {
+                    state[0][l] = 0x67452301;
+                    state[1][l] = 0xefcdab89;
+                    state[2][l] = 0x98badcfe;
+                    state[3][l] = 0x10325476;
+                    blocks[l] = l < lanes ? blocks_(messages[index[l]]) : 0;
+                    max_blocks = std::max(max_blocks, blocks[l]);
+                }
+
+                byte scratch[L][64]{};
+                std::uint32_t words[16][L];
+                std::uint32_t result[4][L];
+                for (std::uint64_t b = 0; b < max_blocks; ++b) {
+                    // transpose the blocks, word j of each lane side by side
+                    for (std::size_t l = 0; l < L; ++l) {
+                        const byte* p = b < blocks[l] ? block_(messages[index[l]], b, scratch[l]) : scratch[l];
+                        for (std::size_t j = 0; j < 16; ++j) words[j][l] = load_le_(p + j * 4);
+                    }
+
+                    vec w[16];
+                    for (std::size_t j = 0; j < 16; ++j) w[j] = V::load(words[j]);
+                    vec s[4];
+                    for (std::size_t i = 0; i < 4; ++i) s[i] = V::load(state[i]);
+                    compress_(s, w);
+                    for (std::size_t i = 0; i < 4; ++i) V::store(result[i], s[i]);
+
+                    // finished lanes keep their state
+                    for (std::size_t l = 0; l < L; ++l) {
+                        if (b < blocks[l]) {
+                            for (std::size_t i = 0; i < 4; ++i) state[i][l] = result[i][l];
+                        }
+                    }
+                }
+
+                for (std::size_t l = 0; l < lanes; ++l) {
+                    byte* digest = digests[index[l]].data();
+                    for (std::size_t i = 0; i < 4; ++i) {
+                        for (std::size_t k = 0; k < 4; ++k) digest[i * 4 + k] = static_cast<byte>(state[i][l] >> (8 * k));
+                    }
+                }
+            }
+
+            HASHLIB_ALWAYS_INLINE
+            static auto f_(vec b, vec c, vec d) noexcept -> vec { return V::or_(V::and_(b, c), V::andnot(b, d)); }
+            HASHLIB_ALWAYS_INLINE
+            static auto g_(vec b, vec c, vec d) noexcept -> vec { return V::or_(V::and_(d, b), V::andnot(d, c)); }
+            HASHLIB_ALWAYS_INLINE
+            static auto h_(vec b, vec c, vec d) noexcept -> vec { return V::xor_(V::xor_(b, c), d); }
+            HASHLIB_ALWAYS_INLINE
+            static auto i_(vec b, vec c, vec d) noexcept -> vec { return V::xor_(c, V::or_(b, V::xor_(d, V::set1(0xffffffff)))); }
+
+            template<int S>
+            HASHLIB_ALWAYS_INLINE
+            static auto step_(vec a, vec b, vec f, std::uint32_t k, vec w) noexcept -> vec {
+                return V::add(b, V::template rotl<S>(V::add(V::add(a, f), V::add(V::set1(k), w))));
+            }
+
+            static auto compress_(vec* s, const vec* w) noexcept -> void {
+                vec a = s[0], b = s[1], c = s[2], d = s[3];
+
+                a = step_<7>(a, b, f_(b, c, d), 0xd76aa478, w[0]);
+                d = step_<12>(d, a, f_(a, b, c), 0xe8c7b756, w[1]);
+                c = step_<17>(c, d, f_(d, a, b), 0x242070db, w[2]);
+                b = step_<22>(b, c, f_(c, d, a), 0xc1bdceee, w[3]);
+                a = step_<7>(a, b, f_(b, c, d), 0xf57c0faf, w[4]);
+                d = step_<12>(d, a, f_(a, b, c), 0x4787c62a, w[5]);
+                c = step_<17>(c, d, f_(d, a, b), 0xa8304613, w[6]);
+                b = step_<22>(b, c, f_(c, d, a), 0xfd469501, w[7]);
+                a = step_<7>(a, b, f_(b, c, d), 0x698098d8, w[8]);
+                d = step_<12>(d, a, f_(a, b, c), 0x8b44f7af, w[9]);
+                c = step_<17>(c, d, f_(d, a, b), 0xffff5bb1, w[10]);
+                b = step_<22>(b, c, f_(c, d, a), 0x895cd7be, w[11]);
+                a = step_<7>(a, b, f_(b, c, d), 0x6b901122, w[12]);
+                d = step_<12>(d, a, f_(a, b, c), 0xfd987193, w[13]);
+                c = step_<17>(c, d, f_(d, a, b), 0xa679438e, w[14]);
+                b = step_<22>(b, c, f_(c, d, a), 0x49b40821, w[15]);
+
+                a = step_<5>(a, b, g_(b, c, d), 0xf61e2562, w[1]);
+                d = step_<9>(d, a, g_(a, b, c), 0xc040b340, w[6]);
+                c = step_<14>(c, d, g_(d, a, b), 0x265e5a51, w[11]);
+                b = step_<20>(b, c, g_(c, d, a), 0xe9b6c7aa, w[0]);
+                a = step_<5>(a, b, g_(b, c, d), 0xd62f105d, w[5]);
+                d = step_<9>(d, a, g_(a, b, c), 0x02441453, w[10]);
+                c = step_<14>(c, d, g_(d, a, b), 0xd8a1e681, w[15]);
+                b = step_<20>(b, c, g_(c, d, a), 0xe7d3fbc8, w[4]);
+                a = step_<5>(a, b, g_(b, c, d), 0x21e1cde6, w[9]);
+                d = step_<9>(d, a, g_(a, b, c), 0xc33707d6, w[14]);
+                c = step_<14>(c, d, g_(d, a, b), 0xf4d50d87, w[3]);
+                b = step_<20>(b, c, g_(c, d, a), 0x455a14ed, w[8]);
+                a = step_<5>(a, b, g_(b, c, d), 0xa9e3e905, w[13]);
+                d = step_<9>(d, a, g_(a, b, c), 0xfcefa3f8, w[2]);
+                c = step_<14>(c, d, g_(d, a, b), 0x676f02d9, w[7]);
+                b = step_<20>(b, c, g_(c, d, a), 0x8d2a4c8a, w[12]);
+
+                a = step_<4>(a, b, h_(b, c, d), 0xfffa3942, w[5]);
+                d = step_<11>(d, a, h_(a, b, c), 0x8771f681, w[8]);
+                c = step_<16>(c, d, h_(d, a, b), 0x6d9d6122, w[11]);
+                b = step_<23>(b, c, h_(c, d, a), 0xfde5380c, w[14]);
+                a = step_<4>(a, b, h_(b, c, d), 0xa4beea44, w[1]);
+                d = step_<11>(d, a, h_(a, b, c), 0x4bdecfa9, w[4]);
+                c = step_<16>(c, d, h_(d, a, b), 0xf6bb4b60, w[7]);
+                b = step_<23>(b, c, h_(c, d, a), 0xbebfbc70, w[10]);
+                a = step_<4>(a, b, h_(b, c, d), 0x289b7ec6, w[13]);
+                d = step_<11>(d, a, h_(a, b, c), 0xeaa127fa, w[0]);
+                c = step_<16>(c, d, h_(d, a, b), 0xd4ef3085, w[3]);
+                b = step_<23>(b, c, h_(c, d, a), 0x04881d05, w[6]);
+                a = step_<4>(a, b, h_(b, c, d), 0xd9d4d039, w[9]);
+                d = step_<11>(d, a, h_(a, b, c), 0xe6db99e5, w[12]);
+                c = step_<16>(c, d, h_(d, a, b), 0x1fa27cf8, w[15]);
+                b = step_<23>(b, c, h_(c, d, a), 0xc4ac5665, w[2]);
+
+                a = step_<6>(a, b, i_(b, c, d), 0xf4292244, w[0]);
+                d = step_<10>(d, a, i_(a, b, c), 0x432aff97, w[7]);
+                c = step_<15>(c, d, i_(d, a, b), 0xab9423a7, w[14]);
+                b = step_<21>(b, c, i_(c, d, a), 0xfc93a039, w[5]);
+                a = step_<6>(a, b, i_(b, c, d), 0x655b59c3, w[12]);
+                d = step_<10>(d, a, i_(a, b, c), 0x8f0ccc92, w[3]);
+                c = step_<15>(c, d, i_(d, a, b), 0xffeff47d, w[10]);
+                b = step_<21>(b, c, i_(c, d, a), 0x85845dd1, w[1]);
+                a = step_<6>(a, b, i_(b, c, d), 0x6fa87e4f, w[8]);
+                d = step_<10>(d, a, i_(a, b, c), 0xfe2ce6e0, w[15]);
+                c = step_<15>(c, d, i_(d, a, b), 0xa3014314, w[6]);
+                b = step_<21>(b, c, i_(c, d, a), 0x4e0811a1, w[13]);
+                a = step_<6>(a, b, i_(b, c, d), 0xf7537e82, w[4]);
+                d = step_<10>(d, a, i_(a, b, c), 0xbd3af235, w[11]);
+                c = step_<15>(c, d, i_(d, a, b), 0x2ad7d2bb, w[2]);
+                b = step_<21>(b, c, i_(c, d, a), 0xeb86d391, w[9]);
+
+                s[0] = V::add(s[0], a);
+                s[1] = V::add(s[1], b);
+                s[2] = V::add(s[2], c);
+                s[3] = V::add(s[3], d);
+            }
+        };
+    }
+
+    /**
+     * Number of messages hashed in parallel.
+     */
+    HASHLIB_MOD_EXPORT constexpr auto md5_multi_lanes() noexcept -> std::size_t {
+        return HASHLIB_MD5_LANES;
+    }
+
+    /**
+     * Hash independent messages in parallel lanes,
+     * digests[i] gets the md5 of messages[i].
+     */
+    HASHLIB_MOD_EXPORT inline auto md5_multi(const md5_message* messages, std::size_t count,
+                                            std::array<byte, 16>* digests) -> void {
+        detail::md5_multi<detail::md5_lanes_simd>::hash(messages, count, digests);
+    }
+}
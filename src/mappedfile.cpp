@@ -0,0 +1,124 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "mappedfile.h"
+
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+#  define USE_MMAP
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+#include <new>
+
+namespace libsidplayfp
+{
+
+bool mappedFile::read(std::ifstream &file)
+{
+    if (file.fail())
+        return false;
+
+    file.seekg(0, std::ios::end);
+    const std::streamoff size = file.tellg();
+    if (size < 0)
+        return false;
+    file.seekg(0, std::ios::beg);
+
+    m_size = static_cast<size_t>(size);
+    m_buffer.reset(new (std::nothrow) uint8_t[m_size ? m_size : 1]);
+    if (!m_buffer)
+        return false;
+
+    if (!file.read(reinterpret_cast<char*>(m_buffer.get()), m_size))
+    {
+        close();
+        return false;
+    }
+
+    m_data = m_buffer.get();
+    return true;
+}
+
+bool mappedFile::open(const char *filename)
+{
+    close();
+
+#ifdef USE_MMAP
+    const int fd = ::open(filename, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || S_ISDIR(st.st_mode))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(st.st_size);
+    if (m_size == 0)
+    {
+        ::close(fd);
+        return true;
+    }
+
+    void *addr = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    // the mapping stays valid after closing the descriptor
+    ::close(fd);
+
+    if (addr != MAP_FAILED)
+    {
+        m_data = static_cast<const uint8_t*>(addr);
+        return true;
+    }
+
+    // not mappable, e.g. a pipe
+    m_size = 0;
+#endif
+
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    return read(file);
+}
+
+#ifdef _WIN32
+bool mappedFile::open(const wchar_t *filename)
+{
+    close();
+
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    return read(file);
+}
+#endif
+
+void mappedFile::close()
+{
+#ifdef USE_MMAP
+    if (m_data != nullptr && !m_buffer)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+    m_buffer.reset();
+    m_data = nullptr;
+    m_size = 0;
+}
+
+}
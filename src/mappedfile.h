@@ -0,0 +1,83 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+
+namespace libsidplayfp
+{
+
+/**
+ * Read-only view of a whole file.
+ *
+ * The file is memory mapped where supported so pages
+ * are shared and loaded on demand, otherwise it is
+ * read into memory.
+ */
+class mappedFile
+{
+private:
+    const uint8_t *m_data = nullptr;
+
+    size_t m_size = 0;
+
+    /// Used when the file can't be mapped
+    std::unique_ptr<uint8_t[]> m_buffer;
+
+private:
+    bool read(std::ifstream &file);
+
+public:
+    mappedFile() = default;
+    ~mappedFile() { close(); }
+
+    mappedFile(const mappedFile&) = delete;
+    mappedFile& operator=(const mappedFile&) = delete;
+
+    /**
+     * Open a file, closing the previous one.
+     *
+     * @param filename the file name
+     * @return false if the file can't be opened
+     */
+    bool open(const char *filename);
+#ifdef _WIN32
+    bool open(const wchar_t *filename);
+#endif
+
+    void close();
+
+    const uint8_t *data() const { return m_data; }
+
+    size_t size() const { return m_size; }
+};
+
+}
+
+#endif // MAPPEDFILE_H
@@ -29,11 +29,19 @@
 #include "sidemu.h"
 #include "psiddrv.h"
 #include "romCheck.h"
+#include "sidtune/SidTuneBase.h"
 
 #include "sidcxx11.h"
 
-#include <cmath>
+#include <algorithm>
+#include <cstring>
 #include <ctime>
+#include <utility>
+
+#ifdef ENABLE_STATS
+#  include <chrono>
+#  include <iterator>
+#endif
 
 namespace libsidplayfp
 {
@@ -51,15 +59,25 @@ const char TXT_NTSC_UNKNOWN[]   = "UNKNOWN (NTSC)";
 // Error Strings
 const char ERR_NA[]                   = "NA";
 const char ERR_NO_TUNE_LOADED[]       = "SIDPLAYER ERROR: No tune loaded";
+const char ERR_HEADER_ONLY[]          = "SIDPLAYER ERROR: Only the tune header was read, load the tune to play it";
 const char ERR_UNSUPPORTED_FREQ[]     = "SIDPLAYER ERROR: Unsupported sampling frequency.";
 const char ERR_UNSUPPORTED_SID_ADDR[] = "SIDPLAYER ERROR: Unsupported SID address.";
 const char ERR_UNSUPPORTED_SIZE[]     = "SIDPLAYER ERROR: Size of music data exceeds C64 memory.";
 const char ERR_INVALID_PERCENTAGE[]   = "SIDPLAYER ERROR: Percentage value out of range.";
 const char ERR_BAD_BUF_SIZE[]         = "SIDPLAYER ERROR: Bad buffer size";
 const char ERR_INVALID_CONF[]         = "SIDPLAYER ERROR: Invalid configuration";
+const char ERR_UNSUPPORTED_BLOCK[]    = "SIDPLAYER ERROR: Unsupported block size.";
+const char ERR_NO_MIXER[]             = "SIDPLAYER ERROR: Mixer not initialized";
 
-// Limit to roughly 20ms
-constexpr unsigned int MAX_CYCLES = 20000;
+// Room for the longest error message
+constexpr size_t ERROR_CAPACITY = 256;
+
+#ifdef ENABLE_STATS
+inline uint_least64_t elapsedNs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+#endif
 
 /**
  * Configuration error exception.
@@ -76,10 +94,12 @@ public:
 
 Player::Player() :
     // Set default settings for system
-    m_tune(nullptr),
     m_errorString(ERR_NA),
     m_rand((unsigned int)std::time(nullptr))
 {
+    // Error messages set from play() must fit without allocating
+    m_errorString.reserve(ERROR_CAPACITY);
+
     // We need at least some minimal interrupt handling
     m_c64.getMemInterface().setKernal(nullptr);
 
@@ -125,9 +145,7 @@ void Player::initialise()
 {
     m_c64.reset();
 
-    const SidTuneInfo* tuneInfo = m_tune->getInfo();
-
-    const uint_least32_t size = static_cast<uint_least32_t>(tuneInfo->loadAddr()) + tuneInfo->c64dataLen() - 1;
+    const uint_least32_t size = static_cast<uint_least32_t>(m_tuneInfo.loadAddr()) + m_tuneInfo.c64dataLen() - 1;
     if (size > 0xffff) UNLIKELY
     {
         throw configError(ERR_UNSUPPORTED_SIZE);
@@ -155,7 +173,7 @@ void Player::initialise()
         }
     }
 
-    psiddrv driver(m_tune->getInfo());
+    psiddrv driver(&m_tuneInfo);
     if (!driver.drvReloc()) UNLIKELY
     {
         throw configError(driver.errorString());
@@ -169,7 +187,7 @@ void Player::initialise()
 
     if (!m_tune->placeSidTuneInC64mem(m_c64.getMemInterface())) UNLIKELY
     {
-        throw configError(m_tune->statusString());
+        throw configError(ERR_HEADER_ONLY);
     }
 
     m_c64.resetCpu();
@@ -190,15 +208,35 @@ void Player::initialise()
 
 bool Player::load(SidTune *tune)
 {
-    m_tune = tune;
+    const SidTuneInfo* tuneInfo = (tune != nullptr) ? tune->getInfo() : nullptr;
+    const unsigned int songNum = (tuneInfo != nullptr) ? tuneInfo->currentSong() : 0;
 
-    if (tune != nullptr) UNLIKELY
+    // Not owned, the caller keeps the tune alive while loaded
+    return load(std::shared_ptr<const SidTune>(tune, [](const SidTune*) {}), songNum);
+}
+
+bool Player::load(std::shared_ptr<const SidTune> tune, unsigned int songNum)
+{
+    stopStream();
+
+    m_tune = std::move(tune);
+
+    if (m_tune != nullptr) UNLIKELY
     {
+        if (m_tune->tune == nullptr) UNLIKELY
+        {
+            m_tune.reset();
+            m_errorString = ERR_NO_TUNE_LOADED;
+            return false;
+        }
+
+        m_tune->tune->songInfo(songNum, m_tuneInfo);
+
         // Must re-configure on fly for stereo support!
         if (!config(m_cfg, true)) UNLIKELY
         {
             // Failed configuration with new tune, reject it
-            m_tune = nullptr;
+            m_tune.reset();
             return false;
         }
     }
@@ -220,16 +258,40 @@ void Player::filter(unsigned int sidNum, bool enable)
 
 void Player::initMixer(bool stereo)
 {
+    stopStream();
+
     std::unique_ptr<short*[]> bufs(new short*[m_chips.size()]);
     buffers(bufs.get());
     m_simpleMixer.reset(new SimpleMixer(stereo, bufs.get(), installedSIDs()));
+    m_premixed = !m_chips.empty() && m_chips.front()->premix(*m_simpleMixer, m_chips);
 }
 
-unsigned int Player::mix(short *buffer, unsigned int samples)
+unsigned int Player::mixChips(short *buffer, unsigned int samples)
 {
+    if (m_premixed)
+    {
+        const unsigned int length = samples * m_simpleMixer->channels();
+        std::copy_n(m_chips.front()->buffer(), length, buffer);
+        return length;
+    }
+
     return m_simpleMixer->doMix(buffer, samples);
 }
 
+unsigned int Player::mix(short *buffer, unsigned int samples)
+{
+#ifdef ENABLE_STATS
+    const auto start = std::chrono::steady_clock::now();
+    const unsigned int mixed = mixChips(buffer, samples);
+    const uint_least64_t ns = elapsedNs(start);
+    m_stats.lastPlayNs[SidStats::MIXER] = ns;
+    m_stats.totalNs[SidStats::MIXER] += ns;
+    return mixed;
+#else
+    return mixChips(buffer, samples);
+#endif
+}
+
 void Player::buffers(short** buffers) const
 {
     for (size_t i = 0; i < m_chips.size(); i++)
@@ -238,6 +300,37 @@ void Player::buffers(short** buffers) const
     }
 }
 
+unsigned int Player::readTrace(uint8_t *buffer, unsigned int size)
+{
+    MOS6510Debug::Record records[64];
+
+    unsigned int written = 0;
+    unsigned int count = size / sizeof(MOS6510Debug::Record);
+    while (count > 0)
+    {
+        const unsigned int n = m_c64.readTrace(records, std::min(count, 64u));
+        if (n == 0)
+            break;
+
+        std::memcpy(buffer + written, records, n * sizeof(MOS6510Debug::Record));
+        written += n * sizeof(MOS6510Debug::Record);
+        count -= n;
+    }
+
+    return written;
+}
+
+void Player::decodeTrace(const uint8_t *data, unsigned int size, FILE *out)
+{
+    for (unsigned int i = 0; i + sizeof(MOS6510Debug::Record) <= size; i += sizeof(MOS6510Debug::Record))
+    {
+        // data may be unaligned
+        MOS6510Debug::Record record;
+        std::memcpy(&record, data + i, sizeof(record));
+        MOS6510Debug::Decode(record, out);
+    }
+}
+
 int Player::play(unsigned int cycles)
 {
     // Make sure a tune is loaded
@@ -247,38 +340,61 @@ int Player::play(unsigned int cycles)
         return -1;
     }
 
-    if (cycles > MAX_CYCLES)
+    if (cycles > m_cfg.blockCycles)
     {
-        cycles = MAX_CYCLES;
+        cycles = m_cfg.blockCycles;
     }
 
-    try
-    {
-        for (unsigned int i = 0; i < cycles; i++)
-            m_c64.clock();
+    for (unsigned int i = 0; i < cycles; i++)
+        m_c64.clock();
 
-        int sampleCount = 0;
-        for (sidemu *s: m_chips)
-        {
-            // clock the chip and get the buffer
-            // buffersize is expected to be the same
-            // for all chips
-            s->clock();
-            sampleCount = s->bufferpos();
-            // Reset the buffer
-            s->bufferpos(0);
-        }
-        return sampleCount;
+#ifdef ENABLE_STATS
+    const auto sidStart = std::chrono::steady_clock::now();
+#endif
+
+    int sampleCount = 0;
+    for (sidemu *s: m_chips)
+    {
+        // clock the chip and get the buffer
+        // buffersize is expected to be the same
+        // for all chips
+        s->clock();
+        sampleCount = s->bufferpos();
+        // Reset the buffer
+        s->bufferpos(0);
     }
-    catch (MOS6510::haltInstruction const &ill)
+
+    // the chips are clocked anyway to keep their buffers in sync
+    if (const char *reason = m_c64.halted()) UNLIKELY
     {
-        m_errorString = ill.message();
+        m_errorString = reason;
         return -1;
     }
+
+#ifdef ENABLE_STATS
+    const uint_least64_t sidNs = elapsedNs(sidStart);
+
+    uint_least64_t eventNs[SidStats::SUBSYSTEMS];
+    updateEventStats(eventNs);
+    for (int i = 0; i < SidStats::SUBSYSTEMS; i++)
+    {
+        m_stats.lastPlayNs[i] = eventNs[i] - m_eventNs[i];
+        m_eventNs[i] = eventNs[i];
+    }
+    m_stats.lastPlayNs[SidStats::SID] += sidNs;
+    m_stats.totalNs[SidStats::SID] += sidNs;
+    m_stats.lastPlayNs[SidStats::MIXER] = 0;
+    m_stats.samples += sampleCount;
+    m_stats.playCalls++;
+#endif
+
+    return sampleCount;
 }
 
 bool Player::reset()
 {
+    stopStream();
+
     try
     {
         initialise();
@@ -308,6 +424,8 @@ bool Player::config(const SidConfig &cfg, bool force)
         return true;
     }
 
+    stopStream();
+
     // Check for a sane sampling frequency
     if ((cfg.frequency < 8000) || (cfg.frequency > 192000)) UNLIKELY
     {
@@ -315,10 +433,16 @@ bool Player::config(const SidConfig &cfg, bool force)
         return false;
     }
 
+    if ((cfg.blockCycles == 0) || (cfg.blockCycles > SidConfig::MAX_BLOCK_CYCLES)) UNLIKELY
+    {
+        m_errorString = ERR_UNSUPPORTED_BLOCK;
+        return false;
+    }
+
     // Only do these if we have a loaded tune
     if (m_tune != nullptr)
     {
-        const SidTuneInfo* tuneInfo = m_tune->getInfo();
+        const SidTuneInfo* tuneInfo = &m_tuneInfo;
 
         try
         {
@@ -348,7 +472,7 @@ bool Player::config(const SidConfig &cfg, bool force)
             const c64::cia_model_t ciaModel = getCiaModel(cfg.ciaModel);
             m_c64.setCiaModel(ciaModel);
 
-            sidParams(m_c64.getMainCpuSpeed(), cfg.frequency, cfg.samplingMethod);
+            sidParams(m_c64.getMainCpuSpeed(), cfg.frequency, cfg.samplingMethod, cfg.blockCycles);
 
             // Configure, setup and install C64 environment/events
             initialise();
@@ -375,7 +499,7 @@ bool Player::config(const SidConfig &cfg, bool force)
 // Clock speed changes due to loading a new song
 c64::model_t Player::c64model(SidConfig::c64_model_t defaultModel, bool forced)
 {
-    const SidTuneInfo* tuneInfo = m_tune->getInfo();
+    const SidTuneInfo* tuneInfo = &m_tuneInfo;
 
     SidTuneInfo::clock_t clockSpeed = tuneInfo->clockSpeed();
 
@@ -507,6 +631,7 @@ SidConfig::sid_model_t getSidModel(SidTuneInfo::model_t sidModel, SidConfig::sid
 void Player::sidRelease()
 {
     m_c64.clearSids();
+    m_premixed = false;
 
     for (sidemu *s: m_chips)
     {
@@ -526,7 +651,7 @@ void Player::sidCreate(sidbuilder *builder, SidConfig::sid_model_t defaultModel,
     {
         m_chips.clear();
         m_info.m_sidModels.clear();
-        const SidTuneInfo* tuneInfo = m_tune->getInfo();
+        const SidTuneInfo* tuneInfo = &m_tuneInfo;
 
         // Setup base SID
         const SidConfig::sid_model_t userModel = getSidModel(tuneInfo->sidModel(0), defaultModel, forced);
@@ -571,10 +696,12 @@ void Player::sidCreate(sidbuilder *builder, SidConfig::sid_model_t defaultModel,
 }
 
 void Player::sidParams(double cpuFreq, int frequency,
-                        SidConfig::sampling_method_t sampling)
+                        SidConfig::sampling_method_t sampling,
+                        unsigned int blockCycles)
 {
     for (sidemu *s: m_chips)
     {
+        s->bufferCycles(blockCycles);
         s->sampling((float)cpuFreq, frequency, sampling);
     }
 }
@@ -593,13 +720,102 @@ int Player::getBufSize(unsigned int cycles)
     if (!m_simpleMixer)
         return 0;
 
-    if (cycles > MAX_CYCLES)
+    if (cycles > m_cfg.blockCycles)
     {
-        cycles = MAX_CYCLES;
+        cycles = m_cfg.blockCycles;
     }
 
-    double size = static_cast<double>(m_cfg.frequency) / m_c64.getMainCpuSpeed() * cycles;
-    return  static_cast<int>(std::ceil(size)) * m_simpleMixer->channels();
+    return sidemu::bufferSize(m_c64.getMainCpuSpeed(), m_cfg.frequency, cycles) * m_simpleMixer->channels();
+}
+
+bool Player::startStream(unsigned int lookahead)
+{
+    stopStream();
+
+    if (m_tune == nullptr) UNLIKELY
+    {
+        m_errorString = ERR_NO_TUNE_LOADED;
+        return false;
+    }
+
+    if (!m_simpleMixer) UNLIKELY
+    {
+        m_errorString = ERR_NO_MIXER;
+        return false;
+    }
+
+    if (lookahead == 0) UNLIKELY
+    {
+        m_errorString = ERR_BAD_BUF_SIZE;
+        return false;
+    }
+
+    const unsigned int cycles = m_cfg.blockCycles;
+    auto render = [this, cycles](short *buffer)
+    {
+        const int samples = play(cycles);
+        return samples > 0 ? static_cast<int>(mix(buffer, samples)) : samples;
+    };
+
+    m_streamer.reset(new Streamer(render, m_simpleMixer->channels(), getBufSize(cycles),
+                                  lookahead, m_cfg.frequency));
+    return true;
+}
+
+unsigned int Player::readStream(short *buffer, unsigned int frames)
+{
+    if (!m_streamer) UNLIKELY
+    {
+        const unsigned int channels = m_simpleMixer ? m_simpleMixer->channels() : 1;
+        std::fill_n(buffer, frames * channels, 0);
+        return 0;
+    }
+
+    return m_streamer->read(buffer, frames);
+}
+
+#ifdef ENABLE_STATS
+void Player::updateEventStats(uint_least64_t ns[SidStats::SUBSYSTEMS])
+{
+    m_c64.getStats(m_stats);
+
+    std::fill(ns, ns + SidStats::SUBSYSTEMS, 0);
+    for (unsigned int i = 0; i < m_stats.eventTypes; i++)
+    {
+        ns[m_stats.events[i].subsystem] += m_stats.events[i].nanoseconds;
+    }
+}
+#endif
+
+const SidStats &Player::stats()
+{
+#ifdef ENABLE_STATS
+    uint_least64_t eventNs[SidStats::SUBSYSTEMS];
+    updateEventStats(eventNs);
+    for (int i = 0; i < SidStats::SUBSYSTEMS; i++)
+    {
+        if ((i != SidStats::SID) && (i != SidStats::MIXER))
+            m_stats.totalNs[i] = eventNs[i];
+    }
+
+    for (size_t i = 0; (i < m_chips.size()) && (i < SidStats::MAX_SIDS); i++)
+    {
+        m_stats.sidWrites[i] = m_chips[i]->writes();
+        m_stats.sidReads[i] = m_chips[i]->reads();
+    }
+#endif
+    return m_stats;
+}
+
+void Player::resetStats()
+{
+#ifdef ENABLE_STATS
+    m_c64.resetStats();
+    for (sidemu *s: m_chips)
+        s->resetStats();
+    std::fill(std::begin(m_eventNs), std::end(m_eventNs), 0);
+#endif
+    m_stats.reset();
 }
 
 }
@@ -30,11 +30,14 @@
 #include "sidplayfp/siddefs.h"
 #include "sidplayfp/SidConfig.h"
 #include "sidplayfp/SidTuneInfo.h"
+#include "sidplayfp/SidStats.h"
 
 #include "SidInfoImpl.h"
 #include "sidrandom.h"
 #include "simpleMixer.h"
+#include "streamer.h"
 #include "c64/c64.h"
+#include "sidtune/SidTuneSongInfo.h"
 
 #ifdef HAVE_CONFIG_H
 #  include "config.h"
@@ -60,8 +63,11 @@ private:
     /// Commodore 64 emulator
     c64 m_c64;
 
-    /// Emulator info
-    SidTune *m_tune;
+    /// The loaded tune, possibly shared with other players
+    std::shared_ptr<const SidTune> m_tune;
+
+    /// The selected sub-song of the tune
+    SidTuneSongInfo m_tuneInfo;
 
     /// User Configuration Settings
     SidInfoImpl m_info;
@@ -83,6 +89,20 @@ private:
 
     std::unique_ptr<SimpleMixer> m_simpleMixer;
 
+    /// The chips are mixed by the emulation itself
+    bool m_premixed = false;
+
+    /// Runtime statistics
+    SidStats m_stats;
+
+#ifdef ENABLE_STATS
+    /// Time spent in events up to the last play call, per subsystem
+    uint_least64_t m_eventNs[SidStats::SUBSYSTEMS] = {};
+#endif
+
+    /// Background rendering, stopped before anything else is destroyed
+    std::unique_ptr<Streamer> m_streamer;
+
 private:
     /**
      * Get the C64 model for the current loaded tune.
@@ -99,6 +119,12 @@ private:
      */
     void initialise();
 
+    /**
+     * Mix the chip buffers, or copy the output
+     * if the emulation mixes it by itself.
+     */
+    unsigned int mixChips(short *buffer, unsigned int samples);
+
     /**
      * Release the SID builders.
      */
@@ -118,12 +144,22 @@ private:
      * @param cpuFreq the CPU clock frequency
      * @param frequency the output sampling frequency
      * @param sampling the sampling method to use
+     * @param blockCycles the maximum number of cycles per play call
      */
     void sidParams(double cpuFreq, int frequency,
-                    SidConfig::sampling_method_t sampling);
+                    SidConfig::sampling_method_t sampling,
+                    unsigned int blockCycles);
 
     inline void run(unsigned int events);
 
+#ifdef ENABLE_STATS
+    /**
+     * Refresh the event counters and
+     * sum up the time spent in events per subsystem.
+     */
+    void updateEventStats(uint_least64_t ns[SidStats::SUBSYSTEMS]);
+#endif
+
 public:
     Player();
     ~Player() = default;
@@ -132,10 +168,14 @@ public:
 
     const SidInfo &info() const { return m_info; }
 
+    const SidTuneInfo *tuneInfo() const { return m_tune ? &m_tuneInfo : nullptr; }
+
     bool config(const SidConfig &cfg, bool force=false);
 
     bool load(SidTune *tune);
 
+    bool load(std::shared_ptr<const SidTune> tune, unsigned int songNum);
+
     void buffers(short** buffers) const;
 
     int play(unsigned int cycles);
@@ -144,6 +184,18 @@ public:
 
     void debug(const bool enable, FILE *out) { m_c64.debug(enable, out); }
 
+    void trace(bool enable, unsigned int size) { m_c64.trace(enable, size); }
+
+    unsigned int readTrace(uint8_t *buffer, unsigned int size);
+
+    unsigned int traceDropped() const { return m_c64.traceDropped(); }
+
+    static void decodeTrace(const uint8_t *data, unsigned int size, FILE *out);
+
+    void profile(bool enable) { m_c64.profile(enable); }
+
+    bool dumpProfile(FILE *out) const { return m_c64.dumpProfile(out); }
+
     void mute(unsigned int sidNum, unsigned int voice, bool enable);
 
     void filter(unsigned int sidNum, bool enable);
@@ -154,10 +206,20 @@ public:
     void setBasic(const uint8_t* rom);
     void setChargen(const uint8_t* rom);
 
+    void setRandomSeed(unsigned int seed) { m_rand = sidrandom(seed); }
+
     uint_least16_t getCia1TimerA() const { return m_c64.getCia1TimerA(); }
 
     bool getSidStatus(unsigned int sidNum, uint8_t regs[32]);
 
+    const uint8_t* getRam() const { return m_c64.getMemInterface().getRam(); }
+
+    const uint8_t* getColorRam() const { return m_c64.getColorRam(); }
+
+    void trackDirtyPages(bool enable) { m_c64.getMemInterface().trackDirtyPages(enable); }
+
+    unsigned int getDirtyPages(uint8_t bitmap[32]) { return m_c64.getMemInterface().getDirtyPages(bitmap); }
+
     unsigned int installedSIDs() const { return m_chips.size(); }
 
     void initMixer(bool stereo);
@@ -167,6 +229,20 @@ public:
     bool reset();
 
     int getBufSize(unsigned int cycles);
+
+    bool startStream(unsigned int lookahead);
+
+    void stopStream() { m_streamer.reset(); }
+
+    unsigned int readStream(short *buffer, unsigned int frames);
+
+    unsigned int streamFill() const { return m_streamer ? m_streamer->fill() : 0; }
+
+    unsigned int streamUnderruns() const { return m_streamer ? m_streamer->underruns() : 0; }
+
+    const SidStats &stats();
+
+    void resetStats();
 };
 
 }
@@ -0,0 +1,143 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+#include "sidcxx11.h"
+
+namespace libsidplayfp
+{
+
+/**
+ * Lock-free single producer single consumer ring buffer.
+ *
+ * One thread may push while another one pops,
+ * no other synchronization is required.
+ * The capacity is rounded up to a power of two.
+ */
+template<typename T>
+class RingBuffer
+{
+private:
+    std::unique_ptr<T[]> m_buffer;
+
+    const size_t m_mask;
+
+    /// Write position, owned by the producer
+    std::atomic<size_t> m_head;
+
+    /// Read position, owned by the consumer
+    std::atomic<size_t> m_tail;
+
+private:
+    static size_t roundUp(size_t size)
+    {
+        size_t n = 1;
+        while (n < size)
+            n <<= 1;
+        return n;
+    }
+
+public:
+    explicit RingBuffer(size_t size) :
+        m_buffer(new T[roundUp(size)]),
+        m_mask(roundUp(size) - 1),
+        m_head(0),
+        m_tail(0) {}
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    /**
+     * Number of elements available for reading.
+     */
+    size_t size() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Append up to count elements.
+     * Producer side only.
+     *
+     * @return the number of elements written
+     */
+    size_t push(const T *data, size_t count)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t space = capacity() - (head - m_tail.load(std::memory_order_acquire));
+        if (count > space)
+            count = space;
+
+        for (size_t i = 0; i < count; i++)
+            m_buffer[(head + i) & m_mask] = data[i];
+
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Append a single element.
+     * Producer side only.
+     *
+     * @return false if the buffer is full
+     */
+    bool push(const T &data)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == capacity()) UNLIKELY
+            return false;
+
+        m_buffer[head & m_mask] = data;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Remove up to count elements.
+     * Consumer side only.
+     *
+     * @return the number of elements read
+     */
+    size_t pop(T *data, size_t count)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t available = m_head.load(std::memory_order_acquire) - tail;
+        if (count > available)
+            count = available;
+
+        for (size_t i = 0; i < count; i++)
+            data[i] = m_buffer[(tail + i) & m_mask];
+
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+};
+
+}
+
+#endif // RINGBUFFER_H
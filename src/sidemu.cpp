@@ -22,6 +22,8 @@
 
 #include "sidemu.h"
 
+#include <cmath>
+
 namespace libsidplayfp
 {
 
@@ -59,6 +61,14 @@ void sidemu::writeReg(uint_least8_t addr, uint8_t data)
     write(addr, data);
 }
 
+int sidemu::bufferSize(double systemfreq, double outputfreq, unsigned int cycles)
+{
+    // leave room for the emulations rounding the sampling ratio
+    // and for the output falling on both ends of the interval
+    const double samples = outputfreq / systemfreq * cycles;
+    return static_cast<int>(std::ceil(samples * 1.01)) + 1;
+}
+
 void sidemu::voice(unsigned int voice, bool mute)
 {
     if (voice < 4) LIKELY
@@ -34,12 +34,15 @@
 
 #include <string>
 #include <bitset>
+#include <vector>
 
 class sidbuilder;
 
 namespace libsidplayfp
 {
 
+class SimpleMixer;
+
 /**
  * Inherit this class to create a new SID emulation.
  */
@@ -64,6 +67,9 @@ protected:
     /// Current position in buffer
     int m_bufferpos = 0;
 
+    /// Maximum number of cycles clocked between buffer resets
+    unsigned int m_bufferCycles = SidConfig::DEFAULT_BLOCK_CYCLES;
+
     bool m_status = true;
     bool isLocked = false;
 
@@ -123,6 +129,22 @@ public:
      */
     virtual void model(SidConfig::sid_model_t model, bool digiboost) = 0;
 
+    /**
+     * Get the number of samples produced at most
+     * in the given number of cycles.
+     *
+     * @param systemfreq
+     * @param outputfreq
+     * @param cycles
+     */
+    static int bufferSize(double systemfreq, double outputfreq, unsigned int cycles);
+
+    /**
+     * Set the maximum number of cycles clocked between buffer resets.
+     * Must be called before #sampling.
+     */
+    void bufferCycles(unsigned int cycles) { m_bufferCycles = cycles; }
+
     /**
      * Set the sampling method.
      *
@@ -133,6 +155,20 @@ public:
     virtual void sampling(float systemfreq SID_UNUSED, float outputfreq SID_UNUSED,
         SidConfig::sampling_method_t method SID_UNUSED) {}
 
+    /**
+     * Render and mix a group of chips in the same pass.
+     * On success the mixed interleaved output is found
+     * in the buffer of this chip, which must be the first
+     * of the group, and the buffers of the other chips
+     * are no longer filled.
+     *
+     * @param mixer the mixer providing the channel matrix
+     * @param chips the chips to mix
+     * @return false if not supported
+     */
+    virtual bool premix(const SimpleMixer &mixer SID_UNUSED,
+        const std::vector<sidemu*> &chips SID_UNUSED) { return false; }
+
     /**
      * Get a detailed error message.
      */
@@ -233,6 +233,19 @@ inline void endian_little32 (uint8_t ptr[4], uint_least32_t dword)
     ptr[3] = endian_16hi8  (word);
 }
 
+/// Convert eight bytes to 64-bit little endian word.
+inline uint_least64_t endian_little64 (const uint8_t ptr[8])
+{
+    return (static_cast<uint_least64_t>(endian_little32 (ptr + 4)) << 32) | endian_little32 (ptr);
+}
+
+/// Write a little-endian 64-bit word to eight bytes in memory.
+inline void endian_little64 (uint8_t ptr[8], uint_least64_t qword)
+{
+    endian_little32 (ptr, static_cast<uint_least32_t>(qword));
+    endian_little32 (ptr + 4, static_cast<uint_least32_t>(qword >> 32));
+}
+
 /// Convert high-byte and low-byte to 32-bit big endian word.
 inline uint_least32_t endian_big32 (const uint8_t ptr[4])
 {
@@ -21,9 +21,13 @@
 #ifndef SIDMD5_H
 #define SIDMD5_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include "libs/hashlib/md5.hpp"
+#include "libs/hashlib/md5_multi.hpp"
 
 namespace libsidplayfp
 {
@@ -47,6 +51,29 @@ public:
      * Return pointer to 32-byte hex fingerprint.
      */
     inline std::string getDigest() { return m_md5.hexdigest(); }
+
+    /**
+     * Hash several independent messages at once,
+     * in parallel SIMD lanes where available.
+     */
+    static void digest(const hashlib::md5_message *messages, size_t count, std::array<uint8_t, 16> *digests)
+    {
+        hashlib::md5_multi(messages, count, digests);
+    }
+
+    /**
+     * Format a binary digest as a null terminated 32-byte hex fingerprint.
+     */
+    static void toHex(const std::array<uint8_t, 16> &digest, char *hex)
+    {
+        static const char digits[] = "0123456789abcdef";
+        for (size_t i = 0; i < digest.size(); i++)
+        {
+            hex[i * 2] = digits[digest[i] >> 4];
+            hex[i * 2 + 1] = digits[digest[i] & 0x0f];
+        }
+        hex[digest.size() * 2] = '\0';
+    }
 };
 
 }
@@ -81,6 +81,28 @@ public:
      */
     virtual void fillRam(uint_least16_t start, const uint8_t* source, unsigned int size) =0;
 
+    /**
+     * Get a read-only view of the whole 64K RAM.
+     * The contents change as the emulation runs.
+     */
+    virtual const uint8_t* getRam() const =0;
+
+    /**
+     * Enable/disable tracking of the written RAM pages.
+     * Enabling marks all the pages as dirty.
+     *
+     * @param enable true to track the pages
+     */
+    virtual void trackDirtyPages(bool enable) =0;
+
+    /**
+     * Get the RAM pages written since the last call and clear them.
+     *
+     * @param bitmap 32 bytes, one bit per 256 bytes page, LSB first
+     * @return the number of dirty pages
+     */
+    virtual unsigned int getDirtyPages(uint8_t* bitmap) =0;
+
     /**
      * Change the RESET vector.
      *
@@ -36,7 +36,8 @@ SidConfig::SidConfig() :
     thirdSidAddress(0),
     sidEmulation(nullptr),
     powerOnDelay(DEFAULT_POWER_ON_DELAY),
-    samplingMethod(RESAMPLE_INTERPOLATE)
+    samplingMethod(RESAMPLE_INTERPOLATE),
+    blockCycles(DEFAULT_BLOCK_CYCLES)
 {}
 
 bool SidConfig::compare(const SidConfig &config) const
@@ -52,5 +53,6 @@ bool SidConfig::compare(const SidConfig &config) const
         || thirdSidAddress != config.thirdSidAddress
         || sidEmulation != config.sidEmulation
         || powerOnDelay != config.powerOnDelay
-        || samplingMethod != config.samplingMethod;
+        || samplingMethod != config.samplingMethod
+        || blockCycles != config.blockCycles;
 }
@@ -90,6 +90,14 @@ public:
 
     static const uint_least32_t DEFAULT_SAMPLING_FREQ  = 48000;
 
+    /**
+     * Block size limits, in cycles.
+     * - The default is roughly 20ms
+     * - The maximum is roughly 10s
+     */
+    static const uint_least32_t DEFAULT_BLOCK_CYCLES = 20000;
+    static const uint_least32_t MAX_BLOCK_CYCLES = 10000000;
+
 public:
     /**
      * Intended c64 model when unknown or forced.
@@ -150,6 +158,15 @@ public:
      */
     sampling_method_t samplingMethod;
 
+    /**
+     * Maximum number of cycles run by each call to sidplayfp::play(),
+     * the sample buffers are sized accordingly.
+     * Large blocks reduce the per-call overhead when rendering offline.
+     *
+     * @since 3.1
+     */
+    uint_least32_t blockCycles;
+
     /**
      * Compare two config objects.
      *
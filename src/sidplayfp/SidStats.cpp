@@ -0,0 +1,49 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "SidStats.h"
+
+#include "sidcxx11.h"
+
+#include <algorithm>
+#include <iterator>
+
+SidStats::SidStats()
+{
+    reset();
+}
+
+void SidStats::reset()
+{
+#ifdef ENABLE_STATS
+    enabled = true;
+#else
+    enabled = false;
+#endif
+    cpuCycles = 0;
+    stolenCycles = 0;
+    eventTypes = 0;
+    std::fill(std::begin(sidWrites), std::end(sidWrites), 0);
+    std::fill(std::begin(sidReads), std::end(sidReads), 0);
+    samples = 0;
+    playCalls = 0;
+    std::fill(std::begin(lastPlayNs), std::end(lastPlayNs), 0);
+    std::fill(std::begin(totalNs), std::end(totalNs), 0);
+}
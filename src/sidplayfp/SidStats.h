@@ -0,0 +1,126 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIDSTATS_H
+#define SIDSTATS_H
+
+#include <cstdint>
+
+#include "sidplayfp/siddefs.h"
+
+/**
+ * SidStats
+ *
+ * A snapshot of the engine runtime counters.
+ *
+ * The counters are collected only if the library
+ * has been configured with --enable-stats,
+ * otherwise #enabled is false and everything stays at zero.
+ *
+ * Wall clock times are measured around each dispatched event
+ * so collecting them slows down the emulation noticeably.
+ *
+ * @since 3.1
+ */
+class SID_EXTERN SidStats
+{
+public:
+    /// Subsystems with wall clock accounting
+    typedef enum
+    {
+        CPU = 0,    ///< CPU, including the bus accesses it performs
+        VIC,        ///< Video chip
+        CIA,        ///< CIA chips
+        SID,        ///< SID synthesis
+        MIXER,      ///< Mixing
+        OTHER,      ///< Anything else
+        SUBSYSTEMS  ///< Number of subsystems
+    } subsystem_t;
+
+    /// Counters for a type of event
+    struct event_t
+    {
+        const char *name;               ///< Event name
+        subsystem_t subsystem;          ///< Subsystem the event belongs to
+        uint_least64_t count;           ///< Number of dispatches
+        uint_least64_t nanoseconds;     ///< Wall clock time spent
+    };
+
+    static const unsigned int MAX_EVENT_TYPES = 32;
+    static const unsigned int MAX_SIDS = 3;
+
+public:
+    /**
+     * True if the library collects statistics.
+     */
+    bool enabled;
+
+    /**
+     * CPU cycles.
+     */
+    //@{
+    uint_least64_t cpuCycles;       ///< Cycles executed
+    uint_least64_t stolenCycles;    ///< Cycles stolen by the VIC
+    //@}
+
+    /**
+     * Dispatched events, by type.
+     */
+    //@{
+    unsigned int eventTypes;
+    event_t events[MAX_EVENT_TYPES];
+    //@}
+
+    /**
+     * SID register accesses, per chip.
+     */
+    //@{
+    uint_least64_t sidWrites[MAX_SIDS];
+    uint_least64_t sidReads[MAX_SIDS];
+    //@}
+
+    /**
+     * Number of samples produced.
+     */
+    uint_least64_t samples;
+
+    /**
+     * Number of play calls.
+     */
+    uint_least64_t playCalls;
+
+    /**
+     * Wall clock time spent in nanoseconds, per subsystem.
+     */
+    //@{
+    uint_least64_t lastPlayNs[SUBSYSTEMS];  ///< During the last play and mix calls
+    uint_least64_t totalNs[SUBSYSTEMS];     ///< Since the last reset
+    //@}
+
+public:
+    SidStats();
+
+    /**
+     * Clear all the counters.
+     */
+    void reset();
+};
+
+#endif // SIDSTATS_H
@@ -22,6 +22,11 @@
 
 #include "sidtune/SidTuneBase.h"
 
+#include "sidmd5.h"
+
+#include <array>
+#include <utility>
+
 #include "sidcxx11.h"
 
 using namespace libsidplayfp;
@@ -57,7 +62,10 @@ SidTune::SidTune(const char* fileName, const char **fileNameExt, bool separatorI
 SidTune::SidTune(LoaderFunc loader, const char* fileName, const char **fileNameExt, bool separatorIsSlash) :
     tune(nullptr)
 {
-    setFileNameExtensions(fileNameExt);
+    // The list is shared, leave it alone unless replaced
+    // so that tunes can be created from several threads
+    if (fileNameExt != nullptr)
+        setFileNameExtensions(fileNameExt);
     load(loader, fileName, separatorIsSlash);
 }
 
@@ -116,6 +124,57 @@ void SidTune::read(const uint_least8_t* sourceBuffer, uint_least32_t bufferLen)
     }
 }
 
+void SidTune::read(std::shared_ptr<const uint_least8_t> sourceBuffer, uint_least32_t bufferLen)
+{
+    try
+    {
+        delete tune;
+        tune = SidTuneBase::read(std::move(sourceBuffer), bufferLen);
+        m_status = true;
+        m_statusString = MSG_NO_ERRORS;
+    }
+    catch (loadError const &e)
+    {
+        tune =  nullptr;
+        m_status = false;
+        m_statusString = e.message();
+    }
+}
+
+void SidTune::probe(const char* fileName, bool separatorIsSlash)
+{
+    try
+    {
+        delete tune;
+        tune = SidTuneBase::probe(fileName, separatorIsSlash);
+        m_status = true;
+        m_statusString = MSG_NO_ERRORS;
+    }
+    catch (loadError const &e)
+    {
+        tune =  nullptr;
+        m_status = false;
+        m_statusString = e.message();
+    }
+}
+
+void SidTune::probe(const uint_least8_t* sourceBuffer, uint_least32_t bufferLen)
+{
+    try
+    {
+        delete tune;
+        tune = SidTuneBase::probe(sourceBuffer, bufferLen);
+        m_status = true;
+        m_statusString = MSG_NO_ERRORS;
+    }
+    catch (loadError const &e)
+    {
+        tune =  nullptr;
+        m_status = false;
+        m_statusString = e.message();
+    }
+}
+
 unsigned int SidTune::selectSong(unsigned int songNum)
 {
     return tune != nullptr ? tune->selectSong(songNum) : 0;
@@ -135,9 +194,9 @@ bool SidTune::getStatus() const { return m_status; }
 
 const char* SidTune::statusString() const { return m_statusString; }
 
-bool SidTune::placeSidTuneInC64mem(sidmemory& mem)
+bool SidTune::placeSidTuneInC64mem(sidmemory& mem) const
 {
-    if (tune == nullptr)
+    if (tune == nullptr || tune->headerOnly())
         return false;
 
     tune->placeSidTuneInC64mem(mem);
@@ -146,15 +205,51 @@ bool SidTune::placeSidTuneInC64mem(sidmemory& mem)
 
 const char* SidTune::createMD5(char *md5)
 {
-    return tune != nullptr ? tune->createMD5(md5) : nullptr;
+    return (tune != nullptr && !tune->headerOnly()) ? tune->createMD5(md5) : nullptr;
 }
 
 const char* SidTune::createMD5New(char *md5)
 {
-    return tune != nullptr ? tune->createMD5New(md5) : nullptr;
+    return (tune != nullptr && !tune->headerOnly()) ? tune->createMD5New(md5) : nullptr;
+}
+
+void SidTune::createMD5Batch(SidTune* const* tunes, unsigned int count)
+{
+    // two messages per tune, old and new method
+    std::vector<SidTuneBase*> pending;
+    std::vector<hashlib::md5_message> messages;
+    std::vector<std::vector<uint8_t>> trailers(count);
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        SidTuneBase *base = tunes[i]->tune;
+        if (base == nullptr || base->headerOnly())
+            continue;
+
+        hashlib::md5_message oldMsg;
+        hashlib::md5_message newMsg;
+        if (base->md5Messages(oldMsg, newMsg, trailers[pending.size()]))
+        {
+            pending.push_back(base);
+            messages.push_back(oldMsg);
+            messages.push_back(newMsg);
+        }
+    }
+
+    std::vector<std::array<uint8_t, 16>> digests(messages.size());
+    sidmd5::digest(messages.data(), messages.size(), digests.data());
+
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        char md5[MD5_LENGTH + 1];
+        char md5New[MD5_LENGTH + 1];
+        sidmd5::toHex(digests[i * 2], md5);
+        sidmd5::toHex(digests[i * 2 + 1], md5New);
+        pending[i]->setMD5(md5, md5New);
+    }
 }
 
 const uint_least8_t* SidTune::c64Data() const
 {
-    return tune != nullptr ? tune->c64Data() : nullptr;
+    return (tune != nullptr && !tune->headerOnly()) ? tune->c64Data() : nullptr;
 }
@@ -24,6 +24,7 @@
 #define SIDTUNE_H
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "sidplayfp/siddefs.h"
@@ -34,13 +35,20 @@ namespace libsidplayfp
 {
 class SidTuneBase;
 class sidmemory;
+class Player;
 }
 
 /**
  * SidTune
+ *
+ * The const methods don't modify the tune, so a loaded tune
+ * can be shared between several players, also from different
+ * threads, see sidplayfp::load(std::shared_ptr<const SidTune>, unsigned int).
  */
 class SID_EXTERN SidTune
 {
+    friend class libsidplayfp::Player;
+
 public:
     static const int MD5_LENGTH = 32;
 
@@ -72,7 +80,8 @@ public:  // ----------------------------------------------------------------
      * load a sidtune. You can later load one with open().
      *
      * @param fileName
-     * @param fileNameExt
+     * @param fileNameExt replaces the file name extensions if not null,
+     *        see #setFileNameExtensions
      * @param separatorIsSlash
      */
     SidTune(const char* fileName, const char **fileNameExt = 0,
@@ -83,7 +92,8 @@ public:  // ----------------------------------------------------------------
      *
      * This function does the same as the above, except that it
      * accepts a callback function, which will be used to read
-     * all files it accesses.
+     * all files it accesses. The callback leaves the buffer
+     * empty if the file doesn't exist.
      *
      * @param loader
      * @param fileName
@@ -108,7 +118,8 @@ public:  // ----------------------------------------------------------------
      * The SidTune class does not copy the list of file name extensions,
      * so make sure you keep it. If the provided pointer is 0, the
      * default list will be activated. This is a static list which
-     * is used by all SidTune objects.
+     * is used by all SidTune objects, it must not be changed while
+     * other threads are loading tunes.
      *
      * @param fileNameExt
      */
@@ -116,6 +127,9 @@ public:  // ----------------------------------------------------------------
 
     /**
      * Load a sidtune into an existing object from a file.
+     * The file is memory mapped where supported and only
+     * copied into the C64 memory when the tune is played,
+     * so it must not be modified while the tune is loaded.
      *
      * @param fileName
      * @param separatorIsSlash
@@ -140,8 +154,49 @@ public:  // ----------------------------------------------------------------
      */
     void read(const uint_least8_t* sourceBuffer, uint_least32_t bufferLen);
 
+    /**
+     * Load a sidtune into an existing object from a shared buffer
+     * without copying it, the tune keeps a reference to the buffer
+     * which must not be modified while the tune is loaded.
+     * Currently supported: PSID and MUS formats.
+     *
+     * @param sourceBuffer the buffer that contains song data
+     * @param bufferLen length of the buffer
+     * @since 3.1
+     */
+    void read(std::shared_ptr<const uint_least8_t> sourceBuffer, uint_least32_t bufferLen);
+
+    /**
+     * Read the tune information from the file header only,
+     * without loading the C64 data or looking for companion
+     * files, e.g. to quickly list a collection.
+     * Currently supported: PSID, MUS, P00 and PRG formats.
+     *
+     * A probed tune only provides #getInfo and #selectSong,
+     * it must be loaded to be played or fingerprinted.
+     * MUS tunes are reported without their STR companion.
+     *
+     * @param fileName
+     * @param separatorIsSlash
+     * @since 3.1
+     */
+    void probe(const char* fileName, bool separatorIsSlash = false);
+
+    /**
+     * Read the tune information of a single-file sidtune
+     * from a memory buffer, see above.
+     * Currently supported: PSID and MUS formats.
+     *
+     * @param sourceBuffer the buffer that contains song data
+     * @param bufferLen length of the buffer
+     * @since 3.1
+     */
+    void probe(const uint_least8_t* sourceBuffer, uint_least32_t bufferLen);
+
     /**
      * Select sub-song.
+     * This modifies the tune, players sharing a tune
+     * select their own sub-song when loading it.
      *
      * @param songNum the selected song (0 = default starting song)
      * @return active song number, 0 if no tune is loaded.
@@ -179,11 +234,15 @@ public:  // ----------------------------------------------------------------
 
     /**
      * Copy sidtune into C64 memory (64 KB).
+     *
+     * @return false if no tune is loaded or it was only probed
      */
-    bool placeSidTuneInC64mem(libsidplayfp::sidmemory& mem);
+    bool placeSidTuneInC64mem(libsidplayfp::sidmemory& mem) const;
 
     /**
      * Calculates the MD5 hash of the tune, old method.
+     * Both hashes are computed in a single pass on first use
+     * and cached until the next load.
      * Not providing an md5 buffer will cause the internal one to be used.
      * If provided, buffer must be MD5_LENGTH + 1
      *
@@ -193,6 +252,8 @@ public:  // ----------------------------------------------------------------
 
     /**
      * Calculates the MD5 hash of the tune, new method, introduced in HVSC#68.
+     * Both hashes are computed in a single pass on first use
+     * and cached until the next load.
      * Not providing an md5 buffer will cause the internal one to be used.
      * If provided, buffer must be MD5_LENGTH + 1
      *
@@ -200,6 +261,17 @@ public:  // ----------------------------------------------------------------
      */
     const char *createMD5New(char *md5 = 0);
 
+    /**
+     * Calculates the MD5 hashes, both methods, of several tunes at once.
+     * Independent tunes are hashed in parallel SIMD lanes where available.
+     * The results are cached and returned by #createMD5 and #createMD5New.
+     *
+     * @param tunes the tunes, the ones not loaded are skipped
+     * @param count the number of tunes
+     * @since 3.1
+     */
+    static void createMD5Batch(SidTune* const* tunes, unsigned int count);
+
     const uint_least8_t* c64Data() const;
 
 private:    // prevent copying
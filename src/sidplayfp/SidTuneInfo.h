@@ -34,6 +34,9 @@
  * via:
  *        const SidTuneInfo* tuneInfo = SidTune.getInfo();
  *        const SidTuneInfo* tuneInfo = SidTune.getInfo(songNumber);
+ *
+ * The information of the sub-song played by a player
+ * sharing the tune is reported by sidplayfp::tuneInfo.
  */
 class SID_EXTERN SidTuneInfo
 {
@@ -33,6 +33,8 @@
 
 #include "player.h"
 
+#include <utility>
+
 sidplayfp::sidplayfp() :
     sidplayer(*(new libsidplayfp::Player)) {}
 
@@ -71,11 +73,21 @@ bool sidplayfp::load(SidTune *tune)
     return sidplayer.load(tune);
 }
 
+bool sidplayfp::load(std::shared_ptr<const SidTune> tune, unsigned int songNum)
+{
+    return sidplayer.load(std::move(tune), songNum);
+}
+
 const SidInfo &sidplayfp::info() const
 {
     return sidplayer.info();
 }
 
+const SidTuneInfo *sidplayfp::tuneInfo() const
+{
+    return sidplayer.tuneInfo();
+}
+
 uint_least32_t sidplayfp::time() const
 {
     return sidplayer.timeMs() / 1000;
@@ -106,6 +118,36 @@ void sidplayfp::debug(bool enable, FILE *out)
     sidplayer.debug(enable, out);
 }
 
+void sidplayfp::trace(bool enable, unsigned int size)
+{
+    sidplayer.trace(enable, size);
+}
+
+unsigned int sidplayfp::readTrace(uint8_t *buffer, unsigned int size)
+{
+    return sidplayer.readTrace(buffer, size);
+}
+
+unsigned int sidplayfp::traceDropped() const
+{
+    return sidplayer.traceDropped();
+}
+
+void sidplayfp::decodeTrace(const uint8_t *data, unsigned int size, FILE *out)
+{
+    libsidplayfp::Player::decodeTrace(data, size, out);
+}
+
+void sidplayfp::profile(bool enable)
+{
+    sidplayer.profile(enable);
+}
+
+bool sidplayfp::dumpProfile(FILE *out) const
+{
+    return sidplayer.dumpProfile(out);
+}
+
 void sidplayfp::setKernal(const uint8_t* rom) { sidplayer.setKernal(rom); }
 void sidplayfp::setBasic(const uint8_t* rom) { sidplayer.setBasic(rom); }
 void sidplayfp::setChargen(const uint8_t* rom) { sidplayer.setChargen(rom); }
@@ -117,6 +159,11 @@ void sidplayfp::setRoms(const uint8_t* kernal, const uint8_t* basic, const uint8
     setChargen(character);
 }
 
+void sidplayfp::setRandomSeed(unsigned int seed)
+{
+    sidplayer.setRandomSeed(seed);
+}
+
 uint_least16_t sidplayfp::getCia1TimerA() const
 {
     return sidplayer.getCia1TimerA();
@@ -127,6 +174,26 @@ bool sidplayfp::getSidStatus(unsigned int sidNum, uint8_t regs[32])
     return sidplayer.getSidStatus(sidNum, regs);
 }
 
+const uint8_t* sidplayfp::getRam() const
+{
+    return sidplayer.getRam();
+}
+
+const uint8_t* sidplayfp::getColorRam() const
+{
+    return sidplayer.getColorRam();
+}
+
+void sidplayfp::trackDirtyPages(bool enable)
+{
+    sidplayer.trackDirtyPages(enable);
+}
+
+unsigned int sidplayfp::getDirtyPages(uint8_t bitmap[32])
+{
+    return sidplayer.getDirtyPages(bitmap);
+}
+
 unsigned int sidplayfp::installedSIDs() const
 {
     return sidplayer.installedSIDs();
@@ -146,3 +213,38 @@ int sidplayfp::getBufSize(unsigned int cycles)
 {
     return sidplayer.getBufSize(cycles);
 }
+
+const SidStats &sidplayfp::stats()
+{
+    return sidplayer.stats();
+}
+
+void sidplayfp::resetStats()
+{
+    sidplayer.resetStats();
+}
+
+bool sidplayfp::startStream(unsigned int lookahead)
+{
+    return sidplayer.startStream(lookahead);
+}
+
+void sidplayfp::stopStream()
+{
+    sidplayer.stopStream();
+}
+
+unsigned int sidplayfp::readStream(short *buffer, unsigned int frames)
+{
+    return sidplayer.readStream(buffer, frames);
+}
+
+unsigned int sidplayfp::streamFill() const
+{
+    return sidplayer.streamFill();
+}
+
+unsigned int sidplayfp::streamUnderruns() const
+{
+    return sidplayer.streamUnderruns();
+}
@@ -25,6 +25,7 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <memory>
 
 #include "sidplayfp/siddefs.h"
 #include "sidplayfp/sidversion.h"
@@ -32,6 +33,8 @@
 class  SidConfig;
 class  SidTune;
 class  SidInfo;
+class  SidTuneInfo;
+class  SidStats;
 class  EventContext;
 
 // Private Sidplayer
@@ -66,6 +69,17 @@ public:
      */
     const SidInfo &info() const;
 
+    /**
+     * Get the information of the sub-song being played,
+     * the tune may be shared with other players
+     * playing different sub-songs.
+     *
+     * @return the sub-song information, null if no tune is loaded.
+     *         Valid until another tune is loaded.
+     * @since 3.1
+     */
+    const SidTuneInfo *tuneInfo() const;
+
     /**
      * Configure the engine.
      * Check #error for detailed message if something goes wrong.
@@ -84,6 +98,7 @@ public:
 
     /**
      * Load a tune.
+     * The sub-song selected in the tune when loading it is played.
      * Check #error for detailed message if something goes wrong.
      *
      * @param tune the SidTune to load, 0 unloads current tune.
@@ -91,9 +106,30 @@ public:
      */
     bool load(SidTune *tune);
 
+    /**
+     * Load a sub-song of a shared tune.
+     * The tune is not modified, so the same tune can be loaded
+     * by several players at once, also from different threads.
+     * The player keeps a reference to the tune until another
+     * one is loaded, the sub-song information is reported
+     * by #tuneInfo.
+     * Check #error for detailed message if something goes wrong.
+     *
+     * @param tune the SidTune to load, null unloads current tune.
+     * @param songNum the sub-song to play (0 = default starting song)
+     * @return true on sucess, false otherwise.
+     * @since 3.1
+     */
+    bool load(std::shared_ptr<const SidTune> tune, unsigned int songNum);
+
     /**
      * Get the buffer pointers for each of the installed SID chip.
      *
+     * @note After #initMixer, emulations which mix all the chips
+     * in the same pass, like sidlite with more than one chip,
+     * write the mixed output to the first buffer and leave the
+     * others unfilled. Use #mix to get the output of such engines.
+     *
      * @param buffers pointer to the array of buffer pointers.
      * @since 2.14
      */
@@ -101,8 +137,10 @@ public:
 
     /**
      * Run the emulation for selected number of cycles.
-     * The value will be limited to a reasonable amount
+     * The value will be limited to SidConfig#blockCycles
      * if too large.
+     * Once configured and with the mixer initialized this is
+     * real-time safe: it doesn't allocate memory, lock or throw.
      *
      * @param cycles the number of cycles to run.
      * @return the number of produced samples or zero
@@ -131,6 +169,9 @@ public:
 
     /**
      * Initialize the mixer.
+     * Must be called again after loading a tune.
+     * Emulations which mix all the chips in the same pass
+     * stop filling the buffers returned by #buffers.
      *
      * @param stereo whether to mix in stereo or mono
      * @since 2.15
@@ -139,6 +180,7 @@ public:
 
     /**
      * Mix buffers.
+     * Real-time safe, like #play(unsigned int).
      *
      * @param buffer the output buffer
      * @param samples number of samples to mix, returned from the #play(unsigned int) function
@@ -156,6 +198,74 @@ public:
      */
     void debug(bool enable, FILE *out);
 
+    /**
+     * Control binary CPU tracing.
+     * Instead of being printed each instruction is stored as a
+     * fixed size record into a lock-free ring buffer,
+     * records are dropped when the buffer is full.
+     * Replaces the text output enabled with #debug.
+     * @note: Must be called before #reset
+     *
+     * @param enable enable/disable tracing.
+     * @param size the buffer capacity in records.
+     * @since 3.1
+     */
+    void trace(bool enable, unsigned int size);
+
+    /**
+     * Fetch binary trace data.
+     * Can be called from a different thread than the one calling #play.
+     *
+     * @param buffer the destination buffer.
+     * @param size the buffer size in bytes.
+     * @return the number of bytes written, a multiple of the record size.
+     * @since 3.1
+     */
+    unsigned int readTrace(uint8_t *buffer, unsigned int size);
+
+    /**
+     * Get the number of trace records dropped because the buffer was full.
+     *
+     * @since 3.1
+     */
+    unsigned int traceDropped() const;
+
+    /**
+     * Decode binary trace data to the text format used by #debug.
+     * Records are stored in native byte order.
+     *
+     * @param data the trace data as returned by #readTrace.
+     * @param size the data size in bytes.
+     * @param out the file where to write the decoded trace.
+     * @since 3.1
+     */
+    static void decodeTrace(const uint8_t *data, unsigned int size, FILE *out);
+
+    /**
+     * Control CPU profiling.
+     * When enabled the cycles spent at each instruction address
+     * and the calls to each subroutine are counted.
+     * Enabling clears the counters.
+     *
+     * @param enable enable/disable profiling.
+     * @since 3.1
+     */
+    void profile(bool enable);
+
+    /**
+     * Write the CPU profile in text format, one entry per line:
+     * - "C address cycles" for the cycles spent per instruction address
+     * - "J address calls" for the calls per subroutine address
+     * - "I cycles" for the cycles spent entering interrupts
+     *
+     * Addresses are in hex, counts in decimal.
+     *
+     * @param out the file where to write the profile.
+     * @return false if profiling is not enabled.
+     * @since 3.1
+     */
+    bool dumpProfile(FILE *out) const;
+
     /**
      * Mute/unmute a SID channel.
      *
@@ -211,6 +321,17 @@ public:
     void setChargen(const uint8_t* rom);
     //@}
 
+    /**
+     * Set the seed of the random number generator used for the
+     * power on delay, see SidConfig::powerOnDelay.
+     * By default the generator is seeded with the current time,
+     * a fixed seed makes the output reproducible.
+     *
+     * @param seed the seed.
+     * @since 3.1
+     */
+    void setRandomSeed(unsigned int seed);
+
     /**
      * Get the CIA 1 Timer A programmed value.
      */
@@ -226,16 +347,129 @@ public:
      */
     bool getSidStatus(unsigned int sidNum, uint8_t regs[32]);
 
+    /**
+     * Get a read-only view of the 64K RAM, for tools
+     * that inspect the whole memory without per byte access.
+     * The pointer is valid for the lifetime of the player
+     * and the contents change during #play.
+     *
+     * @return pointer to 65536 bytes.
+     * @since 3.1
+     */
+    const uint8_t* getRam() const;
+
+    /**
+     * Get a read-only view of the color RAM at $D800.
+     * Only the low nibble of each byte is meaningful.
+     * The SID registers shadows are available through #getSidStatus.
+     *
+     * @return pointer to 1024 bytes.
+     * @since 3.1
+     */
+    const uint8_t* getColorRam() const;
+
+    /**
+     * Enable/disable tracking of the written RAM pages.
+     * Enabling marks all the pages as dirty.
+     * Disabled by default as it adds a check to every RAM write.
+     *
+     * @param enable true to track the pages.
+     * @since 3.1
+     */
+    void trackDirtyPages(bool enable);
+
+    /**
+     * Get the RAM pages written since the last call and clear them,
+     * so that only the changed pages need to be compared or hashed.
+     *
+     * @param bitmap filled with one bit per 256 bytes page, LSB first.
+     * @return the number of dirty pages.
+     * @since 3.1
+     */
+    unsigned int getDirtyPages(uint8_t bitmap[32]);
+
     /**
      * Get the required size of the buffer for the number of cycles to run,
      * approximate value by excess.
      * The mixer must have been initialized before with #initMixer
      *
      * @param cycles the number of cycles.
-     * @return size of buffer in bytes or zero if the mixer has not been initialized.
+     * @return size of buffer in samples or zero if the mixer has not been initialized.
      * @since 3.0
      */
     int getBufSize(unsigned int cycles);
+
+    /**
+     * Get a snapshot of the runtime statistics.
+     * Counters are collected only if the library has been
+     * built with statistics support, see SidStats::enabled.
+     *
+     * @return a const reference to the statistics,
+     *         valid until the next call.
+     * @since 3.1
+     */
+    const SidStats &stats();
+
+    /**
+     * Clear the runtime statistics.
+     *
+     * @since 3.1
+     */
+    void resetStats();
+
+    /**
+     * Start rendering ahead of time in a background thread.
+     * The thread runs #play and #mix, blocks of SidConfig#blockCycles
+     * cycles, until the lookahead is filled. While streaming only
+     * #readStream, #streamFill and #streamUnderruns may be called,
+     * loading a tune, configuring, resetting the engine or
+     * initializing the mixer stop the stream.
+     * The mixer must have been initialized before with #initMixer.
+     *
+     * @param lookahead the number of frames to keep rendered ahead.
+     * @return false in case of error, use #error()
+     * to get a detailed message.
+     * @since 3.1
+     */
+    bool startStream(unsigned int lookahead);
+
+    /**
+     * Stop the background rendering.
+     * The frames rendered ahead are discarded.
+     *
+     * @since 3.1
+     */
+    void stopStream();
+
+    /**
+     * Get rendered frames.
+     * Never runs the emulation nor blocks so it can be called
+     * from the audio callback. The missing frames are filled
+     * with silence and counted as an underrun. If the emulation
+     * stopped because of an error the stream runs dry,
+     * use #error() after #stopStream to get a detailed message.
+     *
+     * @param buffer the output buffer, frames*channels samples.
+     * @param frames the number of frames.
+     * @return the number of rendered frames read.
+     * @since 3.1
+     */
+    unsigned int readStream(short *buffer, unsigned int frames);
+
+    /**
+     * Get the number of frames rendered ahead.
+     *
+     * @since 3.1
+     */
+    unsigned int streamFill() const;
+
+    /**
+     * Get the number of reads which came short of frames
+     * since the stream was started.
+     *
+     * @since 3.1
+     */
+    unsigned int streamUnderruns() const;
 };
 
 #endif // SIDPLAYFP_H
@@ -23,6 +23,7 @@
 #include "MUS.h"
 
 #include <memory>
+#include <utility>
 
 #include "sidplayfp/SidTuneInfo.h"
 #include "c64/CPU/opcodes.h"
@@ -64,27 +65,50 @@ const uint8_t* player2 = sidplayer2 + o65headersize;
 const size_t player1size = sizeof(sidplayer1) - o65headersize;
 const size_t player2size = sizeof(sidplayer2) - o65headersize;
 
-bool detect(const uint8_t* buffer, size_t bufsize, uint_least32_t& voice3Index)
+/**
+ * Get the offsets following the data of each voice from the header.
+ */
+void getVoiceEnds(const uint8_t* buffer, uint_least32_t voiceEnds[3])
 {
-    // sanity check
-    if ((buffer == nullptr) || (bufsize < 8))
-        return false;
-
     // Skip load address and 3x length entry.
     uint_least32_t voice1Index = 2 + 3 * 2;
     // Add length of voice 1 data.
     voice1Index += endian_little16(&buffer[2]);
     // Add length of voice 2 data.
-    uint_least32_t voice2Index = voice1Index + endian_little16(&buffer[4]);
+    const uint_least32_t voice2Index = voice1Index + endian_little16(&buffer[4]);
     // Add length of voice 3 data.
-    voice3Index = voice2Index + endian_little16(&buffer[6]);
+    const uint_least32_t voice3Index = voice2Index + endian_little16(&buffer[6]);
+
+    voiceEnds[0] = voice1Index;
+    voiceEnds[1] = voice2Index;
+    voiceEnds[2] = voice3Index;
+}
+
+bool detect(const uint8_t* buffer, size_t bufsize, uint_least32_t& voice3Index)
+{
+    // sanity check
+    if ((buffer == nullptr) || (bufsize < 8))
+        return false;
+
+    uint_least32_t voiceEnds[3];
+    getVoiceEnds(buffer, voiceEnds);
+    voice3Index = voiceEnds[2];
 
     if (voice3Index > bufsize)
         return false;
 
-    return ((endian_big16(&buffer[voice1Index - 2]) == SIDTUNE_MUS_HLT_CMD)
-            && (endian_big16(&buffer[voice2Index - 2]) == SIDTUNE_MUS_HLT_CMD)
-            && (endian_big16(&buffer[voice3Index - 2]) == SIDTUNE_MUS_HLT_CMD));
+    return ((endian_big16(&buffer[voiceEnds[0] - 2]) == SIDTUNE_MUS_HLT_CMD)
+            && (endian_big16(&buffer[voiceEnds[1] - 2]) == SIDTUNE_MUS_HLT_CMD)
+            && (endian_big16(&buffer[voiceEnds[2] - 2]) == SIDTUNE_MUS_HLT_CMD));
+}
+
+bool MUS::voiceEnds(const buffer_t& header, uint_least32_t fileLen, uint_least32_t voiceEnds[3])
+{
+    if (header.size() < 8)
+        return false;
+
+    getVoiceEnds(&header[0], voiceEnds);
+    return voiceEnds[2] <= fileLen;
 }
 
 void MUS::setPlayerAddress()
@@ -104,28 +128,31 @@ void MUS::setPlayerAddress()
 }
 
 void MUS::acceptSidTune(const char* dataFileName, const char* infoFileName,
-                            buffer_t& buf, bool isSlashedFileName)
+                            data_t data, uint_least32_t dataLen, bool isSlashedFileName)
 {
     setPlayerAddress();
-    SidTuneBase::acceptSidTune(dataFileName, infoFileName, buf, isSlashedFileName);
+    SidTuneBase::acceptSidTune(dataFileName, infoFileName, std::move(data), dataLen, isSlashedFileName);
 }
 
-void MUS::placeSidTuneInC64mem(sidmemory& mem)
+void MUS::placeSidTuneInC64mem(sidmemory& mem) const
 {
     SidTuneBase::placeSidTuneInC64mem(mem);
     installPlayer(mem);
 }
 
-bool MUS::mergeParts(buffer_t& musBuf, buffer_t& strBuf) const
+void MUS::checkSize(uint_least32_t mergeLen) const
 {
-    const uint_least32_t mergeLen = musBuf.size() + strBuf.size();
-
     // Sanity check. I do not trust those MUS/STR files around.
     const uint_least32_t freeSpace = endian_16(player1[1], player1[0]) - SIDTUNE_MUS_DATA_ADDR;
     if ((mergeLen - 4) > freeSpace)
     {
         throw loadError(ERR_SIZE_EXCEEDED);
     }
+}
+
+bool MUS::mergeParts(buffer_t& musBuf, buffer_t& strBuf) const
+{
+    checkSize(musBuf.size() + strBuf.size());
 
     if (!strBuf.empty() && info->getSidChips() > 1)
     {
@@ -170,10 +197,17 @@ void MUS::installPlayer(sidmemory& mem) const
     }
 }
 
-SidTuneBase* MUS::load(buffer_t& dataBuf, bool init)
+SidTuneBase* MUS::load(const uint8_t* dataBuf, uint_least32_t dataLen, bool init)
 {
-    buffer_t empty;
-    return load(dataBuf, empty, 0, init);
+    uint_least32_t voice3Index;
+    if (!detect(dataBuf, dataLen, voice3Index))
+        return nullptr;
+
+    std::unique_ptr<MUS> tune(new MUS());
+    tune->tryLoad(dataBuf, dataLen, nullptr, 0, 0, voice3Index, init);
+    tune->checkSize(dataLen);
+
+    return tune.release();
 }
 
 SidTuneBase* MUS::load(buffer_t& musBuf,
@@ -186,14 +220,14 @@ SidTuneBase* MUS::load(buffer_t& musBuf,
         return nullptr;
 
     std::unique_ptr<MUS> tune(new MUS());
-    tune->tryLoad(musBuf, strBuf, fileOffset, voice3Index, init);
+    tune->tryLoad(musBuf.data(), musBuf.size(), strBuf.data(), strBuf.size(), fileOffset, voice3Index, init);
     tune->mergeParts(musBuf, strBuf);
 
     return tune.release();
 }
 
-void MUS::tryLoad(const buffer_t& musBuf,
-                    const buffer_t& strBuf,
+void MUS::tryLoad(const uint8_t* musBuf, uint_least32_t musLen,
+                    const uint8_t* strBuf, uint_least32_t strLen,
                     uint_least32_t fileOffset,
                     uint_least32_t voice3Index,
                     bool init)
@@ -226,7 +260,7 @@ void MUS::tryLoad(const buffer_t& musBuf,
         }
     }
 
-    musDataLen = musBuf.size();
+    musDataLen = musLen;
     info->m_loadAddr = SIDTUNE_MUS_DATA_ADDR;
 
     SmartPtr_sidtt<const uint8_t> spPet(&musBuf[fileOffset], musDataLen - fileOffset);
@@ -245,11 +279,11 @@ void MUS::tryLoad(const buffer_t& musBuf,
     // If we appear to have additional data at the end, check is it's
     // another mus file (but only if a second file isn't supplied)
     bool stereo = false;
-    if (!strBuf.empty())
+    if (strLen != 0)
     {
-        if (!detect(&strBuf[0], strBuf.size(), voice3Index))
+        if (!detect(strBuf, strLen, voice3Index))
             throw loadError(ERR_2ND_INVALID);
-        spPet.setBuffer(&strBuf[0], strBuf.size());
+        spPet.setBuffer(strBuf, strLen);
         stereo = true;
     }
     else
@@ -37,10 +37,12 @@ private:
     uint_least16_t musDataLen;
 
 private:
+    void checkSize(uint_least32_t mergeLen) const;
+
     bool mergeParts(buffer_t& musBuf, buffer_t& strBuf) const;
 
-    void tryLoad(const buffer_t& musBuf,
-                    const buffer_t& strBuf,
+    void tryLoad(const uint8_t* musBuf, uint_least32_t musLen,
+                    const uint8_t* strBuf, uint_least32_t strLen,
                     uint_least32_t fileOffset,
                     uint_least32_t voice3Index,
                     bool init);
@@ -53,18 +55,29 @@ protected:
     void setPlayerAddress();
 
     void acceptSidTune(const char* dataFileName, const char* infoFileName,
-                                buffer_t& buf, bool isSlashedFileName) override;
+                                data_t data, uint_least32_t dataLen, bool isSlashedFileName) override;
 
 public:
     ~MUS() override = default;
 
-    static SidTuneBase* load(buffer_t& dataBuf, bool init = false);
+    static SidTuneBase* load(const uint8_t* dataBuf, uint_least32_t dataLen, bool init = false);
     static SidTuneBase* load(buffer_t& musBuf,
                                 buffer_t& strBuf,
                                 uint_least32_t fileOffset,
                                 bool init = false);
 
-    void placeSidTuneInC64mem(sidmemory& mem) override;
+    /**
+     * Get the offsets following the data of each voice,
+     * the last one is where the credits start.
+     *
+     * @param header the start of the file
+     * @param fileLen the length of the whole file
+     * @param voiceEnds the offsets
+     * @return false if the voices don't fit in the file
+     */
+    static bool voiceEnds(const buffer_t& header, uint_least32_t fileLen, uint_least32_t voiceEnds[3]);
+
+    void placeSidTuneInC64mem(sidmemory& mem) const override;
 
 private:
     // prevent copying
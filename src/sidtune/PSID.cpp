@@ -22,6 +22,7 @@
 
 #include "PSID.h"
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <memory>
@@ -143,10 +144,10 @@ bool validateAddress(uint_least8_t address)
     return true;
 }
 
-SidTuneBase* PSID::load(buffer_t& dataBuf)
+SidTuneBase* PSID::load(const uint8_t* dataBuf, uint_least32_t dataLen)
 {
     // File format check
-    if (dataBuf.size() < 4)
+    if (dataLen < 4)
     {
         return nullptr;
     }
@@ -159,7 +160,7 @@ SidTuneBase* PSID::load(buffer_t& dataBuf)
     }
 
     psidHeader pHeader;
-    readHeader(dataBuf, pHeader);
+    readHeader(dataBuf, dataLen, pHeader);
 
     std::unique_ptr<PSID> tune(new PSID());
     tune->tryLoad(pHeader);
@@ -167,12 +168,12 @@ SidTuneBase* PSID::load(buffer_t& dataBuf)
     return tune.release();
 }
 
-void PSID::readHeader(const buffer_t &dataBuf, psidHeader &hdr)
+void PSID::readHeader(const uint8_t* dataBuf, uint_least32_t dataLen, psidHeader &hdr)
 {
     // Due to security concerns, input must be at least as long as version 1
     // header plus 16-bit C64 load address. That is the area which will be
     // accessed.
-    if (dataBuf.size() < (psid_headerSize + 2))
+    if (dataLen < (psid_headerSize + 2))
     {
         throw loadError(ERR_TRUNCATED);
     }
@@ -194,7 +195,7 @@ void PSID::readHeader(const buffer_t &dataBuf, psidHeader &hdr)
 
     if (hdr.version >= 2)
     {
-        if (dataBuf.size() < (psidv2_headerSize + 2))
+        if (dataLen < (psidv2_headerSize + 2))
         {
             throw loadError(ERR_TRUNCATED);
         }
@@ -359,39 +360,25 @@ void PSID::tryLoad(const psidHeader &pHeader)
         throw loadError("Compute!'s Sidplayer MUS data is not supported yet"); // TODO
 }
 
-const char *PSID::createMD5(char *md5)
+void PSID::md5Trailer(std::vector<uint8_t> &trailer)
 {
-    if (md5 == nullptr)
-        md5 = m_md5;
-
-    *md5 = '\0';
-
-    // Include C64 data.
-    sidmd5 myMD5;
-    myMD5.append(&m_cache[m_fileOffset], info->m_c64dataLen);
+    trailer.clear();
 
     uint8_t tmp[2];
     // Include INIT and PLAY address.
     endian_little16(tmp, info->m_initAddr);
-    myMD5.append(tmp, sizeof(tmp));
+    trailer.insert(trailer.end(), tmp, tmp + sizeof(tmp));
     endian_little16(tmp, info->m_playAddr);
-    myMD5.append(tmp, sizeof(tmp));
+    trailer.insert(trailer.end(), tmp, tmp + sizeof(tmp));
 
     // Include number of songs.
     endian_little16(tmp, info->m_songs);
-    myMD5.append(tmp, sizeof(tmp));
+    trailer.insert(trailer.end(), tmp, tmp + sizeof(tmp));
 
+    // Include song speed for each song.
+    for (unsigned int s = 1; s <= info->m_songs; s++)
     {
-        // Include song speed for each song.
-        const unsigned int currentSong = info->m_currentSong;
-        for (unsigned int s = 1; s <= info->m_songs; s++)
-        {
-            selectSong(s);
-            const uint8_t songSpeed = static_cast<uint8_t>(info->m_songSpeed);
-            myMD5.append(&songSpeed, sizeof(songSpeed));
-        }
-        // Restore old song
-        selectSong(currentSong);
+        trailer.push_back(static_cast<uint8_t>(songSpeed(s)));
     }
 
     // Deal with PSID v2NG clock speed flags: Let only NTSC
@@ -400,8 +387,7 @@ const char *PSID::createMD5(char *md5)
     // PSID v2NG format is the same.
     if (info->m_clockSpeed == SidTuneInfo::CLOCK_NTSC)
     {
-        const uint8_t ntsc_val = 2;
-        myMD5.append(&ntsc_val, sizeof(ntsc_val));
+        trailer.push_back(2);
     }
 
     // NB! If the fingerprint is used as an index into a
@@ -412,30 +398,82 @@ const char *PSID::createMD5(char *md5)
     // either create two different fingerprints depending on
     // the clock speed chosen by the player, or there could be
     // two different values stored in the database/cache.
+}
+
+void PSID::computeMD5()
+{
+    sidmd5 md5Old;
+    sidmd5 md5New;
+
+    // The new method hashes the whole file,
+    // the old one only the C64 data,
+    // feed both while the chunk is in cache
+    constexpr size_t CHUNK = 4096;
+    const size_t dataStart = m_fileOffset;
+    const size_t dataEnd = m_fileOffset + info->m_c64dataLen;
+    for (size_t pos = 0; pos < m_dataLen; pos += CHUNK)
+    {
+        const size_t end = std::min<size_t>(pos + CHUNK, m_dataLen);
+        md5New.append(m_data.get() + pos, end - pos);
 
-    // Get fingerprint.
-    myMD5.getDigest().copy(md5, SidTune::MD5_LENGTH);
-    md5[SidTune::MD5_LENGTH] = '\0';
+        const size_t start = std::max(pos, dataStart);
+        const size_t stop = std::min(end, dataEnd);
+        if (start < stop)
+            md5Old.append(m_data.get() + start, stop - start);
+    }
 
-    return md5;
+    std::vector<uint8_t> trailer;
+    md5Trailer(trailer);
+    md5Old.append(trailer.data(), trailer.size());
+
+    // Get fingerprints.
+    md5Old.getDigest().copy(m_md5, SidTune::MD5_LENGTH);
+    m_md5[SidTune::MD5_LENGTH] = '\0';
+    md5New.getDigest().copy(m_md5New, SidTune::MD5_LENGTH);
+    m_md5New[SidTune::MD5_LENGTH] = '\0';
+
+    m_md5Valid = true;
 }
 
-const char *PSID::createMD5New(char *md5)
+bool PSID::md5Messages(hashlib::md5_message &oldMsg, hashlib::md5_message &newMsg, std::vector<uint8_t> &trailer)
 {
+    if (m_md5Valid)
+        return false;
+
+    md5Trailer(trailer);
+    oldMsg = { m_data.get() + m_fileOffset, info->m_c64dataLen, trailer.data(), trailer.size() };
+    newMsg = { m_data.get(), m_dataLen, nullptr, 0 };
+    return true;
+}
+
+void PSID::setMD5(const char *md5, const char *md5New)
+{
+    std::memcpy(m_md5, md5, sizeof(m_md5));
+    std::memcpy(m_md5New, md5New, sizeof(m_md5New));
+    m_md5Valid = true;
+}
+
+const char *PSID::createMD5(char *md5)
+{
+    if (!m_md5Valid)
+        computeMD5();
+
     if (md5 == nullptr)
-        md5 = m_md5;
+        return m_md5;
 
-    *md5 = '\0';
+    std::memcpy(md5, m_md5, sizeof(m_md5));
+    return md5;
+}
 
-    // The calculation is now simplified
-    // All the header + all the data
-    sidmd5 myMD5;
-    myMD5.append(&m_cache[0], m_cache.size());
+const char *PSID::createMD5New(char *md5)
+{
+    if (!m_md5Valid)
+        computeMD5();
 
-    // Get fingerprint.
-    myMD5.getDigest().copy(md5, SidTune::MD5_LENGTH);
-    md5[SidTune::MD5_LENGTH] = '\0';
+    if (md5 == nullptr)
+        return m_md5New;
 
+    std::memcpy(md5, m_md5New, sizeof(m_md5New));
     return md5;
 }
 
@@ -37,9 +37,25 @@ struct psidHeader;
 class PSID final : public SidTuneBase
 {
 private:
+    /// Old method fingerprint, computed on first use
     char m_md5[SidTune::MD5_LENGTH+1];
 
+    /// New method fingerprint, computed on first use
+    char m_md5New[SidTune::MD5_LENGTH+1];
+
+    bool m_md5Valid = false;
+
 private:
+    /**
+     * Compute both fingerprints in a single pass over the file.
+     */
+    void computeMD5();
+
+    /**
+     * Get the data hashed after the C64 data by the old method.
+     */
+    void md5Trailer(std::vector<uint8_t> &trailer);
+
     /**
      * Load PSID file.
      *
@@ -52,7 +68,7 @@ private:
      *
      * @throw loadError
      */
-    static void readHeader(const buffer_t &dataBuf, psidHeader &hdr);
+    static void readHeader(const uint8_t* dataBuf, uint_least32_t dataLen, psidHeader &hdr);
 
 protected:
     PSID() {}
@@ -64,12 +80,16 @@ public:
      * @return pointer to a SidTune or 0 if not a PSID file
      * @throw loadError if PSID file is corrupt
      */
-    static SidTuneBase* load(buffer_t& dataBuf);
+    static SidTuneBase* load(const uint8_t* dataBuf, uint_least32_t dataLen);
 
     const char *createMD5(char *md5) override;
 
     const char *createMD5New(char *md5) override;
 
+    bool md5Messages(hashlib::md5_message &oldMsg, hashlib::md5_message &newMsg, std::vector<uint8_t> &trailer) override;
+
+    void setMD5(const char *md5, const char *md5New) override;
+
 private:
     // prevent copying
     PSID(const PSID&) = delete;
@@ -29,6 +29,7 @@
 #include <algorithm>
 #include <iterator>
 #include <fstream>
+#include <utility>
 
 #include "SmartPtr.h"
 #include "SidTuneTools.h"
@@ -36,6 +37,7 @@
 #include "sidendian.h"
 #include "sidmemory.h"
 #include "stringutils.h"
+#include "mappedfile.h"
 
 #include "MUS.h"
 #include "p00.h"
@@ -108,42 +110,202 @@ SidTuneBase* SidTuneBase::load(LoaderFunc loader, const char* fileName,
     return getFromFiles(loader, fileName, fileNameExt, separatorIsSlash);
 }
 
+/**
+ * Random access to a file or a buffer,
+ * so that a probe reads only the bytes it needs.
+ */
+class headReader
+{
+private:
+    std::ifstream m_file;
+
+    const uint_least8_t* m_buffer;
+
+    uint_least32_t m_size;
+
+public:
+    explicit headReader(const char* fileName) :
+        m_buffer(nullptr)
+    {
+        // Unbuffered, don't read ahead
+        m_file.rdbuf()->pubsetbuf(nullptr, 0);
+        m_file.open(fileName, std::ifstream::binary);
+
+        if (!m_file.is_open())
+        {
+            throw loadError(ERR_CANT_OPEN_FILE);
+        }
+
+        m_file.seekg(0, m_file.end);
+        const std::streamoff fileLen = m_file.tellg();
+
+        if (fileLen <= 0)
+        {
+            throw loadError(ERR_EMPTY);
+        }
+
+        if (fileLen > UINT_LEAST32_MAX)
+        {
+            throw loadError(ERR_FILE_TOO_LONG);
+        }
+
+        m_size = static_cast<uint_least32_t>(fileLen);
+    }
+
+    headReader(const uint_least8_t* buffer, uint_least32_t bufferLen) :
+        m_buffer(buffer),
+        m_size(bufferLen) {}
+
+    uint_least32_t size() const { return m_size; }
+
+    /**
+     * Copy [offset, offset + count) to the same position in head,
+     * growing it as needed.
+     *
+     * @throw loadError
+     */
+    void read(std::vector<uint8_t>& head, uint_least32_t offset, uint_least32_t count)
+    {
+        if (offset >= m_size)
+            return;
+
+        count = std::min(count, m_size - offset);
+
+        if (head.size() < offset + count)
+            head.resize(offset + count, 0);
+
+        if (m_buffer != nullptr)
+        {
+            std::memcpy(&head[offset], m_buffer + offset, count);
+        }
+        else
+        {
+            m_file.seekg(offset);
+            if (!m_file.read(reinterpret_cast<char*>(&head[offset]), count))
+            {
+                throw loadError(ERR_CANT_LOAD_FILE);
+            }
+        }
+    }
+};
+
+SidTuneBase* SidTuneBase::probe(const char* fileName, bool separatorIsSlash)
+{
+    if (fileName == nullptr)
+        return nullptr;
+
+    headReader reader(fileName);
+    return probeHead(reader, fileName, separatorIsSlash);
+}
+
+SidTuneBase* SidTuneBase::probe(const uint_least8_t* sourceBuffer, uint_least32_t bufferLen)
+{
+    if (sourceBuffer == nullptr || bufferLen == 0)
+    {
+        throw loadError(ERR_EMPTY);
+    }
+
+    if (bufferLen > MAX_FILELEN)
+    {
+        throw loadError(ERR_FILE_TOO_LONG);
+    }
+
+    headReader reader(sourceBuffer, bufferLen);
+    return probeHead(reader, nullptr, false);
+}
+
+SidTuneBase* SidTuneBase::probeHead(headReader& reader, const char* fileName, bool separatorIsSlash)
+{
+    /// PSID v2 header + load address + 2 bytes for the fixLoad check
+    constexpr uint_least32_t HEAD_SIZE = 0x7C + 4;
+
+    buffer_t head;
+    reader.read(head, 0, HEAD_SIZE);
+
+    // Same order as when loading the whole file.
+    std::unique_ptr<SidTuneBase> s(PSID::load(head.data(), head.size()));
+    if (s.get() == nullptr)
+    {
+        // The credits follow the voice data,
+        // the MUS detection needs the end of each voice.
+        uint_least32_t voiceEnds[3];
+        if (MUS::voiceEnds(head, reader.size(), voiceEnds))
+        {
+            for (uint_least32_t end: voiceEnds)
+                reader.read(head, end - 2, 2);
+            reader.read(head, voiceEnds[2], reader.size() - voiceEnds[2]);
+
+            s.reset(MUS::load(head.data(), head.size(), true));
+        }
+    }
+    if (fileName != nullptr)
+    {
+        if (s.get() == nullptr) s.reset(p00::load(fileName, head.data(), head.size()));
+        if (s.get() == nullptr) s.reset(prg::load(fileName, head.data(), head.size()));
+    }
+    if (s.get() == nullptr) throw loadError(ERR_UNRECOGNIZED_FORMAT);
+
+    // The start of the C64 data may hold the load address.
+    const uint_least32_t dataStart = s->m_fileOffset;
+    reader.read(head, dataStart, 4);
+    if (head.size() < dataStart + 4)
+        head.resize(dataStart + 4, 0);
+
+    if (fileName != nullptr)
+        s->acceptInfo(fileName, nullptr, head.data(), reader.size(), separatorIsSlash);
+    else
+        s->acceptInfo("-", "-", head.data(), reader.size(), false);
+
+    return s.release();
+}
+
 unsigned int SidTuneBase::selectSong(unsigned int songNum)
 {
-    // Check whether selected song is valid, use start song if not
-    const unsigned int song = (songNum == 0 || songNum > info->m_songs) ? info->m_startSong : songNum;
+    const unsigned int song = songNumber(songNum);
 
     // Copy any song-specific variable information
     // such a speed/clock setting to the info structure.
     info->m_currentSong = song;
+    info->m_songSpeed = songSpeed(song);
+    info->m_clockSpeed = m_clockSpeed[song - 1];
 
+    return info->m_currentSong;
+}
+
+void SidTuneBase::songInfo(unsigned int songNum, SidTuneSongInfo& songInfo) const
+{
+    const unsigned int song = songNumber(songNum);
+    songInfo.set(info.get(), song, songSpeed(song), m_clockSpeed[song - 1]);
+}
+
+unsigned int SidTuneBase::songNumber(unsigned int songNum) const
+{
+    // Check whether selected song is valid, use start song if not
+    return (songNum == 0 || songNum > info->m_songs) ? info->m_startSong : songNum;
+}
+
+int SidTuneBase::songSpeed(unsigned int song) const
+{
     // Retrieve song speed definition.
     switch (info->m_compatibility)
     {
     case SidTuneInfo::COMPATIBILITY_R64:
-        info->m_songSpeed = SidTuneInfo::SPEED_CIA_1A;
-        break;
+        return SidTuneInfo::SPEED_CIA_1A;
     case SidTuneInfo::COMPATIBILITY_PSID:
         // This does not take into account the PlaySID bug upon evaluating the
         // SPEED field. It would most likely break compatibility to lots of
         // sidtunes, which have been converted from .SID format and vice versa.
         // The .SID format does the bit-wise/song-wise evaluation of the SPEED
         // value correctly, like it is described in the PlaySID documentation.
-        info->m_songSpeed = m_songSpeed[(song - 1) & 31];
-        break;
+        return m_songSpeed[(song - 1) & 31];
     default:
-        info->m_songSpeed = m_songSpeed[song - 1];
-        break;
+        return m_songSpeed[song - 1];
     }
-
-    info->m_clockSpeed = m_clockSpeed[song - 1];
-
-    return info->m_currentSong;
 }
 
 // ------------------------------------------------- private member functions
 
-void SidTuneBase::placeSidTuneInC64mem(sidmemory& mem)
+void SidTuneBase::placeSidTuneInC64mem(sidmemory& mem) const
 {
     // The Basic ROM sets these values on loading a file.
     // Program end address
@@ -155,8 +317,9 @@ void SidTuneBase::placeSidTuneInC64mem(sidmemory& mem)
     mem.writeMemWord(0xac, start);
     mem.writeMemWord(0xae, end);
 
-    // Copy data from cache to the correct destination.
-    mem.fillRam(info->m_loadAddr, &m_cache[m_fileOffset], info->m_c64dataLen);
+    // Copy data from the file to the correct destination,
+    // the only copy made of it.
+    mem.fillRam(info->m_loadAddr, m_data.get() + m_fileOffset, info->m_c64dataLen);
 }
 
 void SidTuneBase::loadFile(const char* fileName, buffer_t& bufferRef)
@@ -200,9 +363,42 @@ void SidTuneBase::loadFile(const char* fileName, buffer_t& bufferRef)
     bufferRef.swap(fileBuf);
 }
 
+SidTuneBase::data_t SidTuneBase::mapFile(const char* fileName, uint_least32_t& fileLen)
+{
+    std::shared_ptr<mappedFile> file = std::make_shared<mappedFile>();
+
+    if (!file->open(fileName))
+    {
+        throw loadError(ERR_CANT_OPEN_FILE);
+    }
+
+    if (file->size() == 0)
+    {
+        throw loadError(ERR_EMPTY);
+    }
+
+    if (file->size() > MAX_FILELEN)
+    {
+        throw loadError(ERR_FILE_TOO_LONG);
+    }
+
+    fileLen = file->size();
+
+    // The data keeps the mapping alive
+    return data_t(file, file->data());
+}
+
+SidTuneBase::data_t SidTuneBase::shareBuffer(buffer_t& buf)
+{
+    std::shared_ptr<buffer_t> shared = std::make_shared<buffer_t>();
+    shared->swap(buf);
+    return data_t(shared, shared->data());
+}
+
 SidTuneBase::SidTuneBase() :
     info(new SidTuneInfoImpl()),
-    m_fileOffset(0)
+    m_fileOffset(0),
+    m_dataLen(0)
 {
     // Initialize the object with some safe defaults.
     for (unsigned int si = 0; si < MAX_SONGS; si++)
@@ -226,14 +422,15 @@ SidTuneBase* SidTuneBase::getFromStdIn()
         fileBuf.push_back((uint_least8_t)datb);
     }
 
-    return getFromBuffer(&fileBuf.front(), fileBuf.size());
+    const uint_least32_t fileLen = fileBuf.size();
+    return getFromBuffer(shareBuffer(fileBuf), fileLen);
 }
 
 #endif
 
-SidTuneBase* SidTuneBase::getFromBuffer(const uint_least8_t* const buffer, uint_least32_t bufferLen)
+SidTuneBase* SidTuneBase::read(const uint_least8_t* sourceBuffer, uint_least32_t bufferLen)
 {
-    if (buffer == nullptr || bufferLen == 0)
+    if (sourceBuffer == nullptr || bufferLen == 0)
     {
         throw loadError(ERR_EMPTY);
     }
@@ -243,19 +440,42 @@ SidTuneBase* SidTuneBase::getFromBuffer(const uint_least8_t* const buffer, uint_
         throw loadError(ERR_FILE_TOO_LONG);
     }
 
-    buffer_t buf1(buffer, buffer + bufferLen);
+    buffer_t buf1(sourceBuffer, sourceBuffer + bufferLen);
+    return getFromBuffer(shareBuffer(buf1), bufferLen);
+}
+
+SidTuneBase* SidTuneBase::getFromBuffer(data_t buffer, uint_least32_t bufferLen)
+{
+    if (buffer == nullptr || bufferLen == 0)
+    {
+        throw loadError(ERR_EMPTY);
+    }
+
+    if (bufferLen > MAX_FILELEN)
+    {
+        throw loadError(ERR_FILE_TOO_LONG);
+    }
 
     // Here test for the possible single file formats.
-    std::unique_ptr<SidTuneBase> s(PSID::load(buf1));
-    if (s.get() == nullptr) s.reset(MUS::load(buf1, true));
+    std::unique_ptr<SidTuneBase> s(PSID::load(buffer.get(), bufferLen));
+    if (s.get() == nullptr) s.reset(MUS::load(buffer.get(), bufferLen, true));
     if (s.get() == nullptr) throw loadError(ERR_UNRECOGNIZED_FORMAT);
 
-    s->acceptSidTune("-", "-", buf1, false);
+    s->acceptSidTune("-", "-", std::move(buffer), bufferLen, false);
     return s.release();
 }
 
 void SidTuneBase::acceptSidTune(const char* dataFileName, const char* infoFileName,
-                            buffer_t& buf, bool isSlashedFileName)
+                            data_t data, uint_least32_t dataLen, bool isSlashedFileName)
+{
+    acceptInfo(dataFileName, infoFileName, data.get(), dataLen, isSlashedFileName);
+
+    m_data = std::move(data);
+    m_dataLen = dataLen;
+}
+
+void SidTuneBase::acceptInfo(const char* dataFileName, const char* infoFileName,
+                            const uint8_t* buf, uint_least32_t fileLen, bool isSlashedFileName)
 {
     // Make a copy of the data file name and path, if available.
     if (dataFileName != nullptr)
@@ -292,8 +512,14 @@ void SidTuneBase::acceptSidTune(const char* dataFileName, const char* infoFileNa
         info->m_startSong = 1;
     }
 
-    info->m_dataFileLen = buf.size();
-    info->m_c64dataLen = buf.size() - m_fileOffset;
+    // The header may point past the end of the file.
+    if (m_fileOffset > fileLen)
+    {
+        throw loadError(ERR_TRUNCATED);
+    }
+
+    info->m_dataFileLen = fileLen;
+    info->m_c64dataLen = fileLen - m_fileOffset;
 
     // Calculate any remaining addresses and then
     // confirm all the file details are correct
@@ -308,7 +534,8 @@ void SidTuneBase::acceptSidTune(const char* dataFileName, const char* infoFileNa
          throw loadError(ERR_BAD_ADDR);
     }
 
-    if (info->m_dataFileLen >= 2)
+    // The file may be mapped, don't read past its end.
+    if (info->m_c64dataLen >= 2)
     {
         // We only detect an offset of two. Some position independent
         // sidtunes contain a load address of 0xE000, but are loaded
@@ -325,8 +552,6 @@ void SidTuneBase::acceptSidTune(const char* dataFileName, const char* infoFileNa
     {
         throw loadError(ERR_EMPTY);
     }
-
-    m_cache.swap(buf);
 }
 
 void SidTuneBase::createNewFileName(std::string& destString,
@@ -342,21 +567,38 @@ void SidTuneBase::createNewFileName(std::string& destString,
 
 SidTuneBase* SidTuneBase::getFromFiles(LoaderFunc loader, const char* fileName, const char **fileNameExtensions, bool separatorIsSlash)
 {
-    buffer_t fileBuf1;
+    data_t fileData;
+    uint_least32_t fileLen;
 
     if (loader == nullptr)
+    {
+        // Map the file instead of reading it,
+        // companion files are read
+        fileData = mapFile(fileName, fileLen);
         loader = (LoaderFunc) loadFile;
+    }
+    else
+    {
+        buffer_t fileBuf;
+        loader(fileName, fileBuf);
+        fileLen = fileBuf.size();
+        fileData = shareBuffer(fileBuf);
+    }
 
-    loader(fileName, fileBuf1);
+    const uint8_t* fileBuf = fileData.get();
 
     // File loaded. Now check if it is in a valid single-file-format.
-    std::unique_ptr<SidTuneBase> s(PSID::load(fileBuf1));
+    std::unique_ptr<SidTuneBase> s(PSID::load(fileBuf, fileLen));
     if (s.get() == nullptr)
     {
         // Try some native C64 file formats
-        s.reset(MUS::load(fileBuf1, true));
+        s.reset(MUS::load(fileBuf, fileLen, true));
         if (s.get() != nullptr)
         {
+            // The two parts get merged,
+            // only this case needs a copy of the file.
+            buffer_t fileBuf1(fileBuf, fileBuf + fileLen);
+
             // Try to find second file.
             std::string fileName2;
             int n = 0;
@@ -373,13 +615,19 @@ SidTuneBase* SidTuneBase::getFromFiles(LoaderFunc loader, const char* fileName,
                         buffer_t fileBuf2;
 
                         loader(fileName2.c_str(), fileBuf2);
+                        // Custom loaders leave the buffer empty for missing files
+                        if (fileBuf2.empty())
+                        {
+                            throw loadError(ERR_EMPTY);
+                        }
                         // Check if tunes in wrong order and therefore swap them here
                         if (stringutils::equal(fileNameExtensions[n], ".mus"))
                         {
                             std::unique_ptr<SidTuneBase> s2(MUS::load(fileBuf2, fileBuf1, 0, true));
                             if (s2.get() != nullptr)
                             {
-                                s2->acceptSidTune(fileName2.c_str(), fileName, fileBuf2, separatorIsSlash);
+                                const uint_least32_t mergedLen = fileBuf2.size();
+                                s2->acceptSidTune(fileName2.c_str(), fileName, shareBuffer(fileBuf2), mergedLen, separatorIsSlash);
                                 return s2.release();
                             }
                         }
@@ -388,7 +636,8 @@ SidTuneBase* SidTuneBase::getFromFiles(LoaderFunc loader, const char* fileName,
                             std::unique_ptr<SidTuneBase> s2(MUS::load(fileBuf1, fileBuf2, 0, true));
                             if (s2.get() != nullptr)
                             {
-                                s2->acceptSidTune(fileName, fileName2.c_str(), fileBuf1, separatorIsSlash);
+                                const uint_least32_t mergedLen = fileBuf1.size();
+                                s2->acceptSidTune(fileName, fileName2.c_str(), shareBuffer(fileBuf1), mergedLen, separatorIsSlash);
                                 return s2.release();
                             }
                         }
@@ -401,11 +650,11 @@ SidTuneBase* SidTuneBase::getFromFiles(LoaderFunc loader, const char* fileName,
             }
         }
     }
-    if (s.get() == nullptr) s.reset(p00::load(fileName, fileBuf1));
-    if (s.get() == nullptr) s.reset(prg::load(fileName, fileBuf1));
+    if (s.get() == nullptr) s.reset(p00::load(fileName, fileBuf, fileLen));
+    if (s.get() == nullptr) s.reset(prg::load(fileName, fileBuf, fileLen));
     if (s.get() == nullptr) throw loadError(ERR_UNRECOGNIZED_FORMAT);
 
-    s->acceptSidTune(fileName, nullptr, fileBuf1, separatorIsSlash);
+    s->acceptSidTune(fileName, nullptr, std::move(fileData), fileLen, separatorIsSlash);
     return s.release();
 }
 
@@ -33,13 +33,20 @@
 
 #include "SmartPtr.h"
 #include "SidTuneInfoImpl.h"
+#include "SidTuneSongInfo.h"
 
 #include "sidcxx11.h"
 
+namespace hashlib
+{
+struct md5_message;
+}
+
 namespace libsidplayfp
 {
 
 class sidmemory;
+class headReader;
 template <class T> class SmartPtr_sidtt;
 
 /**
@@ -62,6 +69,9 @@ class SidTuneBase
 protected:
     using buffer_t = std::vector<uint8_t>;
 
+    /// Read-only file data, shared with its owner
+    using data_t = std::shared_ptr<const uint8_t>;
+
 protected:
     /// Also PSID file format limit.
     static constexpr unsigned int MAX_SONGS = 256;
@@ -114,6 +124,7 @@ public:  // ----------------------------------------------------------------
 
     /**
      * Load a single-file sidtune from a memory buffer.
+     * The buffer is copied.
      * Currently supported: PSID format
      *
      * @param sourceBuffer
@@ -121,11 +132,53 @@ public:  // ----------------------------------------------------------------
      * @return the sid tune
      * @throw loadError
      */
-    static SidTuneBase* read(const uint_least8_t* sourceBuffer, uint_least32_t bufferLen)
+    static SidTuneBase* read(const uint_least8_t* sourceBuffer, uint_least32_t bufferLen);
+
+    /**
+     * Load a single-file sidtune from a shared memory buffer,
+     * the tune keeps a reference instead of a copy.
+     * Currently supported: PSID and MUS formats.
+     *
+     * @param sourceBuffer
+     * @param bufferLen
+     * @return the sid tune
+     * @throw loadError
+     */
+    static SidTuneBase* read(data_t sourceBuffer, uint_least32_t bufferLen)
     {
-        return getFromBuffer(sourceBuffer, bufferLen);
+        return getFromBuffer(std::move(sourceBuffer), bufferLen);
     }
 
+    /**
+     * Read the tune information from the file header only.
+     * The C64 data is not loaded and companion files are not
+     * looked for.
+     * Currently supported: PSID, MUS, P00 and PRG formats.
+     *
+     * @param fileName
+     * @param separatorIsSlash
+     * @return the sid tune, without C64 data
+     * @throw loadError
+     */
+    static SidTuneBase* probe(const char* fileName, bool separatorIsSlash);
+
+    /**
+     * Read the tune information of a single-file sidtune
+     * from a memory buffer, see above.
+     * Currently supported: PSID and MUS formats.
+     *
+     * @param sourceBuffer
+     * @param bufferLen
+     * @return the sid tune, without C64 data
+     * @throw loadError
+     */
+    static SidTuneBase* probe(const uint_least8_t* sourceBuffer, uint_least32_t bufferLen);
+
+    /**
+     * Whether only the header was read by #probe.
+     */
+    bool headerOnly() const { return m_data == nullptr; }
+
     /**
      * Select sub-song (0 = default starting song)
      * and return active song number out of [1,2,..,SIDTUNE_MAX_SONGS].
@@ -140,6 +193,15 @@ public:  // ----------------------------------------------------------------
      */
     const SidTuneInfo* getInfo() const { return info.get(); }
 
+    /**
+     * Retrieve the information of a sub-song without selecting it,
+     * the tune is not modified.
+     *
+     * @param songNum the song (0 = default starting song)
+     * @param songInfo set to the song information
+     */
+    void songInfo(unsigned int songNum, SidTuneSongInfo& songInfo) const;
+
     /**
      * Select sub-song (0 = default starting song)
      * and retrieve active song information.
@@ -157,7 +219,7 @@ public:  // ----------------------------------------------------------------
      *
      * @param mem
      */
-    virtual void placeSidTuneInC64mem(sidmemory& mem);
+    virtual void placeSidTuneInC64mem(sidmemory& mem) const;
 
     /**
      * Calculates the MD5 hash of the tune.
@@ -177,10 +239,25 @@ public:  // ----------------------------------------------------------------
      */
     virtual const char *createMD5New(char *) { return nullptr; }
 
+    /**
+     * Get the messages hashed by #createMD5 and #createMD5New.
+     *
+     * @param oldMsg set to the old method message
+     * @param newMsg set to the new method message
+     * @param trailer storage for the end of the old method message
+     * @return false if the hashes are already cached or not supported
+     */
+    virtual bool md5Messages(hashlib::md5_message &, hashlib::md5_message &, std::vector<uint8_t> &) { return false; }
+
+    /**
+     * Cache hashes computed from #md5Messages.
+     */
+    virtual void setMD5(const char *, const char *) {}
+
     /**
      * Get the pointer to the tune data.
      */
-    const uint_least8_t* c64Data() const { return &m_cache[m_fileOffset]; }
+    const uint_least8_t* c64Data() const { return m_data.get() + m_fileOffset; }
 
 protected:  // -------------------------------------------------------------
 
@@ -192,7 +269,11 @@ protected:  // -------------------------------------------------------------
     /// For files with header: offset to real data
     uint_least32_t m_fileOffset;
 
-    buffer_t m_cache;
+    /// The whole file, mapped or shared with the caller
+    data_t m_data;
+
+    /// Length of the file data
+    uint_least32_t m_dataLen;
 
 protected:
     SidTuneBase();
@@ -207,6 +288,33 @@ protected:
      */
     static void loadFile(const char* fileName, buffer_t& bufferRef);
 
+    /**
+     * Map a file read-only, it is read into memory
+     * where mapping is not supported.
+     *
+     * @param fileName
+     * @param fileLen the length of the file
+     * @return the file data
+     * @throw loadError
+     */
+    static data_t mapFile(const char* fileName, uint_least32_t& fileLen);
+
+    /**
+     * Move a buffer into shared file data.
+     */
+    static data_t shareBuffer(buffer_t& buf);
+
+    /**
+     * Get the song number, the start song
+     * for 0 or an invalid number.
+     */
+    unsigned int songNumber(unsigned int songNum) const;
+
+    /**
+     * Get the speed of a song.
+     */
+    int songSpeed(unsigned int song) const;
+
     /**
      * Convert 32-bit PSID-style speed word to internal tables.
      *
@@ -239,7 +347,8 @@ protected:
      *
      * @param dataFileName
      * @param infoFileName
-     * @param buf
+     * @param data the whole file
+     * @param dataLen the length of the file
      * @param isSlashedFileName If your opendir() and readdir()->d_name return path names
      * that contain the forward slash (/) as file separator, but
      * your operating system uses a different character, there are
@@ -251,7 +360,21 @@ protected:
      * @throw loadError
      */
     virtual void acceptSidTune(const char* dataFileName, const char* infoFileName,
-                        buffer_t& buf, bool isSlashedFileName);
+                        data_t data, uint_least32_t dataLen, bool isSlashedFileName);
+
+    /**
+     * Check the file details and store the file names,
+     * without caching the data.
+     *
+     * @param dataFileName
+     * @param infoFileName
+     * @param buf the file, at least up to 4 bytes into the C64 data
+     * @param fileLen the length of the whole file
+     * @param isSlashedFileName
+     * @throw loadError
+     */
+    void acceptInfo(const char* dataFileName, const char* infoFileName,
+                        const uint8_t* buf, uint_least32_t fileLen, bool isSlashedFileName);
 
     /**
      * Petscii to Ascii converter.
@@ -273,7 +396,16 @@ private:  // ---------------------------------------------------------------
     /**
      * Try to retrieve single-file sidtune from specified buffer.
      */
-    static SidTuneBase* getFromBuffer(const uint_least8_t* const buffer, uint_least32_t bufferLen);
+    static SidTuneBase* getFromBuffer(data_t buffer, uint_least32_t bufferLen);
+
+    /**
+     * Detect the format reading only the needed parts of the file.
+     *
+     * @param reader access to the file
+     * @param fileName the file name, null for a buffer
+     * @param separatorIsSlash
+     */
+    static SidTuneBase* probeHead(headReader& reader, const char* fileName, bool separatorIsSlash);
 
     /**
      * Get new file name with specified extension.
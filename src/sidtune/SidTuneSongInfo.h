@@ -0,0 +1,120 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef SIDTUNESONGINFO_H
+#define SIDTUNESONGINFO_H
+
+#include <cstdint>
+
+#include "sidplayfp/SidTuneInfo.h"
+
+#include "SidTuneInfoImpl.h"
+
+#include "sidcxx11.h"
+
+namespace libsidplayfp
+{
+
+/**
+ * The information of one sub-song of a tune.
+ * Refers to the tune information and only holds the
+ * song specific values, so several players can select
+ * different songs of a shared tune without modifying it.
+ */
+class SidTuneSongInfo final : public SidTuneInfo
+{
+private:
+    const SidTuneInfoImpl* m_info = nullptr;
+
+    unsigned int m_currentSong = 0;
+
+    int m_songSpeed = SPEED_VBI;
+
+    clock_t m_clockSpeed = CLOCK_UNKNOWN;
+
+public:
+    /**
+     * Set the song.
+     *
+     * @param info the tune information, must outlive this object
+     * @param song the song number
+     * @param songSpeed the song speed
+     * @param clockSpeed the song clock speed
+     */
+    void set(const SidTuneInfoImpl* info, unsigned int song, int songSpeed, clock_t clockSpeed)
+    {
+        m_info = info;
+        m_currentSong = song;
+        m_songSpeed = songSpeed;
+        m_clockSpeed = clockSpeed;
+    }
+
+    uint_least16_t getLoadAddr() const override { return m_info->m_loadAddr; }
+
+    uint_least16_t getInitAddr() const override { return m_info->m_initAddr; }
+
+    uint_least16_t getPlayAddr() const override { return m_info->m_playAddr; }
+
+    unsigned int getSongs() const override { return m_info->m_songs; }
+
+    unsigned int getStartSong() const override { return m_info->m_startSong; }
+
+    unsigned int getCurrentSong() const override { return m_currentSong; }
+
+    uint_least16_t getSidChipBase(unsigned int i) const override { return m_info->sidChipBase(i); }
+
+    int getSidChips() const override { return m_info->sidChips(); }
+
+    int getSongSpeed() const override { return m_songSpeed; }
+
+    uint_least8_t getRelocStartPage() const override { return m_info->m_relocStartPage; }
+
+    uint_least8_t getRelocPages() const override { return m_info->m_relocPages; }
+
+    model_t getSidModel(unsigned int i) const override { return m_info->sidModel(i); }
+
+    compatibility_t getCompatibility() const override { return m_info->m_compatibility; }
+
+    unsigned int getNumberOfInfoStrings() const override { return m_info->numberOfInfoStrings(); }
+    const char* getInfoString(unsigned int i) const override { return m_info->infoString(i); }
+
+    unsigned int getNumberOfCommentStrings() const override { return m_info->numberOfCommentStrings(); }
+    const char* getCommentString(unsigned int i) const override { return m_info->commentString(i); }
+
+    uint_least32_t getDataFileLen() const override { return m_info->m_dataFileLen; }
+
+    uint_least32_t getC64dataLen() const override { return m_info->m_c64dataLen; }
+
+    clock_t getClockSpeed() const override { return m_clockSpeed; }
+
+    const char* getFormatString() const override { return m_info->m_formatString; }
+
+    bool getFixLoad() const override { return m_info->m_fixLoad; }
+
+    const char* getPath() const override { return m_info->path(); }
+
+    const char* getDataFileName() const override { return m_info->dataFileName(); }
+
+    const char* getInfoFileName() const override { return m_info->infoFileName(); }
+};
+
+}
+
+#endif  /* SIDTUNESONGINFO_H */
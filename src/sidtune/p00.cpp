@@ -80,7 +80,7 @@ const char TXT_FORMAT_REL[] = "Unsupported tape image file (REL)";
 const char P00_ID[] = "C64File";
 
 
-SidTuneBase* p00::load(const char *fileName, const buffer_t& dataBuf)
+SidTuneBase* p00::load(const char *fileName, const uint8_t* dataBuf, uint_least32_t dataLen)
 {
     const char *ext = SidTuneTools::fileExtOfPath(fileName);
 
@@ -121,14 +121,11 @@ SidTuneBase* p00::load(const char *fileName, const buffer_t& dataBuf)
     }
 
     // Verify the file is what we think it is
-    const buffer_t::size_type bufLen = dataBuf.size();
-    if (bufLen < X00_ID_LEN)
+    if (dataLen < X00_ID_LEN)
         return nullptr;
 
     X00Header pHeader;
     std::memcpy(pHeader.id, &dataBuf[0], X00_ID_LEN);
-    std::memcpy(pHeader.name, &dataBuf[X00_ID_LEN], X00_NAME_LEN);
-    pHeader.length = dataBuf[X00_ID_LEN + X00_NAME_LEN];
 
     if (strcmp(pHeader.id, P00_ID))
         return nullptr;
@@ -137,9 +134,13 @@ SidTuneBase* p00::load(const char *fileName, const buffer_t& dataBuf)
     if (type != X00Format::PRG)
         throw loadError("Not a PRG inside X00");
 
-    if (bufLen < sizeof(X00Header) + 2)
+    // The file may be mapped, check before reading the rest of the header
+    if (dataLen < sizeof(X00Header) + 2)
         throw loadError(ERR_TRUNCATED);
 
+    std::memcpy(pHeader.name, &dataBuf[X00_ID_LEN], X00_NAME_LEN);
+    pHeader.length = dataBuf[X00_ID_LEN + X00_NAME_LEN];
+
     std::unique_ptr<p00> tune(new p00());
     tune->load(format, &pHeader);
 
@@ -35,7 +35,7 @@ namespace libsidplayfp
 // Format strings
 const char TXT_FORMAT_PRG[] = "Tape image file (PRG)";
 
-SidTuneBase* prg::load(const char *fileName, const buffer_t& dataBuf)
+SidTuneBase* prg::load(const char *fileName, const uint8_t*, uint_least32_t dataLen)
 {
     const char *ext = SidTuneTools::fileExtOfPath(fileName);
     if ((!stringutils::equal(ext, ".prg"))
@@ -44,7 +44,7 @@ SidTuneBase* prg::load(const char *fileName, const buffer_t& dataBuf)
         return nullptr;
     }
 
-    if (dataBuf.size() < 2)
+    if (dataLen < 2)
     {
         throw loadError(ERR_TRUNCATED);
     }
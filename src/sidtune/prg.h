@@ -41,7 +41,7 @@ public:
      * @return pointer to a SidTune or 0 if not a prg file
      * @throw loadError if prg file is corrupt
      */
-    static SidTuneBase* load(const char *fileName, const buffer_t& dataBuf);
+    static SidTuneBase* load(const char *fileName, const uint8_t* dataBuf, uint_least32_t dataLen);
 
     ~prg() override = default;
 
@@ -90,6 +90,13 @@ private:
      * R 0.5   1.0   1.0
      */
 
+    /// The stereo channel matrix above, in half units
+    static constexpr int STEREO_WEIGHTS[3][2][3] = {
+        { { 2, 0, 0 }, { 2, 0, 0 } },
+        { { 2, 1, 0 }, { 1, 2, 0 } },
+        { { 2, 2, 1 }, { 1, 2, 2 } }
+    };
+
     // Mono mixing
     template <int Chips>
     int_least32_t mono() const
@@ -137,6 +144,21 @@ public:
     unsigned int doMix(short *buffer, unsigned int samples);
 
     unsigned int channels() const { return m_mix.size(); }
+
+    /**
+     * Get the weight of a chip in an output channel, in half units.
+     * Each mixed sample is the weighted sum of the chip samples
+     * multiplied by #scale and divided by #divisor, for emulations
+     * which mix their output in the same pass.
+     */
+    int weight(unsigned int channel, unsigned int chip) const
+    {
+        return channels() == 1 ? 2 : STEREO_WEIGHTS[m_buffers.size()-1][channel][chip];
+    }
+
+    int_least32_t scale() const { return SCALE[m_buffers.size()-1]; }
+
+    static constexpr int_least32_t divisor() { return 2 * SCALE_FACTOR; }
 };
 
 }
@@ -0,0 +1,97 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "streamer.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace libsidplayfp
+{
+
+// Check the fill level four times per lookahead period
+static std::chrono::microseconds pollPeriod(unsigned int lookahead, unsigned int frequency)
+{
+    const long long us = 250000LL * lookahead / frequency;
+    return std::chrono::microseconds(std::max(us, 1000LL));
+}
+
+Streamer::Streamer(render_t render, unsigned int channels, unsigned int blockSize,
+                   unsigned int lookahead, unsigned int frequency) :
+    m_render(std::move(render)),
+    m_channels(channels),
+    m_lookahead(static_cast<size_t>(lookahead) * channels),
+    m_pause(pollPeriod(lookahead, frequency)),
+    m_block(new short[blockSize]),
+    // room for a whole block once the lookahead is almost filled
+    m_ring(m_lookahead + blockSize),
+    m_underruns(0),
+    m_failed(false),
+    m_running(true),
+    m_thread(&Streamer::run, this) {}
+
+Streamer::~Streamer()
+{
+    m_running.store(false, std::memory_order_release);
+    m_thread.join();
+}
+
+void Streamer::run()
+{
+    while (m_running.load(std::memory_order_acquire))
+    {
+        if (m_ring.size() >= m_lookahead)
+        {
+            std::this_thread::sleep_for(m_pause);
+            continue;
+        }
+
+        const int samples = m_render(m_block.get());
+        if (samples < 0)
+        {
+            m_failed.store(true, std::memory_order_release);
+            break;
+        }
+
+        // hardware devices don't produce any output
+        if (samples == 0)
+        {
+            std::this_thread::sleep_for(m_pause);
+            continue;
+        }
+
+        // there's always room for a block
+        m_ring.push(m_block.get(), samples);
+    }
+}
+
+unsigned int Streamer::read(short *buffer, unsigned int frames)
+{
+    const size_t samples = static_cast<size_t>(frames) * m_channels;
+    const size_t count = m_ring.pop(buffer, samples);
+    if (count < samples)
+    {
+        std::fill(buffer + count, buffer + samples, 0);
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    return count / m_channels;
+}
+
+}
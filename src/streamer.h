@@ -0,0 +1,129 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef STREAMER_H
+#define STREAMER_H
+
+#include "ringbuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace libsidplayfp
+{
+
+/**
+ * Render ahead of time in a background thread.
+ *
+ * The rendered frames are queued in a lock-free ring buffer
+ * so the consumer never runs the emulation nor blocks,
+ * emulation cost spikes are absorbed by the lookahead.
+ */
+class Streamer
+{
+public:
+    /**
+     * Render a block of interleaved samples.
+     *
+     * @param buffer the output buffer
+     * @return the number of samples written, negative on error
+     */
+    using render_t = std::function<int(short *buffer)>;
+
+private:
+    const render_t m_render;
+
+    const unsigned int m_channels;
+
+    /// Samples to keep rendered ahead
+    const size_t m_lookahead;
+
+    /// Pause when the lookahead is filled
+    const std::chrono::microseconds m_pause;
+
+    std::unique_ptr<short[]> m_block;
+
+    RingBuffer<short> m_ring;
+
+    std::atomic<unsigned int> m_underruns;
+
+    std::atomic<bool> m_failed;
+
+    std::atomic<bool> m_running;
+
+    std::thread m_thread;
+
+private:
+    void run();
+
+public:
+    /**
+     * Start the background thread.
+     *
+     * @param render the render function, called from the background thread
+     * @param channels the number of interleaved channels
+     * @param blockSize the maximum number of samples per render call
+     * @param lookahead the number of frames to keep rendered ahead
+     * @param frequency the sampling frequency
+     */
+    Streamer(render_t render, unsigned int channels, unsigned int blockSize,
+             unsigned int lookahead, unsigned int frequency);
+
+    /**
+     * Stop the background thread.
+     */
+    ~Streamer();
+
+    Streamer(const Streamer&) = delete;
+    Streamer& operator=(const Streamer&) = delete;
+
+    /**
+     * Get rendered frames.
+     * Doesn't block, the missing frames are filled
+     * with silence and counted as an underrun.
+     *
+     * @param buffer the output buffer
+     * @param frames the number of frames
+     * @return the number of rendered frames
+     */
+    unsigned int read(short *buffer, unsigned int frames);
+
+    /**
+     * Get the number of frames rendered ahead.
+     */
+    unsigned int fill() const { return m_ring.size() / m_channels; }
+
+    /**
+     * Get the number of reads which came short of frames.
+     */
+    unsigned int underruns() const { return m_underruns.load(std::memory_order_relaxed); }
+
+    /**
+     * Check if rendering stopped because of an error.
+     */
+    bool failed() const { return m_failed.load(std::memory_order_acquire); }
+};
+
+}
+
+#endif // STREAMER_H
@@ -29,21 +29,20 @@
 
 #include "stil.h"
 
+#include <cctype>
 #include <cstdlib>
 #include <cstring>
-#include <cstdio>      // For snprintf() and NULL
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <initializer_list>
+#include <iterator>
 #include <sstream>
-#include <utility>
 
 #include "stringutils.h"
 
 using namespace std;
 
-const ios_base::openmode STILopenFlags = ios::in | ios::binary;
-
 constexpr float VERSION_NO = 3.0f;
 
 #define CERR_STIL_DEBUG if (STIL_DEBUG) cerr << "Line #" << __LINE__ << " STIL::"
@@ -99,8 +98,6 @@ STIL::STIL(const char *stilPath, const char *bugsPath) :
     PATH_TO_STIL(stilPath),
     PATH_TO_BUGLIST(bugsPath),
     STILVersion(0.0f),
-    STIL_EOL('\n'),
-    STIL_EOL2('\0'),
     lastError(NO_STIL_ERROR)
 {
     setVersionString();
@@ -137,16 +134,38 @@ STIL::getSTILVersionNo()
     return STILVersion;
 }
 
-bool
-STIL::setBaseDir(const char *pathToHVSC)
+/**
+ * Compares two pathnames case insensitively, like the entries are matched.
+ *
+ * @return <0, 0 or >0 as strcmp
+ */
+int comparePath(const char *s1, size_t len1, const char *s2, size_t len2)
 {
-    // Temporary placeholder for STIL.txt's version number.
-    const float tempSTILVersion = STILVersion;
+    const size_t len = std::min(len1, len2);
+    for (size_t i = 0; i < len; i++)
+    {
+        const int c1 = tolower(static_cast<unsigned char>(s1[i]));
+        const int c2 = tolower(static_cast<unsigned char>(s2[i]));
+        if (c1 != c2)
+            return c1 - c2;
+    }
+    return (len1 < len2) ? -1 : (len1 > len2) ? 1 : 0;
+}
 
-    // Temporary placeholders for lists of sections.
-    dirList tempStilDirs;
-    dirList tempBugDirs;
+/**
+ * Finds the first occurrence of 'str' in [first, last).
+ *
+ * @return the position or null if not found
+ */
+const char *findStr(const char *first, const char *last, const char *str)
+{
+    const char *found = std::search(first, last, str, str + strlen(str));
+    return (found != last) ? found : nullptr;
+}
 
+bool
+STIL::setBaseDir(const char *pathToHVSC)
+{
     lastError = NO_STIL_ERROR;
 
     CERR_STIL_DEBUG << "setBaseDir() called, pathToHVSC=" << pathToHVSC << endl;
@@ -169,34 +188,52 @@ STIL::setBaseDir(const char *pathToHVSC)
         tempBaseDir.erase(lastChar);
     }
 
-    // Attempt to open STIL
+    // Attempt to read STIL
 
     // Create the full path+filename
     string tempName = tempBaseDir;
     tempName.append(PATH_TO_STIL);
     convertSlashes(tempName);
 
-    ifstream stilFile(tempName.c_str(), STILopenFlags);
+    // Temporary placeholders for the indexes, so the current ones
+    // survive a failure.
+    index_t tempStilIndex;
+    index_t tempBugIndex;
 
-    if (stilFile.fail())
+    if (!readFile(tempName, tempStilIndex.text))
     {
         CERR_STIL_DEBUG << "setBaseDir() open failed for " << tempName << endl;
         lastError = STIL_OPEN;
         return false;
     }
 
-    CERR_STIL_DEBUG << "setBaseDir(): open succeeded for " << tempName << endl;
+    CERR_STIL_DEBUG << "setBaseDir(): read succeeded for " << tempName << endl;
+
+    // There must be at least one line
+    if (tempStilIndex.text.find('\n') == string::npos)
+    {
+        CERR_STIL_DEBUG << "setBaseDir() no EOL found" << endl;
+        lastError = NO_EOL;
+        return false;
+    }
+
+    float tempSTILVersion = 0.0f;
 
-    // Attempt to open BUGlist
+    if (!buildIndex(tempStilIndex, &tempSTILVersion))
+    {
+        CERR_STIL_DEBUG << "buildIndex() failed for stilFile" << endl;
+        lastError = NO_STIL_DIRS;
+        return false;
+    }
+
+    // Attempt to read BUGlist
 
     // Create the full path+filename
     tempName = tempBaseDir;
     tempName.append(PATH_TO_BUGLIST);
     convertSlashes(tempName);
 
-    ifstream bugFile(tempName.c_str(), STILopenFlags);
-
-    if (bugFile.fail())
+    if (!readFile(tempName, tempBugIndex.text))
     {
         // This is not a critical error - some earlier versions of HVSC did
         // not have a BUGlist.txt file at all.
@@ -204,69 +241,36 @@ STIL::setBaseDir(const char *pathToHVSC)
         CERR_STIL_DEBUG << "setBaseDir() open failed for " << tempName << endl;
         lastError = BUG_OPEN;
     }
-    else
+    else if (!buildIndex(tempBugIndex, nullptr))
     {
-        CERR_STIL_DEBUG << "setBaseDir(): open succeeded for " << tempName << endl;
-    }
+        // This is not a critical error - it is possible that the
+        // BUGlist.txt file has no entries in it at all (in fact, that's
+        // good!).
 
-    // Find out what the EOL really is
-    if (determineEOL(stilFile) != true)
-    {
-        CERR_STIL_DEBUG << "determinEOL() failed" << endl;
-        lastError = NO_EOL;
-        return false;
+        CERR_STIL_DEBUG << "buildIndex() failed for bugFile" << endl;
+        lastError = BUG_OPEN;
     }
 
-    // Save away the current string so we can restore it if needed.
-    const string tempVersionString(versionString);
+    // Now we can move the stuff into private data.
 
+    STILVersion = tempSTILVersion;
     setVersionString();
 
-    // This is necessary so the version number gets scanned in from the new
-    // file, too.
-    STILVersion = 0.0;
-
-    // These will populate the tempStilDirs and tempBugDirs maps (or not :)
-
-    if (getDirs(stilFile, tempStilDirs, true) != true)
+    if (STILVersion != 0.0f)
     {
-        CERR_STIL_DEBUG << "getDirs() failed for stilFile" << endl;
-        lastError = NO_STIL_DIRS;
-
-        // Clean up and restore things.
-        STILVersion = tempSTILVersion;
-        versionString = tempVersionString;
-        return false;
+        // Put the version number into the string, too.
+        ostringstream ss;
+        ss << fixed << setw(4) << setprecision(2);
+        ss << "SID Tune Information List (STIL) v" << STILVersion << endl;
+        versionString.append(ss.str());
     }
 
-    if (bugFile.good())
-    {
-        if (getDirs(bugFile, tempBugDirs, false) != true)
-        {
-            // This is not a critical error - it is possible that the
-            // BUGlist.txt file has no entries in it at all (in fact, that's
-            // good!).
+    baseDir.swap(tempBaseDir);
+    stilIndex = std::move(tempStilIndex);
+    bugIndex = std::move(tempBugIndex);
 
-            CERR_STIL_DEBUG << "getDirs() failed for bugFile" << endl;
-            lastError = BUG_OPEN;
-        }
-    }
-
-    // Now we can copy the stuff into private data.
-    // NOTE: At this point, STILVersion and the versionString should contain
-    // the new info!
-
-    // Copy.
-    baseDir = tempBaseDir;
-    stilDirs = tempStilDirs;
-    bugDirs = tempBugDirs;
-
-    // Clear the buffers (caches).
-    entrybuf.clear();
-    globalbuf.clear();
-    bugbuf.clear();
-
-    CERR_STIL_DEBUG << "setBaseDir() succeeded" << endl;
+    CERR_STIL_DEBUG << "setBaseDir() succeeded, " << stilIndex.entries.size() << " STIL entries, "
+        << bugIndex.entries.size() << " BUG entries" << endl;
 
     return true;
 }
@@ -304,80 +308,17 @@ STIL::getAbsEntry(const char *absPathToEntry, int tuneNo, STILField field)
 const char *
 STIL::getEntry(const char *relPathToEntry, int tuneNo, STILField field)
 {
-    lastError = NO_STIL_ERROR;
-
     CERR_STIL_DEBUG << "getEntry() called, relPath=" << relPathToEntry << ", rest=" << tuneNo << "," << field << endl;
 
-    if (baseDir.empty())
-    {
-        CERR_STIL_DEBUG << "HVSC baseDir is not yet set!" << endl;
-        lastError = STIL_OPEN;
-        return nullptr;
-    }
-
-    const size_t relPathToEntryLen = strlen(relPathToEntry);
-
-    // Fail if a section-global comment was asked for.
+    const char *first;
+    const char *last;
+    lastError = lookupEntry(relPathToEntry, strlen(relPathToEntry), tuneNo, field, first, last);
 
-    if (*(relPathToEntry + relPathToEntryLen - 1) == '/')
-    {
-        CERR_STIL_DEBUG << "getEntry() section-global comment was asked for - failed" << endl;
-        lastError = WRONG_ENTRY;
+    if (first == nullptr)
         return nullptr;
-    }
 
-    if (STILVersion < 2.59f)
-    {
-        // Older version of STIL is detected.
-
-        tuneNo = 0;
-        field = all;
-    }
-
-    // Find out whether we have this entry in the buffer.
-
-    if ((!stringutils::equal(entrybuf.data(), relPathToEntry, relPathToEntryLen))
-        || ((entrybuf.find_first_of('\n') != relPathToEntryLen)
-        && (STILVersion > 2.59f)))
-    {
-        // The relative pathnames don't match or they're not the same length:
-        // we don't have it in the buffer, so pull it in.
-
-        CERR_STIL_DEBUG << "getEntry(): entry not in buffer" << endl;
-
-        // Create the full path+filename
-        string tempName(baseDir);
-        tempName.append(PATH_TO_STIL);
-        convertSlashes(tempName);
-
-        ifstream stilFile(tempName.c_str(), STILopenFlags);
-
-        if (stilFile.fail())
-        {
-            CERR_STIL_DEBUG << "getEntry() open failed for stilFile" << endl;
-            lastError = STIL_OPEN;
-            return nullptr;
-        }
-
-        CERR_STIL_DEBUG << "getEntry() open succeeded for stilFile" << endl;
-
-        if (positionToEntry(relPathToEntry, stilFile, stilDirs) == false)
-        {
-            // Copy the entry's name to the buffer.
-            entrybuf.assign(relPathToEntry).append("\n");
-            CERR_STIL_DEBUG << "getEntry() posToEntry() failed" << endl;
-            lastError = NOT_IN_STIL;
-        }
-        else
-        {
-            entrybuf.clear();
-            readEntry(stilFile, entrybuf);
-            CERR_STIL_DEBUG << "getEntry() entry read" << endl;
-        }
-    }
-
-    // Put the requested field into the result string.
-    return getField(resultEntry, entrybuf.c_str(), tuneNo, field) ? resultEntry.c_str() : nullptr;
+    resultEntry.assign(first, last);
+    return resultEntry.c_str();
 }
 
 const char *
@@ -412,72 +353,17 @@ STIL::getAbsBug(const char *absPathToEntry, int tuneNo)
 const char *
 STIL::getBug(const char *relPathToEntry, int tuneNo)
 {
-    lastError = NO_STIL_ERROR;
-
     CERR_STIL_DEBUG << "getBug() called, relPath=" << relPathToEntry << ", rest=" << tuneNo << endl;
 
-    if (baseDir.empty())
-    {
-        CERR_STIL_DEBUG << "HVSC baseDir is not yet set!" << endl;
-        lastError = BUG_OPEN;
-        return nullptr;
-    }
-
-    // Older version of STIL is detected.
-
-    if (STILVersion < 2.59f)
-    {
-        tuneNo = 0;
-    }
-
-    // Find out whether we have this bug entry in the buffer.
-    // If the baseDir was changed, we'll have to read it in again,
-    // even if it might be in the buffer already.
-
-    const size_t relPathToEntryLen = strlen(relPathToEntry);
+    const char *first;
+    const char *last;
+    lastError = lookupBug(relPathToEntry, strlen(relPathToEntry), tuneNo, first, last);
 
-    if ((!stringutils::equal(bugbuf.data(), relPathToEntry, relPathToEntryLen)) ||
-        ((bugbuf.find_first_of('\n') != relPathToEntryLen) &&
-         (STILVersion > 2.59f)))
-    {
-        // The relative pathnames don't match or they're not the same length:
-        // we don't have it in the buffer, so pull it in.
-
-        CERR_STIL_DEBUG << "getBug(): entry not in buffer" << endl;
-
-        // Create the full path+filename
-        string tempName(baseDir);
-        tempName.append(PATH_TO_BUGLIST);
-        convertSlashes(tempName);
-
-        ifstream bugFile(tempName.c_str(), STILopenFlags);
-
-        if (bugFile.fail())
-        {
-            CERR_STIL_DEBUG << "getBug() open failed for bugFile" << endl;
-            lastError = BUG_OPEN;
-            return nullptr;
-        }
-
-        CERR_STIL_DEBUG << "getBug() open succeeded for bugFile" << endl;
-
-        if (positionToEntry(relPathToEntry, bugFile, bugDirs) == false)
-        {
-            // Copy the entry's name to the buffer.
-            bugbuf.assign(relPathToEntry).append("\n");
-            CERR_STIL_DEBUG << "getBug() posToEntry() failed" << endl;
-            lastError = NOT_IN_BUG;
-        }
-        else
-        {
-            bugbuf.clear();
-            readEntry(bugFile, bugbuf);
-            CERR_STIL_DEBUG << "getBug() entry read" << endl;
-        }
-    }
+    if (first == nullptr)
+        return nullptr;
 
-    // Put the requested field into the result string.
-    return getField(resultBug, bugbuf.c_str(), tuneNo) ? resultBug.c_str() : nullptr;
+    resultBug.assign(first, last);
+    return resultBug.c_str();
 }
 
 const char *
@@ -512,372 +398,326 @@ STIL::getAbsGlobalComment(const char *absPathToEntry)
 const char *
 STIL::getGlobalComment(const char *relPathToEntry)
 {
-    lastError = NO_STIL_ERROR;
-
     CERR_STIL_DEBUG << "getGC() called, relPath=" << relPathToEntry << endl;
 
-    if (baseDir.empty())
-    {
-        CERR_STIL_DEBUG << "HVSC baseDir is not yet set!" << endl;
-        lastError = STIL_OPEN;
-        return nullptr;
-    }
-
-    // Save the dirpath.
-
-    const char *lastSlash = strrchr(relPathToEntry, '/');
+    const char *first;
+    const char *last;
+    lastError = lookupGlobalComment(relPathToEntry, strlen(relPathToEntry), first, last);
 
-    if (lastSlash == nullptr)
-    {
-        lastError = WRONG_DIR;
+    if (first == nullptr)
         return nullptr;
-    }
-
-    const size_t pathLen = lastSlash - relPathToEntry + 1;
-    const string dir(relPathToEntry, pathLen);
-
-    // Find out whether we have this global comment in the buffer.
-    // If the baseDir was changed, we'll have to read it in again,
-    // even if it might be in the buffer already.
 
-    if ((!stringutils::equal(globalbuf.data(), dir.data(), pathLen)) ||
-        ((globalbuf.find_first_of('\n') != pathLen) &&
-         (STILVersion > 2.59f)))
-    {
-        // The relative pathnames don't match or they're not the same length:
-        // we don't have it in the buffer, so pull it in.
-
-        CERR_STIL_DEBUG << "getGC(): entry not in buffer" << endl;
-
-        // Create the full path+filename
-        string tempName(baseDir);
-        tempName.append(PATH_TO_STIL);
-        convertSlashes(tempName);
-
-        ifstream stilFile(tempName.c_str(), STILopenFlags);
-
-        if (stilFile.fail())
-        {
-            CERR_STIL_DEBUG << "getGC() open failed for stilFile" << endl;
-            lastError = STIL_OPEN;
-            return nullptr;
-        }
-
-        if (positionToEntry(dir.c_str(), stilFile, stilDirs) == false)
-        {
-            // Copy the dirname to the buffer.
-            globalbuf.assign(dir).append("\n");
-            CERR_STIL_DEBUG << "getGC() posToEntry() failed" << endl;
-            lastError = NOT_IN_STIL;
-        }
-        else
-        {
-            globalbuf.clear();
-            readEntry(stilFile, globalbuf);
-            CERR_STIL_DEBUG << "getGC() entry read" << endl;
-        }
-    }
-
-    CERR_STIL_DEBUG << "getGC() globalbuf=" << globalbuf << endl;
-    CERR_STIL_DEBUG << "-=END=-" << endl;
-
-    // Position pointer to the global comment field.
-
-    const size_t temp = globalbuf.find_first_of('\n') + 1;
-
-    // Check whether this is a NULL entry or not.
-    return temp != globalbuf.size() ? globalbuf.c_str() + temp : nullptr;
+    resultGlobal.assign(first, last);
+    return resultGlobal.c_str();
 }
 
 //////// PRIVATE
 
 bool
-STIL::determineEOL(ifstream &stilFile)
+STIL::readFile(const string &fileName, string &text)
 {
-    CERR_STIL_DEBUG << "detEOL() called" << endl;
+    ifstream file(fileName.c_str(), ios::in | ios::binary);
 
-    if (stilFile.fail())
-    {
-        CERR_STIL_DEBUG << "detEOL() open failed" << endl;
+    if (file.fail())
         return false;
-    }
 
-    stilFile.seekg(0);
+    const string raw((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
 
-    STIL_EOL = '\0';
-    STIL_EOL2 = '\0';
+    if (file.bad())
+        return false;
 
-    // Determine what the EOL character is
-    // (it can be different from OS to OS).
-    istream::sentry se(stilFile, true);
-    if (se)
-    {
-        streambuf *sb = stilFile.rdbuf();
+    // Convert the line ends, they can be different from OS to OS.
+    text.clear();
+    text.reserve(raw.size() + 1);
 
-        const int eof = char_traits<char>::eof();
+    for (size_t i = 0; i < raw.size(); i++)
+    {
+        const char c = raw[i];
 
-        while (sb->sgetc() != eof)
+        if (c == '\r')
         {
-            const int c = sb->sbumpc();
-            if ((c == '\n') || (c == '\r'))
-            {
-                STIL_EOL = c;
+            // CR LF or a lone CR
+            if ((i + 1 < raw.size()) && (raw[i + 1] == '\n'))
+                continue;
 
-                if (c == '\r')
-                {
-                    if (sb->sgetc() == '\n')
-                        STIL_EOL2 = '\n';
-                }
-                break;
-            }
+            text.push_back('\n');
+        }
+        else
+        {
+            text.push_back(c);
         }
     }
 
-    if (STIL_EOL == '\0')
-    {
-        // Something is wrong - no EOL-like char was found.
-        CERR_STIL_DEBUG << "detEOL() no EOL found" << endl;
-        return false;
-    }
-
-    CERR_STIL_DEBUG << "detEOL() EOL1=0x" << hex << static_cast<int>(STIL_EOL) << " EOL2=0x" << hex << static_cast<int>(STIL_EOL2) << dec << endl;
+    // Make sure that the last entry is terminated.
+    if (!text.empty() && (text.back() != '\n'))
+        text.push_back('\n');
 
     return true;
 }
 
 bool
-STIL::getDirs(ifstream &inFile, dirList &dirs, bool isSTILFile)
+STIL::buildIndex(index_t &index, float *version)
 {
-    bool newDir = !isSTILFile;
+    const string &text = index.text;
 
-    CERR_STIL_DEBUG << "getDirs() called" << endl;
+    index.entries.clear();
+    index.tunes.clear();
 
-    inFile.seekg(0);
+    size_t pos = 0;
 
-    while (inFile.good())
+    while (pos < text.size())
     {
-        string line;
-
-        getStilLine(inFile, line);
-
-        if (!isSTILFile) { CERR_STIL_DEBUG << line << '\n'; }
+        const size_t eol = text.find('\n', pos);
 
         // Try to extract STIL's version number if it's not done, yet.
 
-        if (isSTILFile && (STILVersion == 0.0f))
+        if ((version != nullptr) && (*version == 0.0f)
+            && (text.compare(pos, 9, "#  STIL v") == 0))
         {
-            if (strncmp(line.data(), "#  STIL v", 9) == 0)
-            {
-                // Get the version number
-                STILVersion = atof(line.c_str() + 9);
-
-                // Put it into the string, too.
-                ostringstream ss;
-                ss << fixed << setw(4) << setprecision(2);
-                ss << "SID Tune Information List (STIL) v" << STILVersion << endl;
-                versionString.append(ss.str());
-
-                CERR_STIL_DEBUG << "getDirs() STILVersion=" << STILVersion << endl;
-
-                continue;
-            }
+            *version = atof(text.c_str() + pos + 9);
         }
 
-        // Search for the start of a dir separator first.
-
-        if (isSTILFile && !newDir && stringutils::equal(line.data(), "### ", 4))
+        if (text[pos] != '/')
         {
-            newDir = true;
+            pos = eol + 1;
             continue;
         }
 
-        // Is this the start of an entry immediately following a dir separator?
+        // This is the start of an entry, which ends at the first empty line.
 
-        if (newDir && (line[0] == '/'))
-        {
-            // Get the directory only
-            const string dirName(line, 0, line.find_last_of('/') + 1);
+        entry_t entry;
+        entry.path = pos;
+        entry.pathLength = eol - pos;
+        entry.begin = eol + 1;
+        entry.firstTune = index.tunes.size();
 
-            if (!isSTILFile)
-            {
-                // Compare it to the stored dirnames
-                newDir = (dirs.count(dirName) == 0);
-            }
+        size_t line = entry.begin;
 
-            // Store the info
-            if (newDir)
+        while ((line < text.size()) && (text[line] != '\n'))
+        {
+            // A tune designation at the start of a line?
+            if (text.compare(line, 2, "(#") == 0)
             {
-                const streampos position = inFile.tellg() - (streampos)line.size() - 1L;
+                const char *number = text.c_str() + line + 2;
+                char *numberEnd;
+                const long tuneNo = strtol(number, &numberEnd, 10);
 
-                CERR_STIL_DEBUG << "getDirs() dirName=" << dirName << ", pos=" << position <<  endl;
-
-                dirs.insert(make_pair(dirName, position));
+                if ((numberEnd != number) && (*numberEnd == ')'))
+                {
+                    tune_t tune;
+                    tune.tuneNo = static_cast<int>(tuneNo);
+                    tune.begin = line;
+                    index.tunes.push_back(tune);
+                }
             }
 
-            newDir = !isSTILFile;
+            line = text.find('\n', line) + 1;
         }
-    }
 
-    if (dirs.empty())
-    {
-        // No entries found - something is wrong.
-        // NOTE: It's perfectly valid to have a BUGlist.txt file with no
-        // entries in it!
-        CERR_STIL_DEBUG << "getDirs() no dirs found" << endl;
-        return false;
+        entry.end = line;
+        entry.tunes = index.tunes.size() - entry.firstTune;
+        index.entries.push_back(entry);
+
+        // Go on from the next line, a pathname right after this one
+        // starts an entry of its own too.
+        pos = entry.begin;
     }
 
-    CERR_STIL_DEBUG << "getDirs() successful" << endl;
+    // Sort by pathname, keeping the first of the duplicates.
+    std::stable_sort(index.entries.begin(), index.entries.end(),
+        [&text](const entry_t &a, const entry_t &b)
+        {
+            return comparePath(text.data() + a.path, a.pathLength,
+                text.data() + b.path, b.pathLength) < 0;
+        });
 
-    return true;
+    index.entries.erase(std::unique(index.entries.begin(), index.entries.end(),
+        [&text](const entry_t &a, const entry_t &b)
+        {
+            return comparePath(text.data() + a.path, a.pathLength,
+                text.data() + b.path, b.pathLength) == 0;
+        }), index.entries.end());
+
+    // No entries found - something is wrong.
+    // NOTE: It's perfectly valid to have a BUGlist.txt file with no
+    // entries in it!
+    return !index.entries.empty();
 }
 
-bool
-STIL::positionToEntry(const char *entryStr, ifstream &inFile, dirList &dirs)
+const STIL::entry_t *
+STIL::findEntry(const index_t &index, const char *entryStr, size_t entryLen) const
 {
-    CERR_STIL_DEBUG << "pos2Entry() called, entryStr=" << entryStr << endl;
+    const string &text = index.text;
 
-    inFile.seekg(0);
-
-    // Get the dirpath.
+    std::vector<entry_t>::const_iterator it = std::lower_bound(
+        index.entries.begin(), index.entries.end(), entryStr,
+        [&text, entryLen](const entry_t &entry, const char *key)
+        {
+            return comparePath(text.data() + entry.path, entry.pathLength, key, entryLen) < 0;
+        });
 
-    char *chrptr = strrchr((char *)entryStr, '/');
+    if (it == index.entries.end())
+        return nullptr;
 
-    // If no slash was found, something is screwed up in the entryStr.
+    const char *path = text.data() + it->path;
 
-    if (chrptr == nullptr)
+    if (it->pathLength == entryLen)
     {
-        return false;
+        if (comparePath(path, entryLen, entryStr, entryLen) == 0)
+            return &(*it);
+    }
+    else if ((STILVersion <= 2.59f) && (it->pathLength > entryLen)
+        && (entryStr[entryLen - 1] != '/')
+        && (comparePath(path, entryLen, entryStr, entryLen) == 0))
+    {
+        // To be compatible with older versions of STIL, which may have
+        // the tune designation on the first line of a STIL entry
+        // together with the pathname.
+        return &(*it);
     }
 
-    const size_t pathLen = chrptr - entryStr + 1;
+    return nullptr;
+}
 
-    // Determine whether a section-global comment is asked for.
+STIL::STILerror
+STIL::lookupEntry(const char *relPathToEntry, size_t length, int tuneNo, STILField field,
+    const char *&first, const char *&last) const
+{
+    first = last = nullptr;
 
-    const size_t entryStrLen = strlen(entryStr);
-    const bool globComm = (pathLen == entryStrLen);
+    if (baseDir.empty())
+    {
+        CERR_STIL_DEBUG << "HVSC baseDir is not yet set!" << endl;
+        return STIL_OPEN;
+    }
+
+    if (length == 0)
+    {
+        return NOT_IN_STIL;
+    }
 
-    // Find it in the table.
-    const string entry(entryStr, pathLen);
-    dirList::iterator elem = dirs.find(entry);
+    // Fail if a section-global comment was asked for.
 
-    if (elem == dirs.end())
+    if (relPathToEntry[length - 1] == '/')
     {
-        // The directory was not found.
-        CERR_STIL_DEBUG << "pos2Entry() did not find the dir" << endl;
-        return false;
+        CERR_STIL_DEBUG << "getEntry() section-global comment was asked for - failed" << endl;
+        return WRONG_ENTRY;
     }
 
-    // Jump to the first entry of this section.
-    inFile.seekg(elem->second);
-    bool foundIt = false;
+    if (STILVersion < 2.59f)
+    {
+        // Older version of STIL is detected.
 
-    // Now find the desired entry
+        tuneNo = 0;
+        field = all;
+    }
 
-    string line;
+    const entry_t *entry = findEntry(stilIndex, relPathToEntry, length);
 
-    do
+    if (entry == nullptr)
     {
-        getStilLine(inFile, line);
+        CERR_STIL_DEBUG << "getEntry() entry not found" << endl;
+        return NOT_IN_STIL;
+    }
 
-        if (inFile.eof())
-        {
-            break;
-        }
+    getField(stilIndex, *entry, tuneNo, field, first, last);
+    return NO_STIL_ERROR;
+}
 
-        // Check if it is the start of an entry
+STIL::STILerror
+STIL::lookupGlobalComment(const char *relPathToEntry, size_t length,
+    const char *&first, const char *&last) const
+{
+    first = last = nullptr;
 
-        if (line[0] == '/')
-        {
-            if (!stringutils::equal(elem->first.data(), line.data(), pathLen))
-            {
-                // We are outside the section - get out of the loop,
-                // which will fail the search.
-                break;
-            }
+    if (baseDir.empty())
+    {
+        CERR_STIL_DEBUG << "HVSC baseDir is not yet set!" << endl;
+        return STIL_OPEN;
+    }
 
-            // Check whether we need to find a section-global comment or
-            // a specific entry.
+    // Get the dirpath.
 
-            if (globComm || (STILVersion > 2.59f))
-            {
-                foundIt = stringutils::equal(line.c_str(), entryStr);
-            }
-            else
-            {
-                // To be compatible with older versions of STIL, which may have
-                // the tune designation on the first line of a STIL entry
-                // together with the pathname.
-                foundIt = stringutils::equal(line.data(), entryStr, entryStrLen);
-            }
+    size_t pathLen = length;
 
-            CERR_STIL_DEBUG << "pos2Entry() line=" << line << endl;
-        }
+    while ((pathLen > 0) && (relPathToEntry[pathLen - 1] != '/'))
+        pathLen--;
+
+    if (pathLen == 0)
+    {
+        return WRONG_DIR;
     }
-    while (!foundIt);
 
-    if (foundIt)
+    const entry_t *entry = findEntry(stilIndex, relPathToEntry, pathLen);
+
+    if (entry == nullptr)
     {
-        // Reposition the file pointer back to the start of the entry.
-        inFile.seekg(inFile.tellg() - (streampos)line.size() - 1L);
-        CERR_STIL_DEBUG << "pos2Entry() entry found" << endl;
-        return true;
+        CERR_STIL_DEBUG << "getGC() entry not found" << endl;
+        return NOT_IN_STIL;
     }
-    else
+
+    // Check whether this is a NULL entry or not.
+
+    if (entry->begin != entry->end)
     {
-        CERR_STIL_DEBUG << "pos2Entry() entry not found" << endl;
-        return false;
+        first = stilIndex.text.data() + entry->begin;
+        last = stilIndex.text.data() + entry->end;
     }
+
+    return NO_STIL_ERROR;
 }
 
-void
-STIL::readEntry(ifstream &inFile, string &buffer)
+STIL::STILerror
+STIL::lookupBug(const char *relPathToEntry, size_t length, int tuneNo,
+    const char *&first, const char *&last) const
 {
-    string line;
+    first = last = nullptr;
 
-    for (;;)
+    if (baseDir.empty() || bugIndex.text.empty())
     {
-        getStilLine(inFile, line);
+        CERR_STIL_DEBUG << "BUGlist is not loaded!" << endl;
+        return BUG_OPEN;
+    }
 
-        if (line.size() == 0)
-            break;
+    // Older version of STIL is detected.
 
-        buffer.append(line);
-        buffer.append("\n");
+    if (STILVersion < 2.59f)
+    {
+        tuneNo = 0;
     }
+
+    const entry_t *entry = (length > 0) ? findEntry(bugIndex, relPathToEntry, length) : nullptr;
+
+    if (entry == nullptr)
+    {
+        CERR_STIL_DEBUG << "getBug() entry not found" << endl;
+        return NOT_IN_BUG;
+    }
+
+    getField(bugIndex, *entry, tuneNo, all, first, last);
+    return NO_STIL_ERROR;
 }
 
 bool
-STIL::getField(string &result, const char *buffer, int tuneNo, STILField field) const
+STIL::getField(const index_t &index, const entry_t &entry, int tuneNo, STILField field,
+    const char *&first, const char *&last) const
 {
-    CERR_STIL_DEBUG << "getField() called, buffer=" << buffer << ", rest=" << tuneNo << "," << field << endl;
+    CERR_STIL_DEBUG << "getField() called, rest=" << tuneNo << "," << field << endl;
 
-    // Clean out the result buffer first.
-    result.clear();
+    // The first char beyond the file designation.
 
-    // Position pointer to the first char beyond the file designation.
-
-    const char *start = strchr(buffer, '\n') + 1;
+    const char *start = index.text.data() + entry.begin;
+    const char *end = index.text.data() + entry.end;
 
     // Check whether this is a NULL entry or not.
 
-    if (*start == '\0')
+    if (start == end)
     {
         CERR_STIL_DEBUG << "getField() null entry" << endl;
         return false;
     }
 
-    // Is this a multitune entry?
-    const char *firstTuneNo = strstr(start, "(#");
-
-    // This is a tune designation only if the previous char was
-    // a newline (ie. if the "(#" is on the beginning of a line).
-    if ((firstTuneNo != nullptr) && (*(firstTuneNo - 1) != '\n'))
-    {
-        firstTuneNo = nullptr;
-    }
-
-    if (firstTuneNo == nullptr)
+    if (entry.tunes == 0)
     {
         //-------------------//
         // SINGLE TUNE ENTRY //
@@ -885,31 +725,31 @@ STIL::getField(string &result, const char *buffer, int tuneNo, STILField field)
 
         // Is the first thing in this STIL entry the COMMENT?
 
-        const char *temp = strstr(start, _COMMENT_STR);
+        const bool commentFirst = (findStr(start, end, _COMMENT_STR) == start);
         const char *temp2 = nullptr;
 
         // Search for other potential fields beyond the COMMENT.
-        if (temp == start)
+        if (commentFirst)
         {
-            temp2 = strstr(start, _NAME_STR);
+            temp2 = findStr(start, end, _NAME_STR);
 
             if (temp2 == nullptr)
             {
-                temp2 = strstr(start, _AUTHOR_STR);
+                temp2 = findStr(start, end, _AUTHOR_STR);
 
                 if (temp2 == nullptr)
                 {
-                    temp2 = strstr(start, _TITLE_STR);
+                    temp2 = findStr(start, end, _TITLE_STR);
 
                     if (temp2 == nullptr)
                     {
-                        temp2 = strstr(start, _ARTIST_STR);
+                        temp2 = findStr(start, end, _ARTIST_STR);
                     }
                 }
             }
         }
 
-        if (temp == start)
+        if (commentFirst)
         {
             // Yes. So it's assumed to be a file-global comment.
 
@@ -917,17 +757,17 @@ STIL::getField(string &result, const char *buffer, int tuneNo, STILField field)
 
             if ((tuneNo == 0) && ((field == all) || ((field == comment) && (temp2 == nullptr))))
             {
-                // Simply copy the stuff in.
-                result.append(start);
-                CERR_STIL_DEBUG << "getField() copied to resultbuf" << endl;
+                // Simply take the whole stuff.
+                first = start;
+                last = end;
                 return true;
             }
 
             else if ((tuneNo == 0) && (field == comment))
             {
-                // Copy just the comment.
-                result.append(start, temp2 - start);
-                CERR_STIL_DEBUG << "getField() copied to just the COMMENT to resultbuf" << endl;
+                // Take just the comment.
+                first = start;
+                last = temp2;
                 return true;
             }
 
@@ -935,8 +775,7 @@ STIL::getField(string &result, const char *buffer, int tuneNo, STILField field)
             {
                 // A specific field was asked for.
 
-                CERR_STIL_DEBUG << "getField() copying COMMENT to resultbuf" << endl;
-                return getOneField(result, temp2, temp2 + strlen(temp2), field);
+                return getOneField(temp2, end, field, first, last);
             }
 
             else
@@ -955,9 +794,9 @@ STIL::getField(string &result, const char *buffer, int tuneNo, STILField field)
 
             if ((field == all) && ((tuneNo == 0) || (tuneNo == 1)))
             {
-                // The complete entry was asked for. Simply copy the stuff in.
-                result.append(start);
-                CERR_STIL_DEBUG << "getField() copied to resultbuf" << endl;
+                // The complete entry was asked for. Simply take the whole stuff.
+                first = start;
+                last = end;
                 return true;
             }
 
@@ -965,8 +804,7 @@ STIL::getField(string &result, const char *buffer, int tuneNo, STILField field)
             {
                 // A specific field was asked for.
 
-                CERR_STIL_DEBUG << "getField() copying COMMENT to resultbuf" << endl;
-                return getOneField(result, start, start + strlen(start), field);
+                return getOneField(start, end, field, first, last);
             }
 
             else
@@ -986,6 +824,9 @@ STIL::getField(string &result, const char *buffer, int tuneNo, STILField field)
 
         CERR_STIL_DEBUG << "getField() multitune entry" << endl;
 
+        const tune_t *tunes = index.tunes.data() + entry.firstTune;
+        const char *firstTuneNo = index.text.data() + tunes[0].begin;
+
         // Was the complete entry asked for?
 
         if (tuneNo == 0)
@@ -993,9 +834,9 @@ STIL::getField(string &result, const char *buffer, int tuneNo, STILField field)
             switch (field)
             {
             case all:
-                // Yes. Simply copy the stuff in.
-                result.append(start);
-                CERR_STIL_DEBUG << "getField() copied all to resultbuf" << endl;
+                // Yes. Simply take the whole stuff.
+                first = start;
+                last = end;
                 return true;
 
             case comment:
@@ -1003,8 +844,7 @@ STIL::getField(string &result, const char *buffer, int tuneNo, STILField field)
 
                 if (firstTuneNo != start)
                 {
-                    CERR_STIL_DEBUG << "getField() copying file-global comment to resultbuf" << endl;
-                    return getOneField(result, start, firstTuneNo, comment);
+                    return getOneField(start, firstTuneNo, comment, first, last);
                 }
                 else
                 {
@@ -1012,8 +852,6 @@ STIL::getField(string &result, const char *buffer, int tuneNo, STILField field)
                     return false;
                 }
 
-                break;
-
             default:
                 // If a specific field other than a comment is
                 // asked for tuneNo=0, this is illegal.
@@ -1023,205 +861,106 @@ STIL::getField(string &result, const char *buffer, int tuneNo, STILField field)
             }
         }
 
-        char tuneNoStr[8];
-
         // Search for the requested tune number.
 
-        snprintf(tuneNoStr, 7, "(#%d)", tuneNo);
-        tuneNoStr[7] = '\0';
-        const char *myTuneNo = strstr(start, tuneNoStr);
-
-        if (myTuneNo != nullptr)
+        for (size_t i = 0; i < entry.tunes; i++)
         {
+            if (tunes[i].tuneNo != tuneNo)
+                continue;
+
             // We found the requested tune number.
             // Set the pointer beyond it.
-            myTuneNo = strchr(myTuneNo, '\n') + 1;
+            const char *myTuneNo = strchr(index.text.data() + tunes[i].begin, '\n') + 1;
 
             // Where is the next one?
-
-            const char *nextTuneNo = strstr(myTuneNo, "\n(#");
-
-            if (nextTuneNo == nullptr)
-            {
-                // There is no next one - set pointer to end of entry.
-                nextTuneNo = start + strlen(start);
-            }
-            else
-            {
-                // The search included the \n - go beyond it.
-                nextTuneNo++;
-            }
+            const char *nextTuneNo = (i + 1 < entry.tunes)
+                ? index.text.data() + tunes[i + 1].begin
+                : end;
 
             // Put the desired fields into the result (which may be 'all').
 
-            CERR_STIL_DEBUG << "getField() myTuneNo=" << myTuneNo << ", nextTuneNo=" << nextTuneNo << endl;
-            return getOneField(result, myTuneNo, nextTuneNo, field);
+            return getOneField(myTuneNo, nextTuneNo, field, first, last);
         }
 
-        else
-        {
-            CERR_STIL_DEBUG << "getField() nothing found" << endl;
-            return false;
-        }
+        CERR_STIL_DEBUG << "getField() nothing found" << endl;
+        return false;
     }
 }
 
 bool
-STIL::getOneField(string &result, const char *start, const char *end, STILField field) const
+STIL::getOneField(const char *start, const char *end, STILField field,
+    const char *&first, const char *&last) const
 {
     // Sanity checking
 
-    if ((end < start) || (*(end - 1) != '\n'))
+    if ((end <= start) || (*(end - 1) != '\n'))
     {
         CERR_STIL_DEBUG << "getOneField() illegal parameters" << endl;
         return false;
     }
 
-    CERR_STIL_DEBUG << "getOneField() called, start=" << start << ", rest=" << field << endl;
+    CERR_STIL_DEBUG << "getOneField() called, field=" << field << endl;
 
     const char *temp = nullptr;
 
     switch (field)
     {
     case all:
-        result.append(start, end - start);
+        first = start;
+        last = end;
         return true;
 
     case name:
-        temp = strstr(start, _NAME_STR);
+        temp = findStr(start, end, _NAME_STR);
         break;
 
     case author:
-        temp = strstr(start, _AUTHOR_STR);
+        temp = findStr(start, end, _AUTHOR_STR);
         break;
 
     case title:
-        temp = strstr(start, _TITLE_STR);
+        temp = findStr(start, end, _TITLE_STR);
         break;
 
     case artist:
-        temp = strstr(start, _ARTIST_STR);
+        temp = findStr(start, end, _ARTIST_STR);
         break;
 
     case comment:
-        temp = strstr(start, _COMMENT_STR);
+        temp = findStr(start, end, _COMMENT_STR);
         break;
 
     default:
         break;
     }
 
-    // If the field was not found or it is not in between 'start'
+    // If the field was not found between 'start'
     // and 'end', it is declared a failure.
 
-    if ((temp == nullptr) || (temp < start) || (temp > end))
+    if (temp == nullptr)
     {
         return false;
     }
 
     // Search for the end of this field. This is done by finding
-    // where the next field starts.
-
-    const char *nextName = strstr(temp + 1, _NAME_STR);
-    const char *nextAuthor = strstr(temp + 1, _AUTHOR_STR);
-    const char *nextTitle = strstr(temp + 1, _TITLE_STR);
-    const char *nextArtist = strstr(temp + 1, _ARTIST_STR);
-    const char *nextComment = strstr(temp + 1, _COMMENT_STR);
-
-    // If any of these fields is beyond 'end', they are ignored.
-
-    if ((nextName != nullptr) && (nextName >= end))
-    {
-        nextName = nullptr;
-    }
-
-    if ((nextAuthor != nullptr) && (nextAuthor >= end))
-    {
-        nextAuthor = nullptr;
-    }
+    // where the next field starts, the closest one marks the end
+    // of the required field.
 
-    if ((nextTitle != nullptr) && (nextTitle >= end))
-    {
-        nextTitle = nullptr;
-    }
-
-    if ((nextArtist != nullptr) && (nextArtist >= end))
-    {
-        nextArtist = nullptr;
-    }
+    const char *nextField = end;
 
-    if ((nextComment != nullptr) && (nextComment >= end))
+    for (const char *fieldStr: { _NAME_STR, _AUTHOR_STR, _TITLE_STR, _ARTIST_STR, _COMMENT_STR })
     {
-        nextComment = nullptr;
-    }
+        const char *next = findStr(temp + 1, nextField, fieldStr);
 
-    // Now determine which one is the closest to our field - that one
-    // will mark the end of the required field.
-
-    const char *nextField = nextName;
-
-    if (nextField == nullptr)
-    {
-        nextField = nextAuthor;
-    }
-    else if ((nextAuthor != nullptr) && (nextAuthor < nextField))
-    {
-        nextField = nextAuthor;
-    }
-
-    if (nextField == nullptr)
-    {
-        nextField = nextTitle;
-    }
-    else if ((nextTitle != nullptr) && (nextTitle < nextField))
-    {
-        nextField = nextTitle;
-    }
-
-    if (nextField == nullptr)
-    {
-        nextField = nextArtist;
-    }
-    else if ((nextArtist != nullptr) && (nextArtist < nextField))
-    {
-        nextField = nextArtist;
-    }
-
-    if (nextField == nullptr)
-    {
-        nextField = nextComment;
-    }
-    else if ((nextComment != nullptr) && (nextComment < nextField))
-    {
-        nextField = nextComment;
-    }
-
-    if (nextField == nullptr)
-    {
-        nextField = end;
-    }
-
-    // Now nextField points to the last+1 char that should be copied to
-    // result. Do that.
-
-    result.append(temp, nextField - temp);
-    return true;
-}
-
-void
-STIL::getStilLine(ifstream &infile, string &line)
-{
-    if (STIL_EOL2 != '\0')
-    {
-        // If there was a remaining EOL char from the previous read, eat it up.
-
-        char temp = infile.peek();
-
-        if ((temp == 0x0d) || (temp == 0x0a))
+        if (next != nullptr)
         {
-            infile.get(temp);
+            nextField = next;
         }
     }
 
-    getline(infile, line, STIL_EOL);
+    // Now nextField points to the last+1 char of the field.
+
+    first = temp;
+    last = nextField;
+    return true;
 }
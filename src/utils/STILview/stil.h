@@ -23,10 +23,15 @@
 #ifndef STIL_H
 #define STIL_H
 
+#include <cstddef>
 #include <string>
 #include <algorithm>
-#include <map>
-#include <iosfwd>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#  include <string_view>
+#  define STIL_HAS_STRING_VIEW
+#endif
 
 #include "stildefs.h"
 
@@ -41,6 +46,11 @@
  * given tune of a given SID file. (Sounds simple, huh?)
  *
  * PLEASE, READ THE ACCOMPANYING README.TXT FILE BEFORE PROCEEDING!!!!
+ *
+ * STIL.txt and BUGlist.txt are read and indexed once by setBaseDir(),
+ * queries never touch the files again.
+ * The const query methods can be called from many threads at once,
+ * as long as setBaseDir() is not called at the same time.
  */
 class STIL_EXTERN STIL
 {
@@ -236,6 +246,35 @@ public:
      */
     const char *getAbsBug(const char *absPathToEntry, int tuneNo = 0);
 
+#ifdef STIL_HAS_STRING_VIEW
+    /**
+     * Thread safe form of #getEntry.
+     *
+     * The returned view points into the index and stays valid
+     * until the next call to setBaseDir() or the object is destroyed.
+     *
+     * @return the requested STIL field, empty if there is none
+     * @since 3.1
+     */
+    std::string_view entry(std::string_view relPathToEntry, int tuneNo = 0, STILField field = all) const;
+
+    /**
+     * Thread safe form of #getGlobalComment.
+     *
+     * @return the section-global comment, empty if there is none
+     * @since 3.1
+     */
+    std::string_view globalComment(std::string_view relPathToEntry) const;
+
+    /**
+     * Thread safe form of #getBug.
+     *
+     * @return the BUG entry, empty if there is none
+     * @since 3.1
+     */
+    std::string_view bug(std::string_view relPathToEntry, int tuneNo = 0) const;
+#endif
+
     /**
      * Returns a specific error number identifying the problem
      * that happened at the last invoked public method.
@@ -268,7 +307,41 @@ public:
     inline const char *getErrorStr() const {return (STIL_ERROR_STR[lastError]);}
 
 private:
-    typedef std::map<std::string, std::streampos> dirList;
+    /// An entry of STIL.txt or BUGlist.txt.
+    struct entry_t
+    {
+        /// Offset and length of the pathname
+        size_t path;
+        size_t pathLength;
+
+        /// Offsets of the entry text, after the pathname line
+        size_t begin;
+        size_t end;
+
+        /// Range of the entry's tune designations in the tunes table
+        size_t firstTune;
+        size_t tunes;
+    };
+
+    /// A "(#n)" tune designation inside a multitune entry.
+    struct tune_t
+    {
+        int tuneNo;
+
+        /// Offset of the designation line
+        size_t begin;
+    };
+
+    /// A whole file with its entries sorted by pathname.
+    struct index_t
+    {
+        /// File contents with the line ends converted to '\n'
+        std::string text;
+
+        std::vector<entry_t> entries;
+
+        std::vector<tune_t> tunes;
+    };
 
     /// Path to STIL.
     const char *PATH_TO_STIL;
@@ -285,19 +358,12 @@ private:
     /// Base dir
     std::string baseDir;
 
-    /// Maps of sections (subdirs) for easier positioning.
+    /// The indexed files.
     //@{
-    dirList stilDirs;
-    dirList bugDirs;
+    index_t stilIndex;
+    index_t bugIndex;
     //@}
 
-    /**
-     * This tells us what the line delimiter is in STIL.txt.
-     * (It may be two chars!)
-     */
-    char STIL_EOL;
-    char STIL_EOL2;
-
     /// Error number of the last error that happened.
     STILerror lastError;
 
@@ -306,17 +372,9 @@ private:
 
     ////////////////
 
-    /// The last retrieved entry
-    std::string entrybuf;
-
-    /// The last retrieved section-global comment
-    std::string globalbuf;
-
-    /// The last retrieved BUGentry
-    std::string bugbuf;
-
     /// Buffers to hold the resulting strings
     std::string resultEntry;
+    std::string resultGlobal;
     std::string resultBug;
 
     ////////////////
@@ -324,97 +382,121 @@ private:
     void setVersionString();
 
     /**
-     * Determines what the EOL char is (or are) from STIL.txt.
-     * It is assumed that BUGlist.txt will use the same EOL.
+     * Reads a whole file converting the line ends to '\n'.
      *
+     * @param fileName - the file to read
+     * @param text     - where to put the contents
      * @return
-     *      - false - something went wrong
+     *      - false - the file could not be read
      *      - true  - everything is okay
      */
-    bool determineEOL(std::ifstream &stilFile);
+    static bool readFile(const std::string &fileName, std::string &text);
 
     /**
-     * Populates the given dirList array with the directories
-     * obtained from 'inFile' for faster positioning within
-     * 'inFile'.
+     * Populates the entries and tunes of 'index' from its text.
+     * If 'version' is not null the STIL version number is scanned
+     * in from the header too.
      *
-     * @param inFile - where to read the directories from
-     * @param dirs   - the dirList array that should be populated with the
-     *                 directory list
-     * @param isSTILFile - is this the STIL or the BUGlist we are parsing
+     * @param index   - the index to populate
+     * @param version - where to put the version number, if not null
      * @return
-     *      - false - No entries were found or otherwise failed to process
-     *                inFile
+     *      - false - No entries were found
      *      - true  - everything is okay
      */
-    bool getDirs(std::ifstream &inFile, dirList &dirs, bool isSTILFile);
+    static bool buildIndex(index_t &index, float *version);
 
     /**
-     * Positions the file pointer to the given entry in 'inFile'
-     * using the 'dirs' dirList for faster positioning.
+     * Finds an entry in 'index'.
      *
-     * @param entryStr - the entry to position to
-     * @param inFile   - position the file pointer in this file
-     * @param dirs     - the list of dirs in inFile for easier positioning
-     * @return
-     *      - true - if successful
-     *      - false - otherwise
+     * @param index      - the index to search
+     * @param entryStr   - the pathname of the entry
+     * @param entryLen   - the length of the pathname
+     * @return the entry or null if not found
      */
-    bool positionToEntry(const char *entryStr, std::ifstream &inFile, dirList &dirs);
+    const entry_t *findEntry(const index_t &index, const char *entryStr, size_t entryLen) const;
 
     /**
-     * Reads the entry from 'inFile' into 'buffer'. 'inFile' should
-     * already be positioned to the entry to be read.
+     * The lookups behind both the buffered and the thread safe queries.
+     * The requested text is put into [first, last), both are null
+     * if there's none.
      *
-     * @param inFile   - filehandle of file to read from
-     * @param entryStr - the entry needed to be read
-     * @param buffer   - where to put the result to
+     * @return the error to report
      */
-    void readEntry(std::ifstream &inFile, std::string &buffer);
+    //@{
+    STILerror lookupEntry(const char *relPathToEntry, size_t length, int tuneNo, STILField field,
+        const char *&first, const char *&last) const;
+    STILerror lookupGlobalComment(const char *relPathToEntry, size_t length,
+        const char *&first, const char *&last) const;
+    STILerror lookupBug(const char *relPathToEntry, size_t length, int tuneNo,
+        const char *&first, const char *&last) const;
+    //@}
 
     /**
-     * Given a STIL formatted entry in 'buffer', a tune number,
-     * and a field designation, it returns the requested
-     * STIL field into 'result'.
-     * If field=all, it also puts the file-global comment (if it exists)
-     * as the first field into 'result'.
+     * Given a STIL formatted entry, a tune number,
+     * and a field designation, it finds the requested
+     * STIL field.
+     * If field=all, it also includes the file-global comment (if it exists)
+     * as the first field.
      *
-     * @param result - where to put the resulting string to (if any)
-     * @param buffer - pointer to the first char of what to search for
-     *                 the field. Should be a buffer in standard STIL
-     *                 format.
+     * @param index  - the index holding the entry
+     * @param entry  - the entry to search
      * @param tuneNo - song number within the song (default=0)
      * @param field  - which field to retrieve (default=all).
+     * @param first  - set to the first char of the field
+     * @param last   - set to the last+1 char of the field
      * @return
-     *      - false - if nothing was put into 'result'
-     *      - true  - 'result' has the resulting field
+     *      - false - if the field was not found
+     *      - true  - [first, last) has the resulting field
      */
-    bool getField(std::string &result, const char *buffer, int tuneNo = 0, STILField field = all) const;
+    bool getField(const index_t &index, const entry_t &entry, int tuneNo, STILField field,
+        const char *&first, const char *&last) const;
 
     /**
-     * @param result - where to put the resulting string to (if any)
      * @param start  - pointer to the first char of what to search for
      *                 the field. Should be a buffer in standard STIL
      *                 format.
      * @param end    - pointer to the last+1 char of what to search for
      *                 the field. ('end-1' should be a '\n'!)
      * @param field  - which specific field to retrieve
+     * @param first  - set to the first char of the field
+     * @param last   - set to the last+1 char of the field
      * @return
-     *      - false - if nothing was put into 'result'
-     *      - true  - 'result' has the resulting field
+     *      - false - if the field was not found
+     *      - true  - [first, last) has the resulting field
      */
-    bool getOneField(std::string &result, const char *start, const char *end, STILField field) const;
-
-    /**
-     * Extracts one line from 'infile' to 'line[]'. The end of
-     * the line is marked by endOfLineChar. Also eats up
-     * additional EOL-like chars.
-     *
-     * @param infile - filehandle (streampos should already be positioned
-     *                 to the start of the desired line)
-     * @param line   - char array to put the line into
-     */
-    void getStilLine(std::ifstream &infile, std::string &line);
+    bool getOneField(const char *start, const char *end, STILField field,
+        const char *&first, const char *&last) const;
 };
 
+#ifdef STIL_HAS_STRING_VIEW
+// Defined inline on top of the lookups, so that the exported
+// symbols don't depend on the C++ standard in use
+inline std::string_view
+STIL::entry(std::string_view relPathToEntry, int tuneNo, STILField field) const
+{
+    const char *first;
+    const char *last;
+    lookupEntry(relPathToEntry.data(), relPathToEntry.size(), tuneNo, field, first, last);
+    return first != nullptr ? std::string_view(first, last - first) : std::string_view();
+}
+
+inline std::string_view
+STIL::globalComment(std::string_view relPathToEntry) const
+{
+    const char *first;
+    const char *last;
+    lookupGlobalComment(relPathToEntry.data(), relPathToEntry.size(), first, last);
+    return first != nullptr ? std::string_view(first, last - first) : std::string_view();
+}
+
+inline std::string_view
+STIL::bug(std::string_view relPathToEntry, int tuneNo) const
+{
+    const char *first;
+    const char *last;
+    lookupBug(relPathToEntry.data(), relPathToEntry.size(), tuneNo, first, last);
+    return first != nullptr ? std::string_view(first, last - first) : std::string_view();
+}
+#endif
+
 #endif // STIL_H
@@ -0,0 +1,716 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "SidCatalog.h"
+#include "SidDatabase.h"
+#include "SidPack.h"
+
+#include "sidplayfp/SidTune.h"
+
+#include "mappedfile.h"
+#include "sidendian.h"
+
+#include "sidcxx11.h"
+
+#ifdef HAVE_CXX17
+#  include <filesystem>
+#endif
+
+const char ERR_NO_CATALOG_LOADED[]      = "SID CATALOG ERROR: No catalog loaded.";
+const char ERR_UNABLE_TO_LOAD_CATALOG[] = "SID CATALOG ERROR: Unable to load the catalog.";
+const char ERR_CATALOG_CORRUPT[]        = "SID CATALOG ERROR: Catalog seems to be corrupt.";
+const char ERR_NO_ERROR[]               = "No errors";
+
+// Catalog file, all values are little endian:
+//
+// header:  "SCAT", version, number of tunes, number of lengths,
+//          size of the string table, unused (32 bit each)
+// columns: one array per field with an element for each tune,
+//          sorted by path, see COLUMN_SIZE
+// lengths: milliseconds, -1 if unknown (32 bit each)
+// strings: null terminated, starting with the empty string
+const char CATALOG_MAGIC[] = "SCAT";
+constexpr uint_least32_t CATALOG_VERSION = 1;
+constexpr size_t HEADER_SIZE = 24;
+constexpr size_t MD5_SIZE = 16;
+
+/// Tunes loaded by a worker before fingerprinting them at once
+constexpr size_t BATCH_SIZE = 16;
+
+enum
+{
+    COL_PATH,           // string offset
+    COL_TITLE,          // string offset
+    COL_AUTHOR,         // string offset
+    COL_RELEASED,       // string offset
+    COL_STIL,           // string offset
+    COL_MD5,            // binary md5
+    COL_MD5NEW,         // binary md5
+    COL_STAMP,          // modification time of the file or hash of the packed file
+    COL_SIZE,           // file size
+    COL_FIRST_LENGTH,   // index of the first length
+    COL_YEAR,
+    COL_SONGS,
+    COL_SID_MODEL,
+    COL_SID_CHIPS,
+    COLUMNS
+};
+
+const size_t COLUMN_SIZE[COLUMNS] = { 4, 4, 4, 4, 4, MD5_SIZE, MD5_SIZE, 8, 4, 4, 2, 2, 1, 1 };
+
+/**
+ * Size of all the columns of a tune.
+ */
+static size_t rowSize()
+{
+    size_t size = 0;
+    for (size_t columnSize: COLUMN_SIZE)
+        size += columnSize;
+    return size;
+}
+
+/**
+ * Offset of a column from the end of the header.
+ */
+static uint_least64_t columnOffset(unsigned int id, uint_least64_t tunes)
+{
+    uint_least64_t offset = 0;
+    for (unsigned int i = 0; i < id; i++)
+        offset += COLUMN_SIZE[i] * tunes;
+    return offset;
+}
+
+/**
+ * Formats other than PSID have no fingerprints, stored as zeros.
+ */
+static void toBinary(const char *hex, uint8_t *digest)
+{
+    if ((hex == nullptr) || (hex[0] == '\0'))
+    {
+        std::fill(digest, digest + MD5_SIZE, 0);
+        return;
+    }
+
+    for (size_t i = 0; i < MD5_SIZE; i++)
+    {
+        const char byte[3] = { hex[i * 2], hex[i * 2 + 1], '\0' };
+        digest[i] = static_cast<uint8_t>(std::strtoul(byte, nullptr, 16));
+    }
+}
+
+static char *toHex(const uint8_t *digest, char *hex)
+{
+    if (std::all_of(digest, digest + MD5_SIZE, [](uint8_t byte) { return byte == 0; }))
+    {
+        hex[0] = '\0';
+        return hex;
+    }
+
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < MD5_SIZE; i++)
+    {
+        hex[i * 2] = digits[digest[i] >> 4];
+        hex[i * 2 + 1] = digits[digest[i] & 0x0f];
+    }
+    hex[MD5_SIZE * 2] = '\0';
+    return hex;
+}
+
+/**
+ * Year at the start of the released string, e.g. "1987 Firebird".
+ */
+static unsigned int releaseYear(const char *released)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        if (!isdigit(static_cast<unsigned char>(released[i])))
+            return 0;
+    }
+    return std::atoi(std::string(released, 4).c_str());
+}
+
+namespace
+{
+
+/**
+ * A catalog row while building.
+ */
+struct record_t
+{
+    std::string path;
+    std::string fileName;
+    int_least64_t stamp;
+    uint_least32_t size;
+
+    bool valid;
+    std::string title;
+    std::string author;
+    std::string released;
+    std::string stil;
+    std::array<uint8_t, MD5_SIZE> md5;
+    std::array<uint8_t, MD5_SIZE> md5New;
+    unsigned int year;
+    unsigned int songs;
+    unsigned int sidModel;
+    unsigned int sidChips;
+    std::vector<int_least32_t> lengths;
+
+    record_t() :
+        stamp(0),
+        size(0),
+        valid(false),
+        year(0),
+        songs(0),
+        sidModel(0),
+        sidChips(0)
+    {}
+};
+
+}
+
+/**
+ * Load a tune and read its information.
+ * The header is probed first so that the files
+ * which are no tunes are not loaded.
+ *
+ * @return false if not a tune or the companion of another one
+ */
+static bool loadRecord(record_t &record, const SidPack *pack, SidTune &tune)
+{
+    if (pack != nullptr)
+    {
+        SidPack::entry_t entry;
+        if (!pack->find(record.path.c_str(), entry))
+            return false;
+        tune.probe(entry.data, entry.size);
+    }
+    else
+        tune.probe(record.fileName.c_str());
+
+    if (!tune.getStatus())
+        return false;
+
+    if (pack != nullptr)
+        pack->load(record.path.c_str(), tune);
+    else
+        tune.load(record.fileName.c_str());
+
+    if (!tune.getStatus())
+        return false;
+
+    const SidTuneInfo *info = tune.getInfo();
+
+    // The companion files of two-file tunes, e.g. STR,
+    // load the whole tune which is listed under its data file.
+    // Single-file tunes read from the pack are named "-".
+    const char *dataFileName = info->dataFileName();
+    const size_t nameLen = std::strlen(dataFileName);
+    if ((std::strcmp(dataFileName, "-") != 0)
+        && ((record.path.size() < nameLen)
+            || (record.path.compare(record.path.size() - nameLen, nameLen, dataFileName) != 0)))
+    {
+        return false;
+    }
+
+    const unsigned int infoStrings = info->numberOfInfoStrings();
+    record.title = (infoStrings > 0) ? info->infoString(0) : "";
+    record.author = (infoStrings > 1) ? info->infoString(1) : "";
+    record.released = (infoStrings > 2) ? info->infoString(2) : "";
+    record.year = releaseYear(record.released.c_str());
+    record.songs = info->songs();
+    record.sidModel = info->sidModel(0);
+    record.sidChips = info->sidChips();
+    return true;
+}
+
+/**
+ * Fingerprint the loaded tunes of a batch at once.
+ */
+static void hashRecords(record_t *const *records, SidTune *const *tunes, unsigned int count)
+{
+    SidTune::createMD5Batch(tunes, count);
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        toBinary(tunes[i]->createMD5(), records[i]->md5.data());
+        toBinary(tunes[i]->createMD5New(), records[i]->md5New.data());
+        records[i]->valid = true;
+    }
+}
+
+/**
+ * Add the songlengths and the STIL entry.
+ */
+static void joinRecord(record_t &record, const SidCatalog::options_t &options)
+{
+    record.lengths.assign(record.songs, -1);
+    if (options.songlengths != nullptr)
+    {
+        char md5[MD5_SIZE * 2 + 1];
+        toHex(record.md5New.data(), md5);
+        for (unsigned int song = 1; (md5[0] != '\0') && (song <= record.songs); song++)
+        {
+            int_least32_t length;
+            if (options.songlengths->lookup(md5, song, length) == SidDatabase::OK)
+                record.lengths[song - 1] = length;
+        }
+    }
+
+    record.stil = options.stil ? options.stil(record.path.c_str()) : "";
+}
+
+/**
+ * List the files of a collection directory.
+ */
+static bool scanDirectory(const char *source, std::vector<record_t> &records)
+{
+#ifdef HAVE_CXX17
+    std::error_code ec;
+    const std::filesystem::path root(source);
+    std::filesystem::recursive_directory_iterator it(root, ec);
+    if (ec)
+        return false;
+
+    for (; it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+    {
+        if (ec)
+            return false;
+
+        if (!it->is_regular_file(ec))
+            continue;
+
+        record_t record;
+        record.fileName = it->path().string();
+        record.path = "/" + it->path().lexically_relative(root).generic_string();
+        record.stamp = it->last_write_time(ec).time_since_epoch().count();
+        record.size = it->file_size(ec);
+        records.push_back(record);
+    }
+    return true;
+#else
+    // Directory scanning needs std::filesystem, packs are still supported
+    (void)source;
+    (void)records;
+    return false;
+#endif
+}
+
+/**
+ * List the files of a pack, the stamp is derived from the md5.
+ */
+static void scanPack(const SidPack &pack, std::vector<record_t> &records)
+{
+    for (size_t i = 0; i < pack.count(); i++)
+    {
+        SidPack::entry_t entry;
+        if (!pack.entry(i, entry))
+            continue;
+
+        record_t record;
+        record.path = entry.path;
+        record.stamp = static_cast<int_least64_t>(std::strtoull(std::string(entry.md5, 16).c_str(), nullptr, 16));
+        record.size = entry.size;
+        records.push_back(record);
+    }
+}
+
+/**
+ * Take the unchanged tunes from the previous catalog.
+ */
+static bool reuseRecord(record_t &record, const SidCatalog &previous, const uint8_t *stamps)
+{
+    size_t index;
+    if (!previous.find(record.path.c_str(), index))
+        return false;
+
+    if ((static_cast<int_least64_t>(endian_little64(stamps + index * 8)) != record.stamp)
+        || (previous.size(index) != record.size))
+    {
+        return false;
+    }
+
+    char md5[MD5_SIZE * 2 + 1];
+    toBinary(previous.md5(index, md5), record.md5.data());
+    toBinary(previous.md5New(index, md5), record.md5New.data());
+    record.title = previous.title(index);
+    record.author = previous.author(index);
+    record.released = previous.released(index);
+    record.year = previous.year(index);
+    record.songs = previous.songs(index);
+    record.sidModel = previous.sidModel(index);
+    record.sidChips = previous.sidChips(index);
+    record.valid = true;
+    return true;
+}
+
+/**
+ * Write the catalog.
+ */
+static bool writeCatalog(const std::vector<const record_t*> &records, const char *output)
+{
+    const uint_least64_t tunes = records.size();
+
+    std::string strings(1, '\0');
+    std::unordered_map<std::string, uint_least32_t> offsets;
+    offsets.emplace("", 0);
+    auto addString = [&strings, &offsets](const std::string &str) -> uint_least32_t
+    {
+        auto it = offsets.find(str);
+        if (it != offsets.end())
+            return it->second;
+
+        const uint_least32_t offset = strings.size();
+        strings.append(str.c_str(), str.size() + 1);
+        offsets.emplace(str, offset);
+        return offset;
+    };
+
+    uint_least64_t lengths = 0;
+    for (const record_t *record: records)
+        lengths += record->lengths.size();
+
+    const uint_least64_t columnsEnd = HEADER_SIZE + tunes * rowSize();
+    std::vector<uint8_t> data(columnsEnd + lengths * 4, 0);
+
+    uint8_t *columns[COLUMNS];
+    for (unsigned int id = 0; id < COLUMNS; id++)
+        columns[id] = data.data() + HEADER_SIZE + columnOffset(id, tunes);
+
+    uint8_t *length = data.data() + columnsEnd;
+    uint_least32_t firstLength = 0;
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const record_t &record = *records[i];
+        endian_little32(columns[COL_PATH] + i * 4, addString(record.path));
+        endian_little32(columns[COL_TITLE] + i * 4, addString(record.title));
+        endian_little32(columns[COL_AUTHOR] + i * 4, addString(record.author));
+        endian_little32(columns[COL_RELEASED] + i * 4, addString(record.released));
+        endian_little32(columns[COL_STIL] + i * 4, addString(record.stil));
+        std::memcpy(columns[COL_MD5] + i * MD5_SIZE, record.md5.data(), MD5_SIZE);
+        std::memcpy(columns[COL_MD5NEW] + i * MD5_SIZE, record.md5New.data(), MD5_SIZE);
+        endian_little64(columns[COL_STAMP] + i * 8, static_cast<uint_least64_t>(record.stamp));
+        endian_little32(columns[COL_SIZE] + i * 4, record.size);
+        endian_little32(columns[COL_FIRST_LENGTH] + i * 4, firstLength);
+        endian_little16(columns[COL_YEAR] + i * 2, record.year);
+        endian_little16(columns[COL_SONGS] + i * 2, record.songs);
+        columns[COL_SID_MODEL][i] = record.sidModel;
+        columns[COL_SID_CHIPS][i] = record.sidChips;
+
+        for (int_least32_t ms: record.lengths)
+        {
+            endian_little32(length, static_cast<uint_least32_t>(ms));
+            length += 4;
+        }
+        firstLength += record.lengths.size();
+    }
+
+    std::memcpy(data.data(), CATALOG_MAGIC, 4);
+    endian_little32(data.data() + 4, CATALOG_VERSION);
+    endian_little32(data.data() + 8, tunes);
+    endian_little32(data.data() + 12, lengths);
+    endian_little32(data.data() + 16, strings.size());
+
+    std::ofstream out(output, std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+    out.write(strings.data(), strings.size());
+    out.close();
+    return !out.fail();
+}
+
+bool SidCatalog::build(const char *source, const char *output,
+                        const options_t &options, stats_t *stats)
+{
+    std::vector<record_t> records;
+
+    SidPack pack;
+    const bool isPack = pack.open(source);
+    if (isPack)
+        scanPack(pack, records);
+    else if (!scanDirectory(source, records))
+        return false;
+
+    std::sort(records.begin(), records.end(), [](const record_t &a, const record_t &b)
+        { return std::strcmp(a.path.c_str(), b.path.c_str()) < 0; });
+
+    size_t reused = 0;
+    {
+        SidCatalog previous;
+        const bool refresh = (options.previous != nullptr) && previous.open(options.previous);
+        const uint8_t *stamps = refresh ? previous.column(COL_STAMP) : nullptr;
+        for (record_t &record: records)
+        {
+            if (refresh && reuseRecord(record, previous, stamps))
+                reused++;
+        }
+    }
+
+    // Each worker takes the next batch of files, the results
+    // go to separate records so no locking is needed.
+    // The joins are cheap and redone for the reused tunes
+    // so that updated songlengths and STIL entries are picked up.
+    const size_t batches = (records.size() + BATCH_SIZE - 1) / BATCH_SIZE;
+    unsigned int threads = (options.threads != 0) ? options.threads : std::thread::hardware_concurrency();
+    threads = std::max(1u, std::min<unsigned int>(threads, std::max<size_t>(batches, 1)));
+
+    std::atomic<size_t> next(0);
+    auto worker = [&next, &records, &options, &pack, isPack]()
+    {
+        std::vector<std::unique_ptr<SidTune>> tunes;
+        for (size_t first = next.fetch_add(BATCH_SIZE); first < records.size(); first = next.fetch_add(BATCH_SIZE))
+        {
+            const size_t last = std::min(first + BATCH_SIZE, records.size());
+
+            record_t *loaded[BATCH_SIZE];
+            SidTune *loadedTunes[BATCH_SIZE];
+            unsigned int count = 0;
+            for (size_t i = first; i < last; i++)
+            {
+                if (records[i].valid)
+                    continue;
+
+                if (tunes.size() == count)
+                    tunes.emplace_back(new SidTune(nullptr));
+
+                if (loadRecord(records[i], isPack ? &pack : nullptr, *tunes[count]))
+                {
+                    loaded[count] = &records[i];
+                    loadedTunes[count] = tunes[count].get();
+                    count++;
+                }
+            }
+
+            hashRecords(loaded, loadedTunes, count);
+
+            for (size_t i = first; i < last; i++)
+            {
+                if (records[i].valid)
+                    joinRecord(records[i], options);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threads; t++)
+        workers.emplace_back(worker);
+    worker();
+    for (std::thread &thread: workers)
+        thread.join();
+
+    std::vector<const record_t*> tunes;
+    for (const record_t &record: records)
+    {
+        if (record.valid)
+            tunes.push_back(&record);
+    }
+
+    // The previous catalog may be the output, it is closed by now.
+    const std::string temp = std::string(output) + ".tmp";
+    if (!writeCatalog(tunes, temp.c_str()))
+    {
+        std::remove(temp.c_str());
+        return false;
+    }
+    std::remove(output);
+    if (std::rename(temp.c_str(), output) != 0)
+        return false;
+
+    if (stats != nullptr)
+    {
+        stats->files = records.size();
+        stats->tunes = tunes.size();
+        stats->loaded = tunes.size() - reused;
+        stats->reused = reused;
+    }
+    return true;
+}
+
+SidCatalog::SidCatalog() :
+    m_file(nullptr),
+    m_tunes(0),
+    errorString(ERR_NO_CATALOG_LOADED)
+{}
+
+SidCatalog::~SidCatalog()
+{
+    delete m_file;
+}
+
+bool SidCatalog::open(const char *filename)
+{
+    close();
+
+    m_file = new libsidplayfp::mappedFile();
+    if (!m_file->open(filename))
+    {
+        close();
+        errorString = ERR_UNABLE_TO_LOAD_CATALOG;
+        return false;
+    }
+
+    const uint8_t *data = m_file->data();
+    const uint_least64_t size = m_file->size();
+    if ((size < HEADER_SIZE)
+        || (std::memcmp(data, CATALOG_MAGIC, 4) != 0)
+        || (endian_little32(data + 4) != CATALOG_VERSION))
+    {
+        close();
+        errorString = ERR_UNABLE_TO_LOAD_CATALOG;
+        return false;
+    }
+
+    // The string table must start with the empty string and
+    // end with a null terminator so that any offset into it
+    // yields a valid string.
+    const uint_least64_t tunes = endian_little32(data + 8);
+    const uint_least64_t lengths = endian_little32(data + 12);
+    const uint_least64_t stringsSize = endian_little32(data + 16);
+    const uint_least64_t stringsStart = HEADER_SIZE + tunes * rowSize() + lengths * 4;
+    if ((stringsSize == 0)
+        || (stringsStart + stringsSize > size)
+        || (data[stringsStart] != '\0')
+        || (data[stringsStart + stringsSize - 1] != '\0'))
+    {
+        close();
+        errorString = ERR_CATALOG_CORRUPT;
+        return false;
+    }
+
+    m_tunes = tunes;
+    errorString = ERR_NO_ERROR;
+    return true;
+}
+
+void SidCatalog::close()
+{
+    delete m_file;
+    m_file = nullptr;
+    m_tunes = 0;
+    errorString = ERR_NO_CATALOG_LOADED;
+}
+
+const uint8_t *SidCatalog::column(unsigned int id) const
+{
+    return m_file->data() + HEADER_SIZE + columnOffset(id, m_tunes);
+}
+
+const char *SidCatalog::string(unsigned int id, size_t index) const
+{
+    const uint8_t *data = m_file->data();
+    const uint_least32_t lengths = endian_little32(data + 12);
+    const uint_least32_t stringsSize = endian_little32(data + 16);
+    const char *strings = reinterpret_cast<const char*>(data + HEADER_SIZE + m_tunes * rowSize() + lengths * 4);
+
+    const uint_least32_t offset = endian_little32(column(id) + index * 4);
+    return (offset < stringsSize) ? strings + offset : "";
+}
+
+bool SidCatalog::find(const char *path, size_t &index) const
+{
+    size_t first = 0;
+    size_t last = m_tunes;
+    while (first < last)
+    {
+        const size_t middle = first + (last - first) / 2;
+        const int cmp = std::strcmp(string(COL_PATH, middle), path);
+        if (cmp == 0)
+        {
+            index = middle;
+            return true;
+        }
+
+        if (cmp < 0)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    return false;
+}
+
+const char *SidCatalog::path(size_t index) const { return string(COL_PATH, index); }
+const char *SidCatalog::title(size_t index) const { return string(COL_TITLE, index); }
+const char *SidCatalog::author(size_t index) const { return string(COL_AUTHOR, index); }
+const char *SidCatalog::released(size_t index) const { return string(COL_RELEASED, index); }
+const char *SidCatalog::stil(size_t index) const { return string(COL_STIL, index); }
+
+unsigned int SidCatalog::year(size_t index) const
+{
+    return endian_little16(column(COL_YEAR) + index * 2);
+}
+
+SidTuneInfo::model_t SidCatalog::sidModel(size_t index) const
+{
+    const uint8_t model = column(COL_SID_MODEL)[index];
+    return (model <= SidTuneInfo::SIDMODEL_ANY) ? static_cast<SidTuneInfo::model_t>(model) : SidTuneInfo::SIDMODEL_UNKNOWN;
+}
+
+unsigned int SidCatalog::sidChips(size_t index) const
+{
+    return column(COL_SID_CHIPS)[index];
+}
+
+unsigned int SidCatalog::songs(size_t index) const
+{
+    return endian_little16(column(COL_SONGS) + index * 2);
+}
+
+uint_least32_t SidCatalog::size(size_t index) const
+{
+    return endian_little32(column(COL_SIZE) + index * 4);
+}
+
+int_least32_t SidCatalog::lengthMs(size_t index, unsigned int song) const
+{
+    if ((song == 0) || (song > songs(index)))
+        return -1;
+
+    const uint8_t *data = m_file->data();
+    const uint_least64_t lengths = endian_little32(data + 12);
+    const uint_least64_t first = endian_little32(column(COL_FIRST_LENGTH) + index * 4);
+    if (first + song > lengths)
+        return -1;
+
+    const uint8_t *times = data + HEADER_SIZE + m_tunes * rowSize();
+    return static_cast<int_least32_t>(endian_little32(times + (first + song - 1) * 4));
+}
+
+char *SidCatalog::md5(size_t index, char *md5) const
+{
+    return toHex(column(COL_MD5) + index * MD5_SIZE, md5);
+}
+
+char *SidCatalog::md5New(size_t index, char *md5) const
+{
+    return toHex(column(COL_MD5NEW) + index * MD5_SIZE, md5);
+}
@@ -0,0 +1,185 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIDCATALOG_H
+#define SIDCATALOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "sidplayfp/siddefs.h"
+#include "sidplayfp/SidTuneInfo.h"
+
+class SidDatabase;
+
+namespace libsidplayfp
+{
+class mappedFile;
+}
+
+/**
+ * SidCatalog
+ * An utility class to build and read a catalog of a tune collection.
+ *
+ * The catalog joins the tune information, the fingerprints,
+ * the songlengths and the STIL entries in a single file.
+ * Each field is stored in its own array so that a scan over
+ * one field only touches that part of the memory mapped file.
+ *
+ * @since 3.1
+ */
+class SID_EXTERN SidCatalog
+{
+public:
+    /// Build options
+    struct options_t
+    {
+        /// Joined by the new md5 if not null, looked up from the worker threads
+        const SidDatabase *songlengths;
+
+        /// Returns the STIL entry of a collection path, may be empty.
+        /// Called concurrently from the worker threads.
+        std::function<std::string(const char *path)> stil;
+
+        /// Number of worker threads, 0 for one per core
+        unsigned int threads;
+
+        /// Catalog to refresh, the unchanged tunes are not read again.
+        /// May be the same file as the output.
+        const char *previous;
+
+        options_t() :
+            songlengths(nullptr),
+            threads(0),
+            previous(nullptr)
+        {}
+    };
+
+    /// Build statistics
+    struct stats_t
+    {
+        size_t files;       ///< files found
+        size_t tunes;       ///< tunes in the catalog
+        size_t loaded;      ///< tunes read and fingerprinted
+        size_t reused;      ///< unchanged tunes taken from the previous catalog
+    };
+
+private:
+    libsidplayfp::mappedFile* m_file;
+
+    uint_least32_t m_tunes;
+
+    const char *errorString;
+
+private:
+    const uint8_t *column(unsigned int id) const;
+
+    const char *string(unsigned int id, size_t index) const;
+
+public:
+    SidCatalog();
+    ~SidCatalog();
+
+    /**
+     * Build the catalog of a collection.
+     * The files are read in parallel, each worker probes the
+     * headers, loads the tunes and fingerprints them in batches.
+     * Files that can't be loaded are left out, in a pack
+     * only the PSID and MUS formats are recognized.
+     *
+     * @param source the collection root directory or a SidPack file
+     * @param output the catalog file name
+     * @param options the build options
+     * @param stats if not null filled with the build statistics
+     * @return false in case of errors, true otherwise.
+     */
+    static bool build(const char *source, const char *output,
+                        const options_t &options, stats_t *stats = nullptr);
+
+    /**
+     * Open a catalog created with #build().
+     *
+     * @param filename the catalog file name
+     * @return false in case of errors, true otherwise.
+     */
+    bool open(const char *filename);
+
+    /**
+     * Close the catalog.
+     */
+    void close();
+
+    /**
+     * Get the number of tunes, sorted by path.
+     */
+    size_t count() const { return m_tunes; }
+
+    /**
+     * Find a tune by its collection path.
+     *
+     * @param path the path, e.g. "/MUSICIANS/H/Hubbard_Rob/Commando.sid"
+     * @param index set to the position of the tune
+     * @return false if not found
+     */
+    bool find(const char *path, size_t &index) const;
+
+    /**
+     * @name Tune fields
+     * The index must be less than #count().
+     * All of them can be called concurrently from several threads.
+     */
+    //@{
+    const char *path(size_t index) const;       ///< collection path, with a leading slash
+    const char *title(size_t index) const;      ///< first info string
+    const char *author(size_t index) const;     ///< second info string
+    const char *released(size_t index) const;   ///< third info string
+    const char *stil(size_t index) const;       ///< STIL entry, may be empty
+    unsigned int year(size_t index) const;      ///< year of release, 0 if unknown
+    SidTuneInfo::model_t sidModel(size_t index) const;  ///< model of the first SID
+    unsigned int sidChips(size_t index) const;  ///< number of SIDs
+    unsigned int songs(size_t index) const;     ///< number of subtunes
+    uint_least32_t size(size_t index) const;    ///< file size
+
+    /**
+     * Get the length of a subtune.
+     *
+     * @return the length in milliseconds, -1 if unknown
+     */
+    int_least32_t lengthMs(size_t index, unsigned int song) const;
+
+    /**
+     * Get the fingerprints, see SidTune::createMD5 and SidTune::createMD5New.
+     *
+     * @param md5 a buffer of at least 33 bytes
+     * @return md5, empty if the format has no fingerprints
+     */
+    char *md5(size_t index, char *md5) const;
+    char *md5New(size_t index, char *md5) const;
+    //@}
+
+    /**
+     * Get descriptive error message.
+     */
+    const char *error() const { return errorString; }
+};
+
+#endif // SIDCATALOG_H
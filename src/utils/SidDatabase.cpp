@@ -20,8 +20,13 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#include <algorithm>
 #include <cctype>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
 
 #include "SidDatabase.h"
 
@@ -29,6 +34,8 @@
 #include "sidplayfp/SidTuneInfo.h"
 
 #include "iniParser.h"
+#include "mappedfile.h"
+#include "sidendian.h"
 
 #include "sidcxx11.h"
 
@@ -36,17 +43,34 @@ const char ERR_DATABASE_CORRUPT[]        = "SID DATABASE ERROR: Database seems t
 const char ERR_NO_DATABASE_LOADED[]      = "SID DATABASE ERROR: Songlength database not loaded.";
 const char ERR_NO_SELECTED_SONG[]        = "SID DATABASE ERROR: No song selected for retrieving song length.";
 const char ERR_UNABLE_TO_LOAD_DATABASE[] = "SID DATABASE ERROR: Unable to load the songlength database.";
+const char ERR_TUNE_NOT_FOUND[]          = "SID DATABASE ERROR: Tune not found in the database.";
+const char ERR_SUBTUNE_NOT_FOUND[]       = "SID DATABASE ERROR: Subtune not found in the database.";
+const char ERR_NO_ERROR[]                = "No errors";
 
 class parseError {};
 
+// Binary index, all values are little endian:
+//
+// header:  "SLDB", version, number of entries, number of lengths (32 bit each)
+// entries: sorted by md5, binary md5 (16 bytes), index of the
+//          first length (32 bit), songs (16 bit), unused (16 bit)
+// lengths: milliseconds (32 bit each)
+const char BINARY_MAGIC[] = "SLDB";
+constexpr uint_least32_t BINARY_VERSION = 1;
+constexpr size_t HEADER_SIZE = 16;
+constexpr size_t ENTRY_SIZE = 24;
+constexpr size_t MD5_SIZE = 16;
+
 SidDatabase::SidDatabase() :
     m_parser(nullptr),
+    m_binary(nullptr),
     errorString(ERR_NO_DATABASE_LOADED)
 {}
 
 SidDatabase::~SidDatabase()
 {
     delete m_parser;
+    delete m_binary;
 }
 
 // mm:ss[.SSS]
@@ -59,7 +83,7 @@ SidDatabase::~SidDatabase()
 //
 // 1:02.500
 //
-const char *parseTime(const char *str, int_least32_t &result)
+static const char *parseTime(const char *str, int_least32_t &result)
 {
     char *end;
     const long minutes = strtol(str, &end, 10);
@@ -99,12 +123,112 @@ const char *parseTime(const char *str, int_least32_t &result)
 }
 
 
-bool SidDatabase::open(const char *filename)
+static int hexDigit(char c)
 {
-    delete m_parser;
-    m_parser = new libsidplayfp::iniParser();
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+static bool parseMd5(const char *md5, uint8_t *digest)
+{
+    for (size_t i = 0; i < MD5_SIZE; i++)
+    {
+        const int hi = hexDigit(md5[i * 2]);
+        if (hi < 0)
+            return false;
+        const int lo = hexDigit(md5[i * 2 + 1]);
+        if (lo < 0)
+            return false;
+        digest[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return md5[MD5_SIZE * 2] == '\0';
+}
+
+static bool isBinary(const libsidplayfp::mappedFile &file)
+{
+    const uint8_t *data = file.data();
+    if ((file.size() < HEADER_SIZE) || (std::memcmp(data, BINARY_MAGIC, 4) != 0))
+        return false;
+
+    if (endian_little32(data + 4) != BINARY_VERSION)
+        return false;
+
+    const uint_least64_t entries = endian_little32(data + 8);
+    const uint_least64_t lengths = endian_little32(data + 12);
+    return file.size() == HEADER_SIZE + entries * ENTRY_SIZE + lengths * 4;
+}
+
+/*
+ * Binary search the index.
+ */
+static SidDatabase::status_t findLength(const uint8_t *data, const uint8_t *md5, unsigned int song, int_least32_t &length)
+{
+    const uint8_t *entries = data + HEADER_SIZE;
+    const uint_least32_t count = endian_little32(data + 8);
+    const uint_least32_t lengths = endian_little32(data + 12);
+
+    uint_least32_t lo = 0;
+    uint_least32_t hi = count;
+    while (lo < hi)
+    {
+        const uint_least32_t mid = lo + (hi - lo) / 2;
+        const uint8_t *entry = entries + mid * ENTRY_SIZE;
+        const int cmp = std::memcmp(entry, md5, MD5_SIZE);
+        if (cmp < 0)
+        {
+            lo = mid + 1;
+        }
+        else if (cmp > 0)
+        {
+            hi = mid;
+        }
+        else
+        {
+            const uint_least32_t first = endian_little32(entry + 16);
+            const unsigned int songs = endian_little16(entry + 20);
+            if ((song == 0) || (song > songs))
+                return SidDatabase::NO_SUBTUNE;
+            if (static_cast<uint_least64_t>(first) + song > lengths)
+                return SidDatabase::CORRUPT;
+
+            const uint8_t *times = entries + count * ENTRY_SIZE;
+            length = endian_little32(times + (first + song - 1) * 4);
+            return SidDatabase::OK;
+        }
+    }
+
+    return SidDatabase::NOT_FOUND;
+}
+
+template<typename T>
+static bool openDatabase(const T *filename, libsidplayfp::iniParser *&parser, libsidplayfp::mappedFile *&binary)
+{
+    delete parser;
+    parser = nullptr;
+
+    if (binary == nullptr)
+        binary = new libsidplayfp::mappedFile();
+
+    if (!binary->open(filename))
+        return false;
+
+    if (isBinary(*binary))
+        return true;
+
+    binary->close();
 
-    if (!m_parser->open(filename))
+    parser = new libsidplayfp::iniParser();
+    return parser->open(filename);
+}
+
+bool SidDatabase::open(const char *filename)
+{
+    if (!openDatabase(filename, m_parser, m_binary))
     {
         close();
         errorString = ERR_UNABLE_TO_LOAD_DATABASE;
@@ -117,10 +241,7 @@ bool SidDatabase::open(const char *filename)
 #ifdef _WIN32
 bool SidDatabase::open(const wchar_t* filename)
 {
-    delete m_parser;
-    m_parser = new libsidplayfp::iniParser();
-
-    if (!m_parser->open(filename))
+    if (!openDatabase(filename, m_parser, m_binary))
     {
         close();
         errorString = ERR_UNABLE_TO_LOAD_DATABASE;
@@ -135,6 +256,111 @@ void SidDatabase::close()
 {
     delete m_parser;
     m_parser = nullptr;
+    delete m_binary;
+    m_binary = nullptr;
+}
+
+bool SidDatabase::convert(const char *input, const char *output)
+{
+    struct entry_t
+    {
+        uint8_t md5[MD5_SIZE];
+        uint_least32_t first;
+        unsigned int songs;
+    };
+
+    std::ifstream in(input);
+    if (in.fail())
+        return false;
+
+    std::vector<entry_t> entries;
+    std::vector<uint_least32_t> lengths;
+
+    bool database = false;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || (line[0] == ';') || (line[0] == '#'))
+            continue;
+
+        if (line[0] == '[')
+        {
+            database = line.compare(0, 10, "[Database]") == 0;
+            continue;
+        }
+
+        const size_t pos = line.find('=');
+        if (!database || (pos == std::string::npos))
+            continue;
+
+        const std::string key = line.substr(0, line.find_last_not_of(' ', pos - 1) + 1);
+        entry_t entry;
+        if (!parseMd5(key.c_str(), entry.md5))
+            continue;
+
+        entry.first = lengths.size();
+
+        // keep the valid lengths, like the text lookup
+        const char *str = line.c_str() + pos + 1;
+        try
+        {
+            for (;;)
+            {
+                while (isspace(*str))
+                    str++;
+                if (*str == '\0')
+                    break;
+
+                int_least32_t time;
+                str = parseTime(str, time);
+                lengths.push_back(time);
+            }
+        }
+        catch (parseError const &) {}
+
+        entry.songs = lengths.size() - entry.first;
+        if (entry.songs > 0xffff)
+            return false;
+
+        if (entry.songs > 0)
+            entries.push_back(entry);
+    }
+
+    if (in.bad())
+        return false;
+
+    // the first occurrence wins, like the text lookup
+    std::stable_sort(entries.begin(), entries.end(), [](const entry_t &a, const entry_t &b)
+        { return std::memcmp(a.md5, b.md5, MD5_SIZE) < 0; });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const entry_t &a, const entry_t &b)
+        { return std::memcmp(a.md5, b.md5, MD5_SIZE) == 0; }), entries.end());
+
+    std::vector<uint8_t> data(HEADER_SIZE + entries.size() * ENTRY_SIZE + lengths.size() * 4, 0);
+
+    std::memcpy(data.data(), BINARY_MAGIC, 4);
+    endian_little32(data.data() + 4, BINARY_VERSION);
+    endian_little32(data.data() + 8, entries.size());
+    endian_little32(data.data() + 12, lengths.size());
+
+    uint8_t *ptr = data.data() + HEADER_SIZE;
+    for (const entry_t &entry: entries)
+    {
+        std::memcpy(ptr, entry.md5, MD5_SIZE);
+        endian_little32(ptr + 16, entry.first);
+        endian_little16(ptr + 20, entry.songs);
+        ptr += ENTRY_SIZE;
+    }
+
+    for (uint_least32_t length: lengths)
+    {
+        endian_little32(ptr, length);
+        ptr += 4;
+    }
+
+    std::ofstream out(output, std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+    out.close();
+    return !out.fail();
 }
 
 int_least32_t SidDatabase::length(SidTune &tune)
@@ -174,33 +400,50 @@ int_least32_t SidDatabase::length(const char *md5, unsigned int song)
 
 int_least32_t SidDatabase::lengthMs(const char *md5, unsigned int song)
 {
-    if (m_parser == nullptr)
+    int_least32_t time;
+    const status_t status = lookup(md5, song, time);
+    if (status != OK)
     {
-        errorString = ERR_NO_DATABASE_LOADED;
+        errorString = statusString(status);
         return -1;
     }
 
-    // Read Time (and check times before hand)
-    if (!m_parser->setSection("Database"))
+    return time;
+}
+
+SidDatabase::status_t SidDatabase::lookup(const char *md5, unsigned int song, int_least32_t &length) const
+{
+    if (m_binary != nullptr && m_binary->data() != nullptr)
     {
-        errorString = ERR_DATABASE_CORRUPT;
-        return -1;
+        uint8_t digest[MD5_SIZE];
+        if (!parseMd5(md5, digest))
+            return NOT_FOUND;
+
+        return findLength(m_binary->data(), digest, song, length);
     }
 
-    const char *timeStamp = m_parser->getValue(md5);
+    if (m_parser == nullptr)
+        return NOT_LOADED;
+
+    const char *timeStamp = m_parser->getValue("Database", md5);
 
     // If return is null then no entry found in database
     if (!timeStamp)
-    {
-        errorString = ERR_DATABASE_CORRUPT;
-        return -1;
-    }
+        return NOT_FOUND;
+
+    if (song == 0)
+        return NO_SUBTUNE;
 
     const char *str = timeStamp;
     int_least32_t time = 0;
 
     for (unsigned int i = 0; i < song; i++)
     {
+        while (isspace(*str))
+            str++;
+        if (*str == '\0')
+            return NO_SUBTUNE;
+
         // Validate Time
         try
         {
@@ -208,10 +451,41 @@ int_least32_t SidDatabase::lengthMs(const char *md5, unsigned int song)
         }
         catch (parseError const &)
         {
-            errorString = ERR_DATABASE_CORRUPT;
-            return -1;
+            return CORRUPT;
         }
     }
 
-    return time;
+    length = time;
+    return OK;
+}
+
+unsigned int SidDatabase::lookup(const query_t *queries, size_t count, int_least32_t *lengths, status_t *status) const
+{
+    unsigned int found = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        int_least32_t length = -1;
+        const status_t result = lookup(queries[i].md5, queries[i].song, length);
+        if (result == OK)
+            found++;
+        else
+            length = -1;
+
+        lengths[i] = length;
+        if (status != nullptr)
+            status[i] = result;
+    }
+    return found;
+}
+
+const char *SidDatabase::statusString(status_t status)
+{
+    switch (status)
+    {
+    case OK:         return ERR_NO_ERROR;
+    case NOT_LOADED: return ERR_NO_DATABASE_LOADED;
+    case NOT_FOUND:  return ERR_TUNE_NOT_FOUND;
+    case NO_SUBTUNE: return ERR_SUBTUNE_NOT_FOUND;
+    default:         return ERR_DATABASE_CORRUPT;
+    }
 }
@@ -23,6 +23,7 @@
 #ifndef SIDDATABASE_H
 #define SIDDATABASE_H
 
+#include <cstddef>
 #include <cstdint>
 
 #include "sidplayfp/siddefs.h"
@@ -32,6 +33,7 @@ class SidTune;
 namespace libsidplayfp
 {
 class iniParser;
+class mappedFile;
 }
 
 /**
@@ -40,9 +42,29 @@ class iniParser;
  */
 class SID_EXTERN SidDatabase
 {
+public:
+    /// Lookup status
+    enum status_t
+    {
+        OK,             ///< Length found
+        NOT_LOADED,     ///< No database loaded
+        NOT_FOUND,      ///< The tune is not in the database
+        NO_SUBTUNE,     ///< The tune has no such subtune
+        CORRUPT         ///< Malformed entry
+    };
+
+    /// A bulk lookup query
+    struct query_t
+    {
+        const char *md5;    ///< the md5 hash of the tune
+        unsigned int song;  ///< the subtune
+    };
+
 private:
     libsidplayfp::iniParser* m_parser;
 
+    libsidplayfp::mappedFile* m_binary;
+
     const char *errorString;
 
 public:
@@ -51,6 +73,9 @@ public:
 
     /**
      * Open the songlength DataBase.
+     * Either the Songlengths.md5 text file or a binary
+     * index created with #convert(), which is memory mapped
+     * and opens in constant time.
      *
      * @param filename songlengthDB file name with full path.
      * @return false in case of errors, true otherwise.
@@ -65,6 +90,16 @@ public:
      */
     void close();
 
+    /**
+     * Convert a Songlengths.md5 text file into a binary index.
+     *
+     * @param input the songlengthDB text file name
+     * @param output the binary index file name
+     * @return false in case of errors, true otherwise.
+     * @since 3.1
+     */
+    static bool convert(const char *input, const char *output);
+
     /**
      * Get the length of the current subtune.
      * The hash is obtained with a specific MD5 calculation (old format).
@@ -101,6 +136,40 @@ public:
      */
     int_least32_t lengthMs(const char *md5, unsigned int song);
 
+    /**
+     * Get the length of the selected subtune.
+     * Doesn't modify the object so it can be called concurrently
+     * from several threads, as long as the database
+     * is not opened or closed meanwhile.
+     *
+     * @param md5 the md5 hash of the tune.
+     * @param song the subtune.
+     * @param length set to the length in milliseconds on success.
+     * @return the lookup status.
+     * @since 3.1
+     */
+    status_t lookup(const char *md5, unsigned int song, int_least32_t &length) const;
+
+    /**
+     * Get the lengths of several subtunes at once.
+     * Thread safe like #lookup(const char*, unsigned int, int_least32_t&) const.
+     *
+     * @param queries the md5 and subtune pairs.
+     * @param count the number of queries.
+     * @param lengths filled with the lengths in milliseconds, -1 for failed lookups.
+     * @param status if not null filled with the status of each lookup.
+     * @return the number of lengths found.
+     * @since 3.1
+     */
+    unsigned int lookup(const query_t *queries, size_t count, int_least32_t *lengths, status_t *status = nullptr) const;
+
+    /**
+     * Get the description of a lookup status.
+     *
+     * @since 3.1
+     */
+    static const char *statusString(status_t status);
+
     /**
      * Get descriptive error message.
      */
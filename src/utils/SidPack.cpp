@@ -0,0 +1,367 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "SidPack.h"
+
+#include "sidplayfp/SidTune.h"
+
+#include "mappedfile.h"
+#include "sidendian.h"
+#include "sidmd5.h"
+
+#include "sidcxx11.h"
+
+const char ERR_NO_PACK_LOADED[]      = "SID PACK ERROR: No pack loaded.";
+const char ERR_UNABLE_TO_LOAD_PACK[] = "SID PACK ERROR: Unable to load the pack.";
+const char ERR_PACK_CORRUPT[]        = "SID PACK ERROR: Pack seems to be corrupt.";
+const char ERR_NO_ERROR[]            = "No errors";
+
+// Pack file, all values are little endian:
+//
+// header:  "SPAK", version, number of entries, size of the path table (32 bit each)
+// entries: sorted by path, offset of the path in the path table,
+//          offset of the file, size of the file, unused (32 bit each),
+//          binary md5 of the file (16 bytes)
+// paths:   null terminated, with a leading slash
+// files:   placed so that they span the fewest pages
+const char PACK_MAGIC[] = "SPAK";
+constexpr uint_least32_t PACK_VERSION = 1;
+constexpr size_t HEADER_SIZE = 16;
+constexpr size_t ENTRY_SIZE = 32;
+constexpr size_t MD5_SIZE = 16;
+constexpr uint_least64_t PACK_PAGE_SIZE = 4096;
+
+/// The pack used by SidPack::load on this thread
+static thread_local const SidPack *loadingPack = nullptr;
+
+/**
+ * Skip the leading slashes, the stored paths have one.
+ */
+static const char *skipSlashes(const char *path)
+{
+    while (*path == '/')
+        path++;
+    return path;
+}
+
+/**
+ * Make a relative path with forward slashes and a leading slash.
+ */
+static std::string packPath(const char *path)
+{
+    std::string result(path);
+    std::replace(result.begin(), result.end(), '\\', '/');
+
+    size_t start = 0;
+    for (;;)
+    {
+        if (result.compare(start, 2, "./") == 0)
+            start += 2;
+        else if (result.compare(start, 1, "/") == 0)
+            start++;
+        else
+            break;
+    }
+
+    return "/" + result.substr(start);
+}
+
+/**
+ * Offset that makes a file span the fewest pages.
+ */
+static uint_least64_t placeFile(uint_least64_t pos, uint_least64_t size)
+{
+    const uint_least64_t pages = ((pos % PACK_PAGE_SIZE) + size + PACK_PAGE_SIZE - 1) / PACK_PAGE_SIZE;
+    const uint_least64_t alignedPages = (size + PACK_PAGE_SIZE - 1) / PACK_PAGE_SIZE;
+    return (alignedPages < pages) ? (pos + PACK_PAGE_SIZE - 1) / PACK_PAGE_SIZE * PACK_PAGE_SIZE : pos;
+}
+
+/**
+ * PSID and RSID files need no companion file.
+ */
+static bool isPSID(const SidPack::entry_t &file)
+{
+    return (file.size >= 4)
+        && ((std::memcmp(file.data, "PSID", 4) == 0) || (std::memcmp(file.data, "RSID", 4) == 0));
+}
+
+SidPack::SidPack() :
+    m_entries(0),
+    errorString(ERR_NO_PACK_LOADED)
+{}
+
+SidPack::~SidPack() = default;
+
+bool SidPack::open(const char *filename)
+{
+    close();
+
+    m_file = std::make_shared<libsidplayfp::mappedFile>();
+    if (!m_file->open(filename))
+    {
+        close();
+        errorString = ERR_UNABLE_TO_LOAD_PACK;
+        return false;
+    }
+
+    const uint8_t *data = m_file->data();
+    const uint_least64_t size = m_file->size();
+    if ((size < HEADER_SIZE)
+        || (std::memcmp(data, PACK_MAGIC, 4) != 0)
+        || (endian_little32(data + 4) != PACK_VERSION))
+    {
+        close();
+        errorString = ERR_UNABLE_TO_LOAD_PACK;
+        return false;
+    }
+
+    // The path table must end with a null terminator
+    // so that any offset into it yields a valid string.
+    const uint_least64_t entries = endian_little32(data + 8);
+    const uint_least64_t pathsSize = endian_little32(data + 12);
+    const uint_least64_t indexEnd = HEADER_SIZE + entries * ENTRY_SIZE + pathsSize;
+    if ((indexEnd > size)
+        || ((pathsSize == 0) ? (entries != 0) : (data[indexEnd - 1] != '\0')))
+    {
+        close();
+        errorString = ERR_PACK_CORRUPT;
+        return false;
+    }
+
+    m_entries = entries;
+    errorString = ERR_NO_ERROR;
+    return true;
+}
+
+void SidPack::close()
+{
+    m_file.reset();
+    m_entries = 0;
+    errorString = ERR_NO_PACK_LOADED;
+}
+
+const uint8_t *SidPack::entryData(size_t index) const
+{
+    return m_file->data() + HEADER_SIZE + index * ENTRY_SIZE;
+}
+
+bool SidPack::getEntry(const uint8_t *entry, entry_t &result) const
+{
+    const uint8_t *data = m_file->data();
+    const uint_least64_t pathsSize = endian_little32(data + 12);
+    const uint_least32_t pathOffset = endian_little32(entry);
+    const uint_least32_t offset = endian_little32(entry + 4);
+    const uint_least32_t size = endian_little32(entry + 8);
+
+    if ((pathOffset >= pathsSize)
+        || (static_cast<uint_least64_t>(offset) + size > m_file->size()))
+    {
+        return false;
+    }
+
+    result.path = reinterpret_cast<const char*>(data + HEADER_SIZE + m_entries * ENTRY_SIZE + pathOffset);
+    result.data = data + offset;
+    result.size = size;
+
+    std::array<uint8_t, MD5_SIZE> digest;
+    std::memcpy(digest.data(), entry + 16, MD5_SIZE);
+    libsidplayfp::sidmd5::toHex(digest, result.md5);
+    return true;
+}
+
+bool SidPack::entry(size_t index, entry_t &entry) const
+{
+    if (index >= m_entries)
+        return false;
+
+    return getEntry(entryData(index), entry);
+}
+
+bool SidPack::find(const char *path, entry_t &entry) const
+{
+    if (m_file == nullptr)
+        return false;
+
+    const char *key = skipSlashes(path);
+    const uint8_t *data = m_file->data();
+    const char *paths = reinterpret_cast<const char*>(data + HEADER_SIZE + m_entries * ENTRY_SIZE);
+    const uint_least32_t pathsSize = endian_little32(data + 12);
+
+    // Binary search on the sorted index
+    size_t first = 0;
+    size_t last = m_entries;
+    while (first < last)
+    {
+        const size_t middle = first + (last - first) / 2;
+        const uint_least32_t pathOffset = endian_little32(entryData(middle));
+        if (pathOffset >= pathsSize)
+            return false;
+
+        const int cmp = std::strcmp(skipSlashes(paths + pathOffset), key);
+        if (cmp == 0)
+            return getEntry(entryData(middle), entry);
+
+        if (cmp < 0)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    return false;
+}
+
+void SidPack::read(const char *path, std::vector<uint8_t> &buffer) const
+{
+    entry_t file;
+    if (find(path, file))
+        buffer.assign(file.data, file.data + file.size);
+    else
+        buffer.clear();
+}
+
+void SidPack::loader(const char* fileName, std::vector<uint8_t>& bufferRef)
+{
+    if (loadingPack != nullptr)
+        loadingPack->read(fileName, bufferRef);
+    else
+        bufferRef.clear();
+}
+
+bool SidPack::load(const char *path, SidTune &tune) const
+{
+    entry_t file;
+    if (find(path, file) && isPSID(file))
+    {
+        // Single file, the tune refers to the mapping
+        tune.read(std::shared_ptr<const uint_least8_t>(m_file, file.data), file.size);
+        return tune.getStatus();
+    }
+
+    // The loader callback has no context, it reads
+    // from the pack bound to the calling thread.
+    loadingPack = this;
+    tune.load(loader, path, true);
+    loadingPack = nullptr;
+
+    return tune.getStatus();
+}
+
+bool SidPack::create(const char *baseDir, const char *const *paths, size_t count, const char *output)
+{
+    struct file_t
+    {
+        std::string path;
+        const char *fileName;
+        uint_least32_t pathOffset;
+        uint_least32_t offset;
+        uint_least32_t size;
+        std::array<uint8_t, MD5_SIZE> md5;
+    };
+
+    std::vector<file_t> entries(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        entries[i].path = packPath(paths[i]);
+        entries[i].fileName = paths[i];
+    }
+
+    // the first occurrence wins
+    std::stable_sort(entries.begin(), entries.end(), [](const file_t &a, const file_t &b)
+        { return std::strcmp(a.path.c_str() + 1, b.path.c_str() + 1) < 0; });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const file_t &a, const file_t &b)
+        { return a.path == b.path; }), entries.end());
+
+    // The index size is known before reading the files
+    uint_least64_t pathsSize = 0;
+    for (file_t &entry: entries)
+    {
+        entry.pathOffset = pathsSize;
+        pathsSize += entry.path.size() + 1;
+    }
+
+    const uint_least64_t indexEnd = HEADER_SIZE + entries.size() * ENTRY_SIZE + pathsSize;
+    if (indexEnd > 0xffffffff)
+        return false;
+
+    std::ofstream out(output, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (out.fail())
+        return false;
+
+    const std::string base(baseDir);
+    uint_least64_t pos = indexEnd;
+    std::vector<char> padding;
+    for (file_t &entry: entries)
+    {
+        libsidplayfp::mappedFile file;
+        if (!file.open((base + '/' + entry.fileName).c_str()))
+            return false;
+
+        const uint_least64_t offset = placeFile(pos, file.size());
+        if (offset + file.size() > 0xffffffff)
+            return false;
+
+        padding.assign(offset - pos, 0);
+        out.seekp(pos);
+        out.write(padding.data(), padding.size());
+        out.write(reinterpret_cast<const char*>(file.data()), file.size());
+
+        const hashlib::md5_message message = { file.data(), file.size(), nullptr, 0 };
+        libsidplayfp::sidmd5::digest(&message, 1, &entry.md5);
+
+        entry.offset = offset;
+        entry.size = file.size();
+        pos = offset + file.size();
+    }
+
+    std::vector<uint8_t> index(indexEnd, 0);
+
+    std::memcpy(index.data(), PACK_MAGIC, 4);
+    endian_little32(index.data() + 4, PACK_VERSION);
+    endian_little32(index.data() + 8, entries.size());
+    endian_little32(index.data() + 12, pathsSize);
+
+    uint8_t *ptr = index.data() + HEADER_SIZE;
+    for (const file_t &entry: entries)
+    {
+        endian_little32(ptr, entry.pathOffset);
+        endian_little32(ptr + 4, entry.offset);
+        endian_little32(ptr + 8, entry.size);
+        std::memcpy(ptr + 16, entry.md5.data(), MD5_SIZE);
+        ptr += ENTRY_SIZE;
+    }
+
+    for (const file_t &entry: entries)
+    {
+        std::memcpy(ptr, entry.path.c_str(), entry.path.size() + 1);
+        ptr += entry.path.size() + 1;
+    }
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(index.data()), index.size());
+    out.close();
+    return !out.fail();
+}
@@ -0,0 +1,162 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIDPACK_H
+#define SIDPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "sidplayfp/siddefs.h"
+
+class SidTune;
+
+namespace libsidplayfp
+{
+class mappedFile;
+}
+
+/**
+ * SidPack
+ * An utility class to access a tune collection packed into a single file.
+ *
+ * The pack holds an index sorted by path followed by the files,
+ * it is memory mapped so a lookup costs no system calls and
+ * a small tune is read with a single page fault.
+ *
+ * @since 3.1
+ */
+class SID_EXTERN SidPack
+{
+public:
+    /// A packed file
+    struct entry_t
+    {
+        const char *path;               ///< the path in the pack, e.g. "/MUSICIANS/H/Hubbard_Rob/Commando.sid"
+        const uint_least8_t *data;      ///< the file data, valid while the pack is open
+        uint_least32_t size;            ///< the file size
+        char md5[33];                   ///< the md5 of the whole file, the same as SidTune::createMD5New for PSID files
+    };
+
+private:
+    std::shared_ptr<libsidplayfp::mappedFile> m_file;
+
+    uint_least32_t m_entries;
+
+    const char *errorString;
+
+private:
+    const uint8_t *entryData(size_t index) const;
+
+    bool getEntry(const uint8_t *entry, entry_t &result) const;
+
+    static void loader(const char* fileName, std::vector<uint8_t>& bufferRef);
+
+public:
+    SidPack();
+    ~SidPack();
+
+    /**
+     * Open a pack created with #create().
+     *
+     * @param filename the pack file name
+     * @return false in case of errors, true otherwise.
+     */
+    bool open(const char *filename);
+
+    /**
+     * Close the pack.
+     */
+    void close();
+
+    /**
+     * Pack the files of a collection.
+     * The paths are stored relative to the base directory,
+     * with forward slashes and a leading slash.
+     *
+     * @param baseDir the collection root
+     * @param paths the file paths, relative to baseDir
+     * @param count the number of paths
+     * @param output the pack file name
+     * @return false in case of errors, true otherwise.
+     */
+    static bool create(const char *baseDir, const char *const *paths, size_t count, const char *output);
+
+    /**
+     * Get the number of packed files.
+     */
+    size_t count() const { return m_entries; }
+
+    /**
+     * Get a packed file by its position in the index,
+     * the files are sorted by path.
+     *
+     * @param index the position, less than #count()
+     * @param entry filled with the file details
+     * @return false if out of range or corrupt
+     */
+    bool entry(size_t index, entry_t &entry) const;
+
+    /**
+     * Find a packed file.
+     * Doesn't modify the object so it can be called concurrently
+     * from several threads, as long as the pack
+     * is not opened or closed meanwhile.
+     *
+     * @param path the path in the pack, the leading slash is optional
+     * @param entry filled with the file details
+     * @return false if not found
+     */
+    bool find(const char *path, entry_t &entry) const;
+
+    /**
+     * Read a packed file into a buffer,
+     * e.g. from a SidTune::LoaderFunc.
+     * Thread safe like #find.
+     *
+     * @param path the path in the pack
+     * @param buffer filled with the file data, left empty if not found
+     */
+    void read(const char *path, std::vector<uint8_t> &buffer) const;
+
+    /**
+     * Load a tune from the pack.
+     * PSID files are referenced in the pack without copying,
+     * like SidTune::read, the tune keeps the pack mapped
+     * until it is unloaded.
+     * Companion files, like the STR part of MUS tunes,
+     * are also read from the pack.
+     * Thread safe like #find, each thread loading its own tune.
+     *
+     * @param path the path in the pack
+     * @param tune the tune to load
+     * @return false in case of errors, see SidTune::statusString.
+     */
+    bool load(const char *path, SidTune &tune) const;
+
+    /**
+     * Get descriptive error message.
+     */
+    const char *error() const { return errorString; }
+};
+
+#endif // SIDPACK_H
@@ -135,4 +135,14 @@ const char *iniParser::getValue(const char *key)
     return (keyIt != (*curSection).second.end()) ? keyIt->second.c_str() : nullptr;
 }
 
+const char *iniParser::getValue(const char *section, const char *key) const
+{
+    sections_t::const_iterator sectionIt = sections.find(std::string(section));
+    if (sectionIt == sections.end())
+        return nullptr;
+
+    keys_t::const_iterator keyIt = (*sectionIt).second.find(std::string(key));
+    return (keyIt != (*sectionIt).second.end()) ? keyIt->second.c_str() : nullptr;
+}
+
 }
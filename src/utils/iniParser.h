@@ -54,6 +54,12 @@ public:
 
     bool setSection(const char *section);
     const char *getValue(const char *key);
+
+    /**
+     * Get a value without changing the current section,
+     * safe to call concurrently.
+     */
+    const char *getValue(const char *section, const char *key) const;
 };
 
 }
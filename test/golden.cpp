@@ -0,0 +1,371 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Golden output regression harness.
+ *
+ * Renders each tune with a fixed configuration and compares
+ * the MD5 of the produced PCM with the one stored in a manifest.
+ * Also reports the realtime factor (emulated seconds per wall second).
+ *
+ * Create or update the manifest:
+ *     golden [options] -u manifest tune[:song]...
+ * Check against the manifest:
+ *     golden [options] manifest
+ *
+ * Options:
+ *     -s seconds   rendered length when updating (default 10)
+ *     -e engine    sidlite or residfp (default sidlite)
+ *     -k file      Kernal ROM
+ *     -b file      BASIC ROM
+ *     -c file      character generator ROM
+ *
+ * Manifest format, one entry per line after the header:
+ *     seconds <n>
+ *     engine <name>
+ *     <md5> <song> <path>
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sidplayfp/sidplayfp.h"
+#include "sidplayfp/SidConfig.h"
+#include "sidplayfp/SidTune.h"
+#include "sidplayfp/sidbuilder.h"
+#include "builders/sidlite-builder/sidlite.h"
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#ifdef HAVE_RESIDFP
+#  include "builders/residfp-builder/residfp.h"
+#endif
+
+#include "sidmd5.h"
+
+/// Fixed rendering parameters, changing any of these invalidates the manifests
+//@{
+constexpr unsigned int SAMPLERATE = 44100;
+constexpr uint_least16_t POWER_ON_DELAY = 0x1267;
+constexpr unsigned int SEED = 0x5eed;
+constexpr double CLOCK_FREQ = 985248.;
+//@}
+
+/// Cycles emulated per play call
+constexpr unsigned int CYCLES = 10000;
+
+struct Entry
+{
+    std::string md5;
+    unsigned int song;
+    std::string path;
+};
+
+static bool loadRom(const char *path, std::vector<uint8_t> &rom, size_t size)
+{
+    std::ifstream is(path, std::ios::binary);
+    if (!is.is_open())
+    {
+        std::cerr << "File " << path << " not found" << std::endl;
+        return false;
+    }
+    rom.resize(size);
+    is.read((char*)rom.data(), size);
+    return true;
+}
+
+/*
+ * Render a tune and compute the MD5 of the PCM data.
+ *
+ * @return false on error
+ */
+static bool render(sidplayfp &engine, const Entry &entry, unsigned int seconds,
+                    std::string &md5, double &realtime)
+{
+    SidTune tune(entry.path.c_str());
+    if (!tune.getStatus())
+    {
+        md5 = tune.statusString();
+        return false;
+    }
+
+    tune.selectSong(entry.song);
+
+    // Reseed for every tune so the order doesn't matter
+    engine.setRandomSeed(SEED);
+
+    if (!engine.load(&tune))
+    {
+        md5 = engine.error();
+        return false;
+    }
+
+    engine.initMixer(false);
+
+    std::vector<short> buffer(engine.getBufSize(CYCLES));
+    std::vector<uint8_t> bytes(buffer.size() * sizeof(short));
+
+    libsidplayfp::sidmd5 digest;
+
+    const uint_least64_t total = static_cast<uint_least64_t>(seconds * CLOCK_FREQ);
+    uint_least64_t cycles = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    while (cycles < total)
+    {
+        const int samples = engine.play(CYCLES);
+        if (samples < 0)
+        {
+            md5 = engine.error();
+            engine.load(nullptr);
+            return false;
+        }
+
+        const unsigned int n = engine.mix(buffer.data(), samples);
+
+        // Hash as little endian
+        for (unsigned int i = 0; i < n; i++)
+        {
+            bytes[i * 2] = buffer[i] & 0xff;
+            bytes[i * 2 + 1] = (buffer[i] >> 8) & 0xff;
+        }
+        digest.append(bytes.data(), n * 2);
+
+        cycles += CYCLES;
+    }
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    realtime = elapsed > 0. ? (cycles / CLOCK_FREQ) / elapsed : 0.;
+
+    engine.load(nullptr);
+
+    md5 = digest.getDigest();
+    return true;
+}
+
+static void usage(const char *name)
+{
+    std::cerr << "Usage: " << name << " [-s seconds] [-e engine] [-k kernal] [-b basic] [-c chargen] manifest" << std::endl;
+    std::cerr << "       " << name << " [-s seconds] [-e engine] [-k kernal] [-b basic] [-c chargen] -u manifest tune[:song]..." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int seconds = 10;
+    std::string engineName("sidlite");
+    bool update = false;
+    std::vector<uint8_t> kernal, basic, chargen;
+    std::vector<std::string> args;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "-u"))
+            update = true;
+        else if (!strcmp(argv[i], "-s") && hasValue)
+            seconds = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-e") && hasValue)
+            engineName = argv[++i];
+        else if (!strcmp(argv[i], "-k") && hasValue)
+        {
+            if (!loadRom(argv[++i], kernal, 8192))
+                return EXIT_FAILURE;
+        }
+        else if (!strcmp(argv[i], "-b") && hasValue)
+        {
+            if (!loadRom(argv[++i], basic, 8192))
+                return EXIT_FAILURE;
+        }
+        else if (!strcmp(argv[i], "-c") && hasValue)
+        {
+            if (!loadRom(argv[++i], chargen, 4096))
+                return EXIT_FAILURE;
+        }
+        else if (argv[i][0] == '-')
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        else
+            args.push_back(argv[i]);
+    }
+
+    if (args.empty() || (update && args.size() < 2))
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const std::string manifestPath = args[0];
+    std::vector<Entry> entries;
+
+    if (update)
+    {
+        for (size_t i = 1; i < args.size(); i++)
+        {
+            Entry entry;
+            entry.song = 0;
+            entry.path = args[i];
+            const size_t colon = entry.path.find_last_of(':');
+            if (colon != std::string::npos && colon + 1 < entry.path.size()
+                && entry.path.find_first_not_of("0123456789", colon + 1) == std::string::npos)
+            {
+                entry.song = atoi(entry.path.c_str() + colon + 1);
+                entry.path.resize(colon);
+            }
+            entries.push_back(entry);
+        }
+    }
+    else
+    {
+        std::ifstream manifest(manifestPath);
+        if (!manifest.is_open())
+        {
+            std::cerr << "File " << manifestPath << " not found" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::string line;
+        while (std::getline(manifest, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            std::istringstream is(line);
+            std::string key;
+            is >> key;
+            if (key == "seconds")
+                is >> seconds;
+            else if (key == "engine")
+                is >> engineName;
+            else
+            {
+                Entry entry;
+                entry.md5 = key;
+                is >> entry.song >> std::ws;
+                std::getline(is, entry.path);
+                entries.push_back(entry);
+            }
+        }
+    }
+
+    std::unique_ptr<sidbuilder> builder;
+    if (engineName == "sidlite")
+        builder.reset(new SIDLiteBuilder("golden"));
+#ifdef HAVE_RESIDFP
+    else if (engineName == "residfp")
+        builder.reset(new ReSIDfpBuilder("golden"));
+#endif
+    else
+    {
+        std::cerr << "Unsupported engine " << engineName << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    sidplayfp engine;
+    engine.setRoms(kernal.empty() ? nullptr : kernal.data(),
+                   basic.empty() ? nullptr : basic.data(),
+                   chargen.empty() ? nullptr : chargen.data());
+
+    SidConfig config = engine.config();
+    config.defaultC64Model = SidConfig::PAL;
+    config.forceC64Model = true;
+    config.defaultSidModel = SidConfig::MOS6581;
+    config.forceSidModel = true;
+    config.digiBoost = false;
+    config.ciaModel = SidConfig::MOS6526;
+    config.frequency = SAMPLERATE;
+    config.samplingMethod = SidConfig::INTERPOLATE;
+    config.powerOnDelay = POWER_ON_DELAY;
+    config.sidEmulation = builder.get();
+
+    if (!engine.config(config))
+    {
+        std::cerr << "Error: " << engine.error() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    unsigned int failed = 0;
+    unsigned int rendered = 0;
+    double totalRealtime = 0.;
+
+    for (Entry &entry : entries)
+    {
+        std::string md5;
+        double realtime = 0.;
+        const bool ok = render(engine, entry, seconds, md5, realtime);
+
+        std::cout << (ok && (update || md5 == entry.md5) ? "PASS " : "FAIL ")
+                  << entry.path << ":" << entry.song;
+
+        if (!ok)
+        {
+            std::cout << " (" << md5 << ")" << std::endl;
+            failed++;
+            continue;
+        }
+
+        std::cout << " " << realtime << "x";
+        if (!update && md5 != entry.md5)
+        {
+            std::cout << " (expected " << entry.md5 << " got " << md5 << ")";
+            failed++;
+        }
+        std::cout << std::endl;
+
+        entry.md5 = md5;
+        totalRealtime += realtime;
+        rendered++;
+    }
+
+    const size_t total = entries.size();
+    std::cout << "Passed " << (total - failed) << "/" << total << std::endl;
+    if (rendered > 0)
+        std::cout << "Average realtime factor " << (totalRealtime / rendered) << "x" << std::endl;
+
+    if (update)
+    {
+        if (failed != 0)
+        {
+            std::cerr << "Manifest not written" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::ofstream manifest(manifestPath);
+        manifest << "# libsidplayfp golden output manifest" << std::endl;
+        manifest << "seconds " << seconds << std::endl;
+        manifest << "engine " << engineName << std::endl;
+        for (const Entry &entry : entries)
+            manifest << entry.md5 << " " << entry.song << " " << entry.path << std::endl;
+    }
+
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -195,7 +195,17 @@ int main(int argc, char* argv[])
 
     for (;;)
     {
-        m_engine.play(5000);
+        if (m_engine.play(5000) < 0)
+            break;
         std::cerr << ".";
     }
+
+    if (!strcmp(m_engine.error(), "OK"))
+    {
+        std::cout << std::endl << "\x1b[0;32m" << "OK" << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    std::cout << std::endl << "\x1b[0;31m" << m_engine.error() << std::endl;
+    return EXIT_FAILURE;
 }
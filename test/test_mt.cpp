@@ -183,7 +183,7 @@ void writeWavHeader()
     endian_little32(wavHdr.dataChunkLen, 0);
 }
 
-void run(int i, const char* tuneName)
+void run(int i, std::shared_ptr<const SidTune> tune)
 {
     constexpr int bufferSize = 4096;
 
@@ -197,19 +197,6 @@ void run(int i, const char* tuneName)
 
     uint_least32_t bufferSamples = static_cast<uint_least32_t>(bufferSize) / sizeof(short);
 
-    // Load tune from file
-    std::unique_ptr<SidTune> tune(new SidTune(tuneName));
-
-    // CHeck if the tune is valid
-    if (!tune->getStatus())
-    {
-        std::cerr << tune->statusString() << std::endl;
-        exit(EXIT_FAILURE);
-    }
-
-    // Select default song
-    tune->selectSong(0);
-
     sidplayfp m_engine;
 
     // Configure the engine
@@ -225,8 +212,8 @@ void run(int i, const char* tuneName)
         exit(EXIT_FAILURE);
     }
 
-    // Load tune into engine
-    if (!m_engine.load(tune.get()))
+    // Load the default song of the shared tune into engine
+    if (!m_engine.load(tune, 0))
     {
         std::cerr <<  m_engine.error() << std::endl;
         exit(EXIT_FAILURE);
@@ -275,9 +262,19 @@ int main(int argc, char* argv[])
     delete [] chargen;
     }
 */
+    // Load tune from file, once for all the threads
+    std::shared_ptr<const SidTune> tune = std::make_shared<SidTune>(argv[1]);
+
+    // CHeck if the tune is valid
+    if (!tune->getStatus())
+    {
+        std::cerr << tune->statusString() << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
     #pragma omp parallel for
     for (int j = 0; j < 10; j++)
     {
-        run(j, argv[1]);
+        run(j, tune);
     }
 }
@@ -0,0 +1,370 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Parallel runner for the VICE testsuite.
+ *
+ * Runs all the tests listed in testlist on a pool of threads,
+ * each one reusing its own player instance.
+ *
+ * Usage: testsuite [-j threads] [-t seconds] [testlist]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+#include "sidplayfp/sidplayfp.h"
+#include "sidplayfp/SidTune.h"
+#include "sidplayfp/sidbuilder.h"
+#include "builders/residfp-builder/residfp.h"
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "sidcxx11.h"
+
+/*
+ * Adjust these paths to point to existing ROM dumps
+ */
+#define KERNAL_PATH "/usr/share/vice/C64/kernal-901227-03.bin"
+#define BASIC_PATH "/usr/share/vice/C64/basic-901226-01.bin"
+#define CHARGEN_PATH "/usr/share/vice/C64/chargen-901225-01.bin"
+
+/// Cycles emulated per play call
+constexpr unsigned int CYCLES = 5000;
+
+/// PAL clock, used to convert the timeout to cycles
+constexpr unsigned int CLOCK = 985248;
+
+struct Test
+{
+    std::string line;
+    std::string name;
+
+    bool passed;
+    std::string result;
+    uint_least64_t cycles;
+    double seconds;
+};
+
+/*
+ * Resources owned by each worker.
+ */
+struct Worker
+{
+    // the builder must outlive the engine
+    std::unique_ptr<ReSIDfpBuilder> rs;
+    sidplayfp engine;
+};
+
+bool loadRom(const char* path, uint8_t* buffer)
+{
+    std::ifstream is(path, std::ios::binary);
+    if (!is.is_open())
+    {
+        std::cerr << "File " << path << " not found" << std::endl;
+        return false;
+    }
+    is.read((char*)buffer, 8192);
+    return true;
+}
+
+/*
+ * Parse the test options, same as the standalone test program.
+ */
+bool parseOptions(Worker &worker, const std::string &line, SidConfig &config, std::string &name, std::string &error)
+{
+    std::istringstream is(line);
+    std::string arg;
+    while (is >> arg)
+    {
+        if (arg.size() > 1 && arg[0] == '-')
+        {
+            std::string value;
+            is >> value;
+
+            if (arg == "--sid")
+            {
+                if (value == "old")
+                    config.defaultSidModel = SidConfig::MOS6581;
+                else if (value == "new")
+                    config.defaultSidModel = SidConfig::MOS8580;
+                else
+                {
+                    error = "unrecognized SID model";
+                    return false;
+                }
+                config.sidEmulation = worker.rs.get();
+                config.forceSidModel = true;
+            }
+            else if (arg == "--cia")
+            {
+                if (value == "old")
+                    config.ciaModel = SidConfig::MOS6526;
+                else if (value == "new")
+                    config.ciaModel = SidConfig::MOS8521;
+                else if (value == "4485")
+                    config.ciaModel = SidConfig::MOS6526W4485;
+                else
+                {
+                    error = "unrecognized CIA model";
+                    return false;
+                }
+            }
+            else if (arg == "--vic")
+            {
+                if (value == "pal")
+                    config.defaultC64Model = SidConfig::PAL;
+                else if (value == "ntsc")
+                    config.defaultC64Model = SidConfig::NTSC;
+                else if (value == "oldntsc")
+                    config.defaultC64Model = SidConfig::OLD_NTSC;
+                else if (value == "drean")
+                    config.defaultC64Model = SidConfig::DREAN;
+                else
+                {
+                    error = "unrecognized VIC II model";
+                    return false;
+                }
+                config.forceC64Model = true;
+            }
+            else
+            {
+                error = "unrecognized option " + arg;
+                return false;
+            }
+        }
+        else
+        {
+            name.append(arg).append(".prg");
+        }
+    }
+
+    return true;
+}
+
+void runTest(Worker &worker, const SidConfig &defaultConfig, Test &test, uint_least64_t maxCycles)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    test.passed = false;
+    test.cycles = 0;
+
+    SidConfig config = defaultConfig;
+    std::string name(VICE_TESTSUITE);
+
+    if (!parseOptions(worker, test.line, config, name, test.result))
+        return;
+
+    if (!worker.engine.config(config))
+    {
+        test.result = worker.engine.error();
+        return;
+    }
+
+    SidTune tune(name.c_str());
+    if (!tune.getStatus())
+    {
+        test.result = tune.statusString();
+        return;
+    }
+
+    tune.selectSong(0);
+
+    if (!worker.engine.load(&tune))
+    {
+        test.result = worker.engine.error();
+        return;
+    }
+
+    test.result = "TIMEOUT";
+    while (test.cycles < maxCycles)
+    {
+        const int res = worker.engine.play(CYCLES);
+        test.cycles += CYCLES;
+        if (res < 0)
+        {
+            test.result = worker.engine.error();
+            test.passed = test.result == "OK";
+            break;
+        }
+    }
+
+    // Unload the tune before it goes out of scope
+    worker.engine.load(nullptr);
+
+    test.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int threads = std::thread::hardware_concurrency();
+    unsigned int timeout = 120;
+
+    std::string dir(argv[0]);
+    const size_t sep = dir.find_last_of('/');
+    dir = sep == std::string::npos ? "." : dir.substr(0, sep);
+    std::string listPath = dir + "/testlist";
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-j") && (i + 1 < argc))
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-t") && (i + 1 < argc))
+        {
+            timeout = atoi(argv[++i]);
+        }
+        else if (argv[i][0] != '-')
+        {
+            listPath = argv[i];
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-j threads] [-t seconds] [testlist]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (threads == 0)
+        threads = 1;
+
+    // Load the ROMs once and share them between workers
+    uint8_t kernal[8192];
+    uint8_t basic[8192];
+    uint8_t chargen[8192];
+    if (!loadRom(KERNAL_PATH, kernal) || !loadRom(BASIC_PATH, basic) || !loadRom(CHARGEN_PATH, chargen))
+        return EXIT_FAILURE;
+
+    std::ifstream list(listPath);
+    if (!list.is_open())
+    {
+        std::cerr << "File " << listPath << " not found" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Test> tests;
+    std::string line;
+    while (std::getline(list, line))
+    {
+        const size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+
+        Test test;
+        test.line = line.substr(first);
+        test.name = test.line.substr(0, test.line.find_first_of(" \t"));
+        test.passed = false;
+        test.cycles = 0;
+        test.seconds = 0.;
+        tests.push_back(test);
+    }
+
+    if (tests.empty())
+    {
+        std::cerr << "No tests found in " << listPath << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (threads > tests.size())
+        threads = tests.size();
+
+    const uint_least64_t maxCycles = static_cast<uint_least64_t>(timeout) * CLOCK;
+
+    std::atomic<size_t> next(0);
+
+    auto work = [&]()
+    {
+        Worker worker;
+        worker.engine.setRoms(kernal, basic, chargen);
+
+        worker.rs.reset(new ReSIDfpBuilder("testsuite"));
+
+        SidConfig config = worker.engine.config();
+        config.powerOnDelay = 0x1267;
+
+        for (size_t i = next++; i < tests.size(); i = next++)
+        {
+            runTest(worker, config, tests[i], maxCycles);
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> pool;
+    for (unsigned int i = 0; i < threads; i++)
+        pool.emplace_back(work);
+
+    for (std::thread &t : pool)
+        t.join();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream log(dir + "/testsuite.log");
+
+    unsigned int passed = 0;
+    uint_least64_t cycles = 0;
+    for (const Test &test : tests)
+    {
+        const double speed = test.seconds > 0. ? test.cycles / test.seconds : 0.;
+
+        std::cout << (test.passed ? "PASS " : "FAIL ") << test.name
+                  << " " << test.cycles << " cycles "
+                  << std::fixed << std::setprecision(0) << speed << " cycles/s";
+        if (!test.passed)
+            std::cout << " (" << test.result << ")";
+        std::cout << std::endl;
+
+        if (test.passed)
+            passed++;
+        else
+            log << "Failed test " << test.name << " (" << test.result << ")" << std::endl;
+
+        cycles += test.cycles;
+    }
+
+    const size_t total = tests.size();
+    const size_t failed = total - passed;
+    std::cout << "Passed " << passed << "/" << total << " (" << (passed * 100 / total) << "%)" << std::endl;
+    std::cout << "Failed " << failed << "/" << total << std::endl;
+    std::cout << "Emulated " << cycles << " cycles in " << std::setprecision(2) << seconds << " s using "
+              << threads << " threads (" << std::setprecision(0) << (cycles / seconds) << " cycles/s)" << std::endl;
+
+    if (failed == 0)
+    {
+        std::cout << "Success!" << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    std::cout << "Failed tests logged in " << dir << "/testsuite.log" << std::endl;
+    return EXIT_FAILURE;
+}
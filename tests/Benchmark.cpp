@@ -0,0 +1,608 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Performance benchmarks, run with "make bench".
+ *
+ * Results are printed one per line in JSON format:
+ * {"benchmark": "name", "value": 123.4, "unit": "unit"}
+ *
+ * Links the static library to access the internal classes.
+ */
+
+#include "TestTunes.h"
+
+#include "../src/EventScheduler.h"
+#include "../src/c64/CPU/mos6510.h"
+#include "../src/c64/mmu.h"
+#include "../src/c64/Banks/IOBank.h"
+#include "../src/simpleMixer.h"
+#include "../src/sidemu.h"
+#include "../src/sidmd5.h"
+
+#include "../src/sidplayfp/sidplayfp.h"
+#include "../src/sidplayfp/SidConfig.h"
+#include "../src/sidplayfp/SidTune.h"
+#include "../src/builders/sidlite-builder/sidlite.h"
+#ifdef HAVE_RESIDFP
+#  include "../src/builders/residfp-builder/residfp.h"
+#endif
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace libsidplayfp;
+
+/// PAL clock frequency
+constexpr double CLOCK_FREQ = 985248.;
+
+class Timer
+{
+private:
+    const std::chrono::steady_clock::time_point m_start;
+
+public:
+    Timer() : m_start(std::chrono::steady_clock::now()) {}
+
+    double seconds() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    }
+};
+
+static void report(const char *name, double value, const char *unit)
+{
+    std::printf("{\"benchmark\": \"%s\", \"value\": %.6g, \"unit\": \"%s\"}\n", name, value, unit);
+    std::fflush(stdout);
+}
+
+static void reportError(const char *name, const char *error)
+{
+    std::printf("{\"benchmark\": \"%s\", \"error\": \"%s\"}\n", name, error);
+    std::fflush(stdout);
+}
+
+/*
+ * Build a PSID file around the test tune.
+ */
+static std::vector<uint8_t> makePSID(uint8_t secondSid)
+{
+    TestTunes::psid_t header;
+    header.secondSid = secondSid;
+    return TestTunes::makePSID(header);
+}
+
+/*
+ * MUS file with three short voices.
+ */
+static const uint8_t musData[] =
+{
+    0x52, 0x53,             // load address
+    0x04, 0x00,             // length of the data for Voice 1
+    0x04, 0x00,             // length of the data for Voice 2
+    0x04, 0x00,             // length of the data for Voice 3
+    0x00, 0x00, 0x01, 0x4F, // data for Voice 1
+    0x00, 0x00, 0x01, 0x4F, // data for Voice 2
+    0x00, 0x01, 0x01, 0x4F, // data for Voice 3
+    0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x00, // text description
+};
+
+//-----------------------------------------------------------------------------
+
+class BenchEvent final : public Event
+{
+private:
+    EventScheduler &m_scheduler;
+    const unsigned int m_delay;
+
+public:
+    BenchEvent(EventScheduler &scheduler, unsigned int delay) :
+        Event("Bench"),
+        m_scheduler(scheduler),
+        m_delay(delay) {}
+
+    void event() override { m_scheduler.schedule(*this, m_delay); }
+};
+
+static void benchScheduler()
+{
+    EventScheduler scheduler;
+    scheduler.reset();
+
+    // A typical number of concurrently pending events
+    std::vector<std::unique_ptr<BenchEvent>> events;
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        events.emplace_back(new BenchEvent(scheduler, 1 + i * 3));
+        scheduler.schedule(*events.back(), i, EVENT_CLOCK_PHI1);
+    }
+
+    constexpr unsigned int DISPATCH = 20000000;
+    {
+        Timer timer;
+        for (unsigned int i = 0; i < DISPATCH; i++)
+            scheduler.clock();
+        report("scheduler.dispatch", DISPATCH / timer.seconds(), "events/s");
+    }
+
+    BenchEvent extra(scheduler, 0);
+    constexpr unsigned int INSERT = 10000000;
+    {
+        Timer timer;
+        for (unsigned int i = 0; i < INSERT; i++)
+        {
+            scheduler.schedule(extra, i & 31, EVENT_CLOCK_PHI2);
+            scheduler.cancel(extra);
+        }
+        report("scheduler.insert_cancel", INSERT / timer.seconds(), "ops/s");
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+class BenchCpu final : public CPUDataBus
+{
+private:
+    uint8_t mem[0x10000];
+
+public:
+    BenchCpu()
+    {
+        std::memset(mem, 0, sizeof(mem));
+
+        // A mix of loads, stores, arithmetic and branches
+        static const uint8_t code[] =
+        {
+            0xbd, 0x00, 0x20,   // $1000 LDA $2000,X
+            0x18,               // $1003 CLC
+            0x69, 0x01,         // $1004 ADC #$01
+            0x9d, 0x00, 0x21,   // $1006 STA $2100,X
+            0xe8,               // $1009 INX
+            0xd0, 0xf4,         // $100a BNE $1000
+            0x4c, 0x00, 0x10    // $100c JMP $1000
+        };
+        std::memcpy(mem + 0x1000, code, sizeof(code));
+        mem[0xfffc] = 0x00;
+        mem[0xfffd] = 0x10;
+    }
+
+    uint8_t cpuRead(uint_least16_t addr) override { return mem[addr]; }
+
+    void cpuWrite(uint_least16_t addr, uint8_t data) override { mem[addr] = data; }
+};
+
+static void benchCpu()
+{
+    EventScheduler scheduler;
+    BenchCpu bus;
+    MOS6510 cpu(scheduler, bus);
+
+    scheduler.reset();
+    cpu.reset();
+
+    constexpr unsigned int CYCLES = 20000000;
+
+    Timer timer;
+    for (unsigned int i = 0; i < CYCLES; i++)
+        scheduler.clock();
+    const double seconds = timer.seconds();
+
+    report("cpu.cycles", scheduler.getTime(EVENT_CLOCK_PHI1) / seconds, "cycles/s");
+}
+
+//-----------------------------------------------------------------------------
+
+static void benchMmu()
+{
+    EventScheduler scheduler;
+    IOBank ioBank;
+    MMU mmu(scheduler, &ioBank);
+
+    scheduler.reset();
+    mmu.reset();
+
+    constexpr unsigned int ACCESSES = 50000000;
+
+    unsigned int sum = 0;
+    Timer timer;
+    for (unsigned int i = 0; i < ACCESSES; i++)
+    {
+        // stay clear of the processor port and the I/O area
+        const uint_least16_t addr = 0x0200 + ((i * 61) & 0x7fff);
+        mmu.cpuWrite(addr, i);
+        sum += mmu.cpuRead(addr ^ 0x2000);
+    }
+    const double seconds = timer.seconds();
+
+    report("mmu.access", 2 * ACCESSES / seconds, "accesses/s");
+
+    // Keep the compiler from optimizing away the reads
+    if (sum == 1)
+        std::printf("\n");
+}
+
+//-----------------------------------------------------------------------------
+
+static void benchMixer()
+{
+    constexpr unsigned int SAMPLES = 882;
+    constexpr unsigned int ROUNDS = 20000;
+
+    std::vector<short> input[3];
+    short *buffers[3];
+    for (int i = 0; i < 3; i++)
+    {
+        input[i].resize(SAMPLES);
+        for (unsigned int j = 0; j < SAMPLES; j++)
+            input[i][j] = static_cast<short>((j * 37 + i * 1000) & 0x7fff);
+        buffers[i] = input[i].data();
+    }
+
+    std::vector<short> output(SAMPLES * 2);
+
+    static const char *const names[2][3] =
+    {
+        { "mixer.mono.1", "mixer.mono.2", "mixer.mono.3" },
+        { "mixer.stereo.1", "mixer.stereo.2", "mixer.stereo.3" }
+    };
+
+    for (int stereo = 0; stereo < 2; stereo++)
+    {
+        for (int chips = 1; chips <= 3; chips++)
+        {
+            SimpleMixer mixer(stereo != 0, buffers, chips);
+
+            Timer timer;
+            for (unsigned int i = 0; i < ROUNDS; i++)
+                mixer.doMix(output.data(), SAMPLES);
+            report(names[stereo][chips - 1], SAMPLES * ROUNDS / timer.seconds(), "samples/s");
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+/*
+ * Writes to the SID registers at a steady rate
+ * to keep the emulation busy.
+ */
+class SidWriter final : public Event
+{
+private:
+    EventScheduler &m_scheduler;
+    sidemu &m_sid;
+    uint8_t m_value = 0;
+
+public:
+    SidWriter(EventScheduler &scheduler, sidemu &sid) :
+        Event("SID writer"),
+        m_scheduler(scheduler),
+        m_sid(sid) {}
+
+    void start()
+    {
+        static const uint8_t regs[] =
+        {
+            0x00, 0x10, 0x00, 0x08, 0x21, 0x09, 0xf0,
+            0x00, 0x20, 0x00, 0x08, 0x41, 0x09, 0xf0,
+            0x00, 0x08, 0x00, 0x00, 0x81, 0x09, 0xf0,
+            0x00, 0x40, 0xf3, 0x1f
+        };
+        for (uint_least16_t i = 0; i < sizeof(regs); i++)
+            m_sid.poke(i, regs[i]);
+
+        m_scheduler.schedule(*this, 1000, EVENT_CLOCK_PHI2);
+    }
+
+    void event() override
+    {
+        m_value++;
+        m_sid.poke(0x01, m_value);
+        m_sid.poke(0x08, m_value ^ 0x55);
+        m_sid.poke(0x16, m_value);
+        m_scheduler.schedule(*this, 1000);
+    }
+};
+
+template<size_t N>
+static void benchEngine(const char *engine, sidbuilder &builder, const unsigned int (&rates)[N])
+{
+    constexpr unsigned int BLOCK = 10000;
+    constexpr unsigned int BLOCKS = 500;
+
+    for (unsigned int rate : rates)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "sid.%s.%u", engine, rate);
+
+        EventScheduler scheduler;
+        scheduler.reset();
+
+        sidemu *sid = builder.lock(&scheduler, SidConfig::MOS6581, false);
+        if (sid == nullptr)
+        {
+            reportError(name, builder.error());
+            continue;
+        }
+
+        sid->sampling(CLOCK_FREQ, rate, SidConfig::INTERPOLATE);
+
+        SidWriter writer(scheduler, *sid);
+        writer.start();
+
+        const event_clock_t start = scheduler.getTime(EVENT_CLOCK_PHI1);
+
+        Timer timer;
+        for (unsigned int i = 0; i < BLOCKS; i++)
+        {
+            const event_clock_t end = scheduler.getTime(EVENT_CLOCK_PHI1) + BLOCK;
+            while (scheduler.getTime(EVENT_CLOCK_PHI1) < end)
+                scheduler.clock();
+            sid->clock();
+            sid->bufferpos(0);
+        }
+        const double seconds = timer.seconds();
+
+        const double emulated = (scheduler.getTime(EVENT_CLOCK_PHI1) - start) / CLOCK_FREQ;
+        report(name, emulated / seconds, "realtime");
+
+        scheduler.cancel(writer);
+        builder.unlock(sid);
+    }
+}
+
+static void benchEngines()
+{
+    static const unsigned int sidliteRates[] = { 22050, 44100, 48000, 96000, 192000 };
+    SIDLiteBuilder sidlite("bench");
+    benchEngine("sidlite", sidlite, sidliteRates);
+
+#ifdef HAVE_RESIDFP
+    static const unsigned int residfpRates[] = { 22050, 44100, 48000, 96000 };
+    ReSIDfpBuilder residfp("bench");
+    benchEngine("residfp", residfp, residfpRates);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+
+static void benchLoaders()
+{
+    constexpr unsigned int LOADS = 100000;
+
+    const std::vector<uint8_t> psid = makePSID(0);
+
+    {
+        Timer timer;
+        for (unsigned int i = 0; i < LOADS; i++)
+        {
+            SidTune tune(psid.data(), psid.size());
+            if (!tune.getStatus())
+            {
+                reportError("load.psid", tune.statusString());
+                break;
+            }
+        }
+        report("load.psid", LOADS / timer.seconds(), "loads/s");
+    }
+
+    {
+        Timer timer;
+        for (unsigned int i = 0; i < LOADS; i++)
+        {
+            SidTune tune(musData, sizeof(musData));
+            if (!tune.getStatus())
+            {
+                reportError("load.mus", tune.statusString());
+                break;
+            }
+        }
+        report("load.mus", LOADS / timer.seconds(), "loads/s");
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static void benchMd5()
+{
+    std::vector<uint8_t> data(0x10000);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<uint8_t>(i * 7);
+
+    constexpr unsigned int ROUNDS = 500;
+
+    {
+        Timer timer;
+        for (unsigned int i = 0; i < ROUNDS; i++)
+        {
+            sidmd5 md5;
+            md5.append(data.data(), data.size());
+            md5.getDigest();
+        }
+        report("md5.hash", data.size() * ROUNDS / timer.seconds(), "bytes/s");
+    }
+
+    {
+        // independent messages hashed in parallel lanes
+        constexpr unsigned int MESSAGES = 64;
+        const size_t size = data.size() / MESSAGES;
+        std::vector<hashlib::md5_message> messages(MESSAGES);
+        for (unsigned int i = 0; i < MESSAGES; i++)
+            messages[i] = { data.data() + i * size, size, nullptr, 0 };
+        std::vector<std::array<uint8_t, 16>> digests(MESSAGES);
+
+        Timer timer;
+        for (unsigned int i = 0; i < ROUNDS; i++)
+            sidmd5::digest(messages.data(), MESSAGES, digests.data());
+        report("md5.multi", data.size() * ROUNDS / timer.seconds(), "bytes/s");
+    }
+
+    const std::vector<uint8_t> psid = makePSID(0);
+
+    // the fingerprints are cached, so load a fresh tune each time
+    constexpr unsigned int TUNES = 64;
+    constexpr unsigned int BATCHES = 1000;
+
+    {
+        char md5[SidTune::MD5_LENGTH + 1];
+        Timer timer;
+        for (unsigned int i = 0; i < TUNES * BATCHES; i++)
+        {
+            SidTune tune(psid.data(), psid.size());
+            tune.createMD5(md5);
+            tune.createMD5New(md5);
+        }
+        report("md5.tune", TUNES * BATCHES / timer.seconds(), "tunes/s");
+    }
+
+    {
+        Timer timer;
+        for (unsigned int i = 0; i < BATCHES; i++)
+        {
+            std::vector<std::unique_ptr<SidTune>> tunes;
+            std::vector<SidTune*> ptrs;
+            for (unsigned int t = 0; t < TUNES; t++)
+            {
+                tunes.emplace_back(new SidTune(psid.data(), psid.size()));
+                ptrs.push_back(tunes.back().get());
+            }
+            SidTune::createMD5Batch(ptrs.data(), TUNES);
+        }
+        report("md5.batch", TUNES * BATCHES / timer.seconds(), "tunes/s");
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+/*
+ * Render the test tunes through the whole player
+ * and report the realtime factor.
+ */
+static void benchPlayer()
+{
+    struct
+    {
+        const char *name;
+        uint8_t secondSid;
+        bool stereo;
+    } const tunes[] =
+    {
+        { "player.1sid", 0x00, false },
+        { "player.2sid", 0x42, true },
+    };
+
+    constexpr unsigned int SECONDS = 60;
+    constexpr unsigned int CYCLES = 10000;
+
+    for (const auto &t : tunes)
+    {
+        const std::vector<uint8_t> psid = makePSID(t.secondSid);
+        SidTune tune(psid.data(), psid.size());
+        if (!tune.getStatus())
+        {
+            reportError(t.name, tune.statusString());
+            continue;
+        }
+        tune.selectSong(0);
+
+        SIDLiteBuilder builder("bench");
+
+        sidplayfp engine;
+        SidConfig config = engine.config();
+        config.frequency = 48000;
+        config.sidEmulation = &builder;
+        config.powerOnDelay = 0;
+
+        if (!engine.config(config) || !engine.load(&tune))
+        {
+            reportError(t.name, engine.error());
+            continue;
+        }
+
+        engine.initMixer(t.stereo);
+
+        std::vector<short> buffer(CYCLES * 2);
+
+        const uint_least64_t total = static_cast<uint_least64_t>(SECONDS * CLOCK_FREQ);
+        uint_least64_t cycles = 0;
+        bool failed = false;
+
+        Timer timer;
+        while (cycles < total)
+        {
+            const int samples = engine.play(CYCLES);
+            if (samples < 0)
+            {
+                failed = true;
+                break;
+            }
+            engine.mix(buffer.data(), samples);
+            cycles += CYCLES;
+        }
+        const double seconds = timer.seconds();
+
+        if (failed)
+            reportError(t.name, engine.error());
+        else
+            report(t.name, (cycles / CLOCK_FREQ) / seconds, "realtime");
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    static const struct
+    {
+        const char *name;
+        void (*run)();
+    } benchmarks[] =
+    {
+        { "scheduler", benchScheduler },
+        { "cpu",       benchCpu },
+        { "mmu",       benchMmu },
+        { "mixer",     benchMixer },
+        { "sid",       benchEngines },
+        { "load",      benchLoaders },
+        { "md5",       benchMd5 },
+        { "player",    benchPlayer },
+    };
+
+    // Run only the named benchmarks if any are given
+    for (const auto &b : benchmarks)
+    {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++)
+        {
+            if (!std::strcmp(argv[i], b.name))
+                selected = true;
+        }
+
+        if (selected)
+            b.run();
+    }
+
+    return 0;
+}
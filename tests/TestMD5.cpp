@@ -22,6 +22,10 @@
 
 #include "../src/sidmd5.h"
 
+#include <array>
+#include <cstring>
+#include <vector>
+
 using namespace UnitTest;
 
 SUITE(MD5)
@@ -66,4 +70,45 @@ TEST(TestMD5)
     }
 }
 
+
+/*
+ * The multi-buffer digests must match the scalar ones,
+ * for any number of messages and lengths around the padding limits.
+ */
+TEST(TestMultiBuffer)
+{
+    static const size_t sizes[] = { 0, 1, 3, 55, 56, 57, 63, 64, 65, 119, 120, 128, 300, 5000 };
+    constexpr size_t nsizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    std::vector<uint8_t> data(5000 + 300);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<uint8_t>(i * 13 + (i >> 8));
+
+    const size_t maxCount = 2 * hashlib::md5_multi_lanes() + 3;
+    for (size_t count = 0; count <= maxCount; count++)
+    {
+        std::vector<hashlib::md5_message> messages(count);
+        std::vector<std::array<uint8_t, 16>> digests(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            const size_t size = sizes[(i * 5 + count) % nsizes];
+            // split some messages between data and suffix
+            const size_t split = (i % 3 == 0) ? size : size / (i % 3 + 1);
+            messages[i] = { data.data() + i, split, data.data() + i + split, size - split };
+        }
+
+        libsidplayfp::sidmd5::digest(messages.data(), count, digests.data());
+
+        for (size_t i = 0; i < count; i++)
+        {
+            libsidplayfp::sidmd5 myMD5;
+            myMD5.append(data.data() + i, static_cast<int>(messages[i].size + messages[i].suffix_size));
+
+            char hex[33];
+            libsidplayfp::sidmd5::toHex(digests[i], hex);
+            CHECK_EQUAL(myMD5.getDigest(), std::string(hex));
+        }
+    }
+}
+
 }
@@ -0,0 +1,90 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "utpp/utpp.h"
+
+#include "../src/EventScheduler.h"
+#include "../src/EventScheduler.cpp"
+#include "../src/c64/mmu.h"
+#include "../src/c64/mmu.cpp"
+#include "../src/c64/Banks/IOBank.h"
+
+#include <cstring>
+
+using namespace UnitTest;
+using namespace libsidplayfp;
+
+SUITE(MMU)
+{
+
+struct TestMMU
+{
+    EventScheduler scheduler;
+    IOBank ioBank;
+    MMU mmu;
+
+    TestMMU() :
+        mmu(scheduler, &ioBank)
+    {
+        scheduler.reset();
+        mmu.reset();
+    }
+};
+
+TEST_FIXTURE(TestMMU, TestRamView)
+{
+    const uint8_t* ram = mmu.getRam();
+
+    mmu.cpuWrite(0x1234, 0x56);
+    CHECK_EQUAL(0x56, ram[0x1234]);
+
+    mmu.writeMemWord(0xfffe, 0xabcd);
+    CHECK_EQUAL(0xcd, ram[0xfffe]);
+    CHECK_EQUAL(0xab, ram[0xffff]);
+}
+
+TEST_FIXTURE(TestMMU, TestDirtyPages)
+{
+    uint8_t bitmap[32];
+
+    // all pages dirty when enabling
+    mmu.trackDirtyPages(true);
+    CHECK_EQUAL(256u, mmu.getDirtyPages(bitmap));
+    CHECK_EQUAL(0u, mmu.getDirtyPages(bitmap));
+
+    mmu.cpuWrite(0x1234, 0x56);
+    mmu.cpuWrite(0x12ff, 0x56);
+    mmu.fillRam(0x40ff, static_cast<uint8_t>(0), 2);
+    CHECK_EQUAL(3u, mmu.getDirtyPages(bitmap));
+
+    uint8_t expected[32] = {};
+    expected[0x12 / 8] |= 1 << (0x12 % 8);
+    expected[0x40 / 8] |= 1 << (0x40 % 8);
+    expected[0x41 / 8] |= 1 << (0x41 % 8);
+    CHECK_ARRAY_EQUAL(expected, bitmap, 32);
+
+    // nothing tracked when disabled
+    mmu.trackDirtyPages(false);
+    mmu.getDirtyPages(bitmap);
+    mmu.cpuWrite(0x1234, 0x56);
+    CHECK_EQUAL(0u, mmu.getDirtyPages(bitmap));
+}
+
+}
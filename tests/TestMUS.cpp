@@ -26,6 +26,7 @@
 
 #include <stdint.h>
 #include <cstring>
+#include <string>
 
 #define BUFFERSIZE 26
 
@@ -78,4 +79,21 @@ TEST_FIXTURE(TestFixture, TestWrongVoiceLength)
     CHECK_EQUAL("SIDTUNE ERROR: Could not determine file format", tune.statusString());
 }
 
+
+TEST_FIXTURE(TestFixture, TestProbe)
+{
+    SidTune loaded(data, BUFFERSIZE);
+
+    SidTune probed(nullptr);
+    probed.probe(data, BUFFERSIZE);
+    CHECK(probed.getStatus());
+
+    CHECK_EQUAL(loaded.getInfo()->initAddr(), probed.getInfo()->initAddr());
+    CHECK_EQUAL(loaded.getInfo()->playAddr(), probed.getInfo()->playAddr());
+    CHECK_EQUAL(loaded.getInfo()->loadAddr(), probed.getInfo()->loadAddr());
+    CHECK_EQUAL(loaded.getInfo()->c64dataLen(), probed.getInfo()->c64dataLen());
+    CHECK_EQUAL(loaded.getInfo()->numberOfCommentStrings(), probed.getInfo()->numberOfCommentStrings());
+    CHECK_EQUAL(std::string(loaded.getInfo()->formatString()), std::string(probed.getInfo()->formatString()));
+}
+
 }
@@ -33,6 +33,8 @@
 
 #include <iostream>
 #include <iomanip>
+#include <string>
+#include <cstdio>
 
 using namespace UnitTest;
 using namespace libsidplayfp;
@@ -65,6 +67,10 @@ public:
     }
 
     bool check(uint8_t opcode) const { return getInstr() == opcode; }
+
+    uint_least64_t profileCycles(uint_least16_t addr) const { return cpu_profile->cycles[addr]; }
+
+    uint_least64_t profileCalls(uint_least16_t addr) const { return cpu_profile->jsrCalls[addr]; }
 };
 
 SUITE(mos6510)
@@ -374,4 +380,114 @@ TEST_FIXTURE(TestFixture, TestPlp2Rdy)
     CHECK(cpu.check(BRKn));
 }
 
+/*
+ * Cycles are accounted to the address of the instruction
+ * and calls to the subroutine address
+ */
+TEST_FIXTURE(TestFixture, TestProfile)
+{
+    cpu.setMem(0x00, JSRw);
+    cpu.setMem(0x01, 0x10);
+    cpu.setMem(0x02, 0x10);
+    cpu.setMem(0x03, NOPn);
+    cpu.setMem(0x04, NOPn);
+    cpu.setMem(0x10, NOPn);
+    cpu.setMem(0x11, RTSn);
+
+    cpu.profile(true);
+
+    // JSR, NOP, RTS, NOP and fetch of the last NOP
+    for (int i = 0; i < 6 + 2 + 6 + 2 + 1; i++)
+        scheduler.clock();
+
+    CHECK_EQUAL(6U, cpu.profileCycles(0x1000));
+    CHECK_EQUAL(2U, cpu.profileCycles(0x1010));
+    CHECK_EQUAL(6U, cpu.profileCycles(0x1011));
+    CHECK_EQUAL(2U, cpu.profileCycles(0x1003));
+    CHECK_EQUAL(0U, cpu.profileCycles(0x1004));
+    CHECK_EQUAL(1U, cpu.profileCalls(0x1010));
+    CHECK_EQUAL(0U, cpu.profileCalls(0x1011));
+}
+
+static std::string readFile(FILE *f)
+{
+    std::string content;
+    rewind(f);
+    int c;
+    while ((c = fgetc(f)) != EOF)
+        content.push_back(static_cast<char>(c));
+    return content;
+}
+
+TEST_FIXTURE(TestFixture, TestTrace)
+{
+    const uint8_t program[] = { JSRw, 0x10, 0x10, NOPn, NOPn };
+
+    for (uint8_t i = 0; i < sizeof(program); i++)
+        cpu.setMem(i, program[i]);
+    cpu.setMem(0x10, LDAb);
+    cpu.setMem(0x11, 0x42);
+    cpu.setMem(0x12, RTSn);
+
+    EventScheduler textScheduler;
+    testcpu textCpu(textScheduler);
+    textScheduler.reset();
+    textCpu.reset();
+    for (uint8_t i = 0; i < sizeof(program); i++)
+        textCpu.setMem(i, program[i]);
+    textCpu.setMem(0x10, LDAb);
+    textCpu.setMem(0x11, 0x42);
+    textCpu.setMem(0x12, RTSn);
+
+    FILE *text = tmpfile();
+    textCpu.debug(true, text);
+    cpu.trace(true, 16);
+
+    // JSR, LDA, RTS, NOP and fetch of the last NOP
+    for (int i = 0; i < 6 + 2 + 6 + 2 + 1; i++)
+    {
+        scheduler.clock();
+        textScheduler.clock();
+    }
+
+    MOS6510Debug::Record records[16];
+    const unsigned int count = cpu.readTrace(records, 16);
+
+    CHECK_EQUAL(5U, count);
+    CHECK_EQUAL(0x1000, records[1].pc);
+    CHECK_EQUAL(JSRw, records[1].opcode);
+    CHECK_EQUAL(0x1010, records[1].operand);
+    CHECK_EQUAL(0x1010, records[2].pc);
+    CHECK_EQUAL(0x42, records[2].a);
+    CHECK_EQUAL(RTSn, records[3].opcode);
+    CHECK_EQUAL(0x1003, records[4].pc);
+    CHECK_EQUAL(0U, cpu.readTrace(records, 16));
+    CHECK_EQUAL(0U, cpu.traceDropped());
+
+    // The decoded trace matches the text output
+    FILE *decoded = tmpfile();
+    for (unsigned int i = 0; i < count; i++)
+        MOS6510Debug::Decode(records[i], decoded);
+
+    CHECK_EQUAL(readFile(text), readFile(decoded));
+
+    fclose(decoded);
+    fclose(text);
+}
+
+TEST_FIXTURE(TestFixture, TestTraceOverflow)
+{
+    for (uint8_t i = 0; i < 8; i++)
+        cpu.setMem(i, NOPn);
+
+    cpu.trace(true, 2);
+
+    for (int i = 0; i < 8 * 2; i++)
+        scheduler.clock();
+
+    MOS6510Debug::Record records[8];
+    CHECK_EQUAL(2U, cpu.readTrace(records, 8));
+    CHECK(cpu.traceDropped() > 0);
+}
+
 }
@@ -0,0 +1,176 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "utpp/utpp.h"
+
+#include "../src/builders/sidlite-builder/sidlite/MultiSID.h"
+#include "../src/simpleMixer.h"
+
+#include <memory>
+#include <vector>
+
+using namespace UnitTest;
+
+SUITE(MultiSID)
+{
+
+constexpr int CHUNKS = 200;
+constexpr int MAX_CHUNK_CYCLES = 2000;
+constexpr int BUFFER_SIZE = 4096;
+
+/*
+ * Render the chips one at a time and mix them with the SimpleMixer,
+ * the lockstep renderer must produce the same output.
+ */
+void check(int chips, bool stereo, unsigned int rate = 44100, bool released = false)
+{
+    std::vector<std::unique_ptr<SIDLite::SID>> single;
+    std::vector<std::unique_ptr<SIDLite::SID>> lockstep;
+    SIDLite::SID *sids[SIDLite::MultiSID::MAX_CHIPS];
+
+    for (int k = 0; k < chips; k++)
+    {
+        single.emplace_back(new SIDLite::SID);
+        lockstep.emplace_back(new SIDLite::SID);
+        sids[k] = lockstep.back().get();
+
+        const SIDLite::SID::model_t model = (k & 1) ? SIDLite::SID::model_t::MOS8580 : SIDLite::SID::model_t::MOS6581;
+        for (SIDLite::SID *sid : { single.back().get(), sids[k] })
+        {
+            sid->setChipModel(model);
+            sid->setSamplingParameters(985248, rate);
+        }
+    }
+
+    std::vector<std::vector<short>> buffers(chips, std::vector<short>(BUFFER_SIZE));
+    std::vector<short*> bufs;
+    for (auto &b : buffers)
+        bufs.push_back(b.data());
+
+    libsidplayfp::SimpleMixer mixer(stereo, bufs.data(), chips);
+
+    int weights[SIDLite::MultiSID::MAX_CHANNELS][SIDLite::MultiSID::MAX_CHIPS];
+    for (unsigned int c = 0; c < mixer.channels(); c++)
+        for (int k = 0; k < chips; k++)
+            weights[c][k] = mixer.weight(c, k);
+
+    SIDLite::MultiSID multi(sids, chips);
+    multi.setMixer(mixer.channels(), weights, mixer.scale(), mixer.divisor());
+
+    std::vector<short> expected(BUFFER_SIZE * 2);
+    std::vector<short> actual(BUFFER_SIZE * 2);
+
+    unsigned int seed = 12345;
+    auto next = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 16) & 0x7fff; };
+
+    for (int i = 0; i < CHUNKS; i++)
+    {
+        for (int k = 0; k < chips; k++)
+        {
+            for (int w = next() % 8; w > 0; w--)
+            {
+                const int addr = next() % 0x19;
+                // keep the volume low so the mono sum doesn't overflow
+                int value = addr == 0x18 ? (next() & 0xf7) : (next() & 0xff);
+                // gates off and short releases, the chips go silent
+                if (released && (addr % 7 == 4))
+                    value &= 0xfe;
+                if (released && (addr % 7 == 6))
+                    value &= 0xf0;
+                single[k]->write(addr, value);
+                sids[k]->write(addr, value);
+            }
+        }
+
+        const unsigned int cycles = next() % MAX_CHUNK_CYCLES + 1;
+
+        int samples = 0;
+        for (int k = 0; k < chips; k++)
+            samples = single[k]->clock(cycles, bufs[k]);
+        const unsigned int length = mixer.doMix(expected.data(), samples);
+
+        CHECK_EQUAL(samples, multi.clock(cycles, actual.data()));
+        CHECK_ARRAY_EQUAL(expected.data(), actual.data(), length);
+    }
+}
+
+TEST(TestMono)
+{
+    for (int chips = 1; chips <= 3; chips++)
+        check(chips, false);
+}
+
+TEST(TestStereo)
+{
+    for (int chips = 1; chips <= 3; chips++)
+        check(chips, true);
+}
+
+/*
+ * Above 48kHz the mix is interpolated instead of the single chips,
+ * which only gives the same result with one chip.
+ */
+TEST(TestHighRate)
+{
+    for (unsigned int rate : { 50000, 96000, 192000 })
+    {
+        check(1, false, rate);
+        check(1, true, rate);
+    }
+}
+
+/*
+ * Any rate above 48kHz is emulated at 48kHz
+ * and the output keeps the requested rate.
+ */
+TEST(TestFractionalRate)
+{
+    // one second in 48 calls
+    auto render = [](unsigned int rate)
+    {
+        SIDLite::SID sid;
+        sid.setSamplingParameters(985248, rate);
+
+        std::vector<short> buffer(BUFFER_SIZE * 2);
+        int samples = 0;
+        for (int i = 0; i < 48; i++)
+            samples += sid.clock(20526, buffer.data());
+        return samples;
+    };
+
+    const int emulated = render(48000);
+    for (unsigned int rate : { 50000, 88200, 192000 })
+        CHECK_CLOSE(static_cast<int>(static_cast<long long>(emulated) * rate / 48000), render(rate), 2);
+}
+
+/*
+ * Released voices take the silent path,
+ * possibly for a subset of the chips.
+ */
+TEST(TestReleased)
+{
+    for (int chips = 1; chips <= 3; chips++)
+    {
+        check(chips, false, 44100, true);
+        check(chips, true, 44100, true);
+    }
+}
+
+}
@@ -24,7 +24,12 @@
 #include "../src/sidplayfp/SidTuneInfo.h"
 
 #include <stdint.h>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
 
 #define BUFFERSIZE 128
 
@@ -345,4 +350,225 @@ TEST_FIXTURE(TestFixture, TestWrongThirdSIDAddressLikeSecond)
     CHECK_EQUAL(0, tune.getInfo()->sidChipBase(2));
 }
 
+/////////////
+// TEST MD5 //
+/////////////
+
+/*
+ * Both fingerprints are computed once and stay valid.
+ */
+TEST_FIXTURE(TestFixture, TestMD5)
+{
+    SidTune tune(data, BUFFERSIZE);
+
+    const char *md5 = tune.createMD5();
+    const char *md5New = tune.createMD5New();
+    CHECK_EQUAL("96f4368f0bc5f068d11f6bfe0bdc76ec", md5);
+    CHECK_EQUAL("fcbc4673a85954d5911470a66d347d30", md5New);
+    CHECK_EQUAL(md5, tune.createMD5());
+
+    char buffer[SidTune::MD5_LENGTH + 1];
+    CHECK_EQUAL(buffer, tune.createMD5New(buffer));
+    CHECK_EQUAL("fcbc4673a85954d5911470a66d347d30", buffer);
+}
+
+/*
+ * The old method includes the song speeds and the NTSC flag.
+ */
+TEST_FIXTURE(TestFixture, TestMD5Speed)
+{
+    data[0] = 'P';
+    data[LOADADDRESS_HI] = 0x10;
+    data[INITADDRESS_HI] = 0x10;
+    data[SONGS_LO] = 3;
+    data[SPEED_LO_LO] = 0x05;
+    data[FLAGS] = 0x08;
+
+    SidTune tune(data, BUFFERSIZE);
+    tune.selectSong(2);
+
+    char md5[SidTune::MD5_LENGTH + 1];
+    CHECK_EQUAL("5929cb207b89a96319d74dc0cce16c27", tune.createMD5(md5));
+    CHECK_EQUAL("bc69e0e76f69a0b463f6a6ed90f4c115", tune.createMD5New());
+    CHECK_EQUAL(2u, tune.getInfo()->currentSong());
+}
+
+/*
+ * Batch hashing gives the same fingerprints.
+ */
+TEST_FIXTURE(TestFixture, TestMD5Batch)
+{
+    SidTune rsid(data, BUFFERSIZE);
+
+    data[0] = 'P';
+    data[LOADADDRESS_HI] = 0x10;
+    data[INITADDRESS_HI] = 0x10;
+    data[SONGS_LO] = 3;
+    data[SPEED_LO_LO] = 0x05;
+    data[FLAGS] = 0x08;
+    SidTune psid(data, BUFFERSIZE);
+
+    SidTune empty(static_cast<const uint_least8_t*>(nullptr), 0);
+    CHECK(!empty.getStatus());
+
+    SidTune* const tunes[] = { &rsid, &empty, &psid };
+    SidTune::createMD5Batch(tunes, 3);
+
+    CHECK_EQUAL("96f4368f0bc5f068d11f6bfe0bdc76ec", rsid.createMD5());
+    CHECK_EQUAL("fcbc4673a85954d5911470a66d347d30", rsid.createMD5New());
+    CHECK_EQUAL("5929cb207b89a96319d74dc0cce16c27", psid.createMD5());
+    CHECK_EQUAL("bc69e0e76f69a0b463f6a6ed90f4c115", psid.createMD5New());
+}
+
+
+// TEST probe //
+
+/*
+ * The header must give the same information as the whole file.
+ */
+void checkSameInfo(const SidTuneInfo *probed, const SidTuneInfo *loaded)
+{
+    CHECK_EQUAL(loaded->loadAddr(), probed->loadAddr());
+    CHECK_EQUAL(loaded->initAddr(), probed->initAddr());
+    CHECK_EQUAL(loaded->playAddr(), probed->playAddr());
+    CHECK_EQUAL(loaded->songs(), probed->songs());
+    CHECK_EQUAL(loaded->startSong(), probed->startSong());
+    CHECK_EQUAL(loaded->songSpeed(), probed->songSpeed());
+    CHECK_EQUAL(loaded->clockSpeed(), probed->clockSpeed());
+    CHECK_EQUAL(loaded->compatibility(), probed->compatibility());
+    CHECK_EQUAL(loaded->sidChips(), probed->sidChips());
+    for (int i = 0; i < loaded->sidChips(); i++)
+    {
+        CHECK_EQUAL(loaded->sidChipBase(i), probed->sidChipBase(i));
+        CHECK_EQUAL(loaded->sidModel(i), probed->sidModel(i));
+    }
+    CHECK_EQUAL(loaded->dataFileLen(), probed->dataFileLen());
+    CHECK_EQUAL(loaded->c64dataLen(), probed->c64dataLen());
+    CHECK_EQUAL(loaded->fixLoad(), probed->fixLoad());
+    CHECK_EQUAL(loaded->numberOfInfoStrings(), probed->numberOfInfoStrings());
+    for (unsigned int i = 0; i < loaded->numberOfInfoStrings(); i++)
+        CHECK_EQUAL(std::string(loaded->infoString(i)), std::string(probed->infoString(i)));
+    CHECK_EQUAL(std::string(loaded->formatString()), std::string(probed->formatString()));
+    CHECK_EQUAL(std::string(loaded->dataFileName()), std::string(probed->dataFileName()));
+}
+
+TEST_FIXTURE(TestFixture, TestProbe)
+{
+    data[0] = 'P';
+    data[LOADADDRESS_HI] = 0x10;
+    data[INITADDRESS_HI] = 0x10;
+    data[SONGS_LO] = 3;
+    data[STARTSONG_LO] = 2;
+    data[SPEED_LO_LO] = 0x05;
+    data[FLAGS] = 0x28;
+    std::memcpy(&data[22], "Title", 5);
+    std::memcpy(&data[54], "Author", 6);
+
+    SidTune loaded(data, BUFFERSIZE);
+    CHECK(loaded.getStatus());
+
+    SidTune probed(nullptr);
+    probed.probe(data, BUFFERSIZE);
+    CHECK(probed.getStatus());
+
+    for (unsigned int song = 1; song <= 3; song++)
+        checkSameInfo(probed.getInfo(song), loaded.getInfo(song));
+
+    // only the header was read
+    CHECK(probed.c64Data() == nullptr);
+    CHECK(probed.createMD5() == nullptr);
+}
+
+TEST_FIXTURE(TestFixture, TestProbeError)
+{
+    data[VERSION_LO] = 0x01;
+
+    SidTune probed(nullptr);
+    probed.probe(data, BUFFERSIZE);
+    CHECK(!probed.getStatus());
+    CHECK_EQUAL("Unsupported RSID version", probed.statusString());
+
+    // truncated C64 data
+    probed.probe(data, 0x7C + 1);
+    CHECK(!probed.getStatus());
+}
+
+TEST_FIXTURE(TestFixture, TestProbeFile)
+{
+    const char *names[] = { "TestProbe.sid", "TestProbe.prg" };
+
+    for (const char *name: names)
+    {
+        {
+            std::ofstream file(name, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(data), BUFFERSIZE);
+        }
+
+        SidTune loaded(name);
+        CHECK(loaded.getStatus());
+
+        SidTune probed(nullptr);
+        probed.probe(name);
+        CHECK(probed.getStatus());
+        checkSameInfo(probed.getInfo(), loaded.getInfo());
+
+        std::remove(name);
+    }
+
+    SidTune probed(nullptr);
+    probed.probe("TestProbe.missing");
+    CHECK(!probed.getStatus());
+}
+
+
+// TEST shared data //
+
+/*
+ * A shared buffer is referenced, not copied.
+ */
+TEST_FIXTURE(TestFixture, TestReadShared)
+{
+    std::shared_ptr<std::vector<uint8_t>> buffer = std::make_shared<std::vector<uint8_t>>(data, data + BUFFERSIZE);
+    std::shared_ptr<const uint_least8_t> shared(buffer, buffer->data());
+
+    SidTune tune(nullptr);
+    tune.read(shared, BUFFERSIZE);
+    CHECK(tune.getStatus());
+    CHECK(tune.c64Data() == buffer->data() + 0x7c + 2);
+    CHECK_EQUAL(3, buffer.use_count());
+    CHECK_EQUAL("fcbc4673a85954d5911470a66d347d30", tune.createMD5New());
+
+    tune.read(data, BUFFERSIZE);
+    CHECK(tune.c64Data() != buffer->data() + 0x7c + 2);
+    CHECK_EQUAL(2, buffer.use_count());
+
+    tune.read(std::shared_ptr<const uint_least8_t>(), BUFFERSIZE);
+    CHECK(!tune.getStatus());
+}
+
+/*
+ * A mapped file loads like a buffer.
+ */
+TEST_FIXTURE(TestFixture, TestLoadFile)
+{
+    const char name[] = "TestLoad.sid";
+    {
+        std::ofstream file(name, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data), BUFFERSIZE);
+    }
+
+    SidTune loaded(name);
+    std::remove(name);
+    CHECK(loaded.getStatus());
+    CHECK_EQUAL("96f4368f0bc5f068d11f6bfe0bdc76ec", loaded.createMD5());
+    CHECK_EQUAL("fcbc4673a85954d5911470a66d347d30", loaded.createMD5New());
+
+    {
+        std::ofstream file(name, std::ios::binary);
+    }
+    loaded.load(name);
+    std::remove(name);
+    CHECK(!loaded.getStatus());
+}
+
 }
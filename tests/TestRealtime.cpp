@@ -0,0 +1,207 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "utpp/utpp.h"
+
+#include "TestTunes.h"
+
+#include "sidplayfp/sidplayfp.h"
+#include "sidplayfp/SidConfig.h"
+#include "sidplayfp/SidTune.h"
+#include "builders/sidlite-builder/sidlite.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+/*
+ * Count the allocations while enabled.
+ */
+static bool countAllocs = false;
+static unsigned int allocs = 0;
+
+void* operator new(std::size_t size)
+{
+    if (countAllocs)
+        allocs++;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+// Kept out of line, otherwise GCC pairs the inlined free
+// with the new expressions and warns about a mismatch
+#ifdef __GNUC__
+__attribute__((noinline))
+#endif
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+    operator delete(p);
+}
+
+using namespace UnitTest;
+
+SUITE(Realtime)
+{
+
+constexpr unsigned int CYCLES = 20000;
+constexpr unsigned int PLAY_CALLS = 500;
+
+std::vector<uint8_t> makePSID(uint_least16_t playAddr, uint8_t secondSid)
+{
+    TestTunes::psid_t header;
+    header.playAddr = playAddr;
+    header.secondSid = secondSid;
+    return TestTunes::makePSID(header);
+}
+
+struct Setup
+{
+    std::vector<uint8_t> psid;
+    SidTune tune;
+    SIDLiteBuilder builder;
+    sidplayfp engine;
+    std::vector<short> buffer;
+
+    Setup(uint_least16_t playAddr, uint8_t secondSid, bool stereo) :
+        psid(makePSID(playAddr, secondSid)),
+        tune(psid.data(), psid.size()),
+        builder("realtime"),
+        buffer(CYCLES * 2)
+    {
+        tune.selectSong(0);
+
+        SidConfig config = engine.config();
+        config.frequency = 48000;
+        config.sidEmulation = &builder;
+        config.powerOnDelay = 0;
+
+        ok = tune.getStatus() && engine.config(config) && engine.load(&tune);
+        engine.initMixer(stereo);
+    }
+
+    bool ok;
+};
+
+void checkNoAllocs(uint8_t secondSid, bool stereo)
+{
+    Setup setup(TestTunes::PLAY_ADDR, secondSid, stereo);
+    CHECK(setup.ok);
+
+    allocs = 0;
+    countAllocs = true;
+    bool failed = false;
+    for (unsigned int i = 0; i < PLAY_CALLS; i++)
+    {
+        const int samples = setup.engine.play(CYCLES);
+        if (samples <= 0)
+        {
+            failed = true;
+            break;
+        }
+        setup.engine.mix(setup.buffer.data(), samples);
+    }
+    countAllocs = false;
+
+    CHECK(!failed);
+    CHECK_EQUAL(0u, allocs);
+}
+
+TEST(TestPlayMono)
+{
+    checkNoAllocs(0x00, false);
+}
+
+TEST(TestPlayStereo)
+{
+    checkNoAllocs(0x42, true);
+}
+
+TEST(TestChipBuffer)
+{
+    // a single chip is not premixed, its buffer holds its own output
+    Setup setup(TestTunes::PLAY_ADDR, 0x00, true);
+    CHECK(setup.ok);
+
+    bool same = true;
+    bool changed = false;
+    for (unsigned int i = 0; i < 10; i++)
+    {
+        const int samples = setup.engine.play(CYCLES);
+        CHECK(samples > 0);
+        setup.engine.mix(setup.buffer.data(), samples);
+
+        short *buffers[1];
+        setup.engine.buffers(buffers);
+        for (int s = 0; s < samples; s++)
+        {
+            same = same && (setup.buffer[s * 2] == buffers[0][s]) && (setup.buffer[s * 2 + 1] == buffers[0][s]);
+            changed = changed || (buffers[0][s] != buffers[0][0]);
+        }
+    }
+
+    CHECK(same);
+    CHECK(changed);
+}
+
+TEST(TestIllegalInstruction)
+{
+    Setup setup(TestTunes::JAM_ADDR, 0x00, false);
+    CHECK(setup.ok);
+
+    allocs = 0;
+    countAllocs = true;
+    int result = 0;
+    for (unsigned int i = 0; i < PLAY_CALLS && result >= 0; i++)
+        result = setup.engine.play(CYCLES);
+    countAllocs = false;
+
+    CHECK_EQUAL(-1, result);
+    CHECK_EQUAL(0u, allocs);
+    CHECK_EQUAL(std::string("Illegal instruction $02 at address $1028"), std::string(setup.engine.error()));
+
+    // the CPU stays jammed but the halt is reported once
+    for (unsigned int i = 0; i < 10; i++)
+        CHECK(setup.engine.play(CYCLES) > 0);
+}
+
+}
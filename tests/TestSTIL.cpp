@@ -0,0 +1,166 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "utpp/utpp.h"
+
+#include "TestTunes.h"
+
+#include "utils/STILview/stil.h"
+
+#include <string>
+
+using namespace UnitTest;
+
+SUITE(STIL)
+{
+
+const char STIL_FILE[] = "/TestSTIL.txt";
+const char BUG_FILE[] = "/TestSTIL.bug";
+
+const char STIL_TEXT[] =
+    "#  STIL v3.10\n"
+    "### Hubbard_Rob ###\n"
+    "/MUSICIANS/H/Hubbard_Rob/\n"
+    "COMMENT: Global comment.\n"
+    "\n"
+    "/MUSICIANS/H/Hubbard_Rob/Commando.sid\n"
+    "  TITLE: Commando\n"
+    " ARTIST: Rob Hubbard\n"
+    "\n"
+    "/MUSICIANS/H/Hubbard_Rob/Delta.sid\n"
+    "COMMENT: File comment.\n"
+    "(#1)\n"
+    "  TITLE: Delta in-game\n"
+    " AUTHOR: Rob\n"
+    "(#3)\n"
+    "   NAME: Delta\n"
+    "COMMENT: Tune three.\n";
+
+const char BUG_TEXT[] =
+    "/MUSICIANS/H/Hubbard_Rob/Delta.sid\n"
+    "(#2)\n"
+    "BUG: Wrong speed.\n";
+
+struct TestFiles : TestTunes::TempFiles
+{
+    TestFiles()
+    {
+        writeText(STIL_FILE, STIL_TEXT, "\n");
+        writeText(BUG_FILE, BUG_TEXT, "\n");
+    }
+
+    /// The STIL paths start with a slash, relative to the base dir
+    void writeText(const char *name, const char *text, const char *eol)
+    {
+        std::string converted;
+        for (const char *c = text; *c != '\0'; c++)
+        {
+            if (*c == '\n')
+                converted += eol;
+            else
+                converted += *c;
+        }
+        write(name + 1, converted);
+    }
+
+    static std::string str(const char *s) { return s != nullptr ? s : "(null)"; }
+};
+
+TEST_FIXTURE(TestFiles, TestEntry)
+{
+    STIL stil(STIL_FILE, BUG_FILE);
+    CHECK(stil.setBaseDir("."));
+    CHECK_EQUAL(3.10f, stil.getSTILVersionNo());
+
+    CHECK_EQUAL("  TITLE: Commando\n ARTIST: Rob Hubbard\n",
+        str(stil.getEntry("/MUSICIANS/H/Hubbard_Rob/Commando.sid")));
+    CHECK_EQUAL(" ARTIST: Rob Hubbard\n",
+        str(stil.getEntry("/MUSICIANS/H/Hubbard_Rob/Commando.sid", 1, STIL::artist)));
+
+    CHECK_EQUAL("COMMENT: File comment.\n",
+        str(stil.getEntry("/MUSICIANS/H/Hubbard_Rob/Delta.sid", 0, STIL::comment)));
+    CHECK_EQUAL("  TITLE: Delta in-game\n",
+        str(stil.getEntry("/MUSICIANS/H/Hubbard_Rob/Delta.sid", 1, STIL::title)));
+    CHECK_EQUAL("   NAME: Delta\nCOMMENT: Tune three.\n",
+        str(stil.getEntry("/MUSICIANS/H/Hubbard_Rob/Delta.sid", 3)));
+    CHECK_EQUAL("(null)", str(stil.getEntry("/MUSICIANS/H/Hubbard_Rob/Delta.sid", 2)));
+    CHECK_EQUAL(STIL::NO_STIL_ERROR, stil.getError());
+
+    CHECK_EQUAL("(null)", str(stil.getEntry("/MUSICIANS/H/Hubbard_Rob/Missing.sid")));
+    CHECK_EQUAL(STIL::NOT_IN_STIL, stil.getError());
+    CHECK_EQUAL("(null)", str(stil.getEntry("/MUSICIANS/H/Hubbard_Rob/")));
+    CHECK_EQUAL(STIL::WRONG_ENTRY, stil.getError());
+}
+
+TEST_FIXTURE(TestFiles, TestGlobalCommentAndBug)
+{
+    STIL stil(STIL_FILE, BUG_FILE);
+    CHECK(stil.setBaseDir("."));
+
+    CHECK_EQUAL("COMMENT: Global comment.\n",
+        str(stil.getGlobalComment("/MUSICIANS/H/Hubbard_Rob/Delta.sid")));
+    CHECK_EQUAL("(null)", str(stil.getGlobalComment("/MUSICIANS/G/Galway_Martin/Arkanoid.sid")));
+
+    CHECK_EQUAL("BUG: Wrong speed.\n", str(stil.getBug("/MUSICIANS/H/Hubbard_Rob/Delta.sid", 2)));
+    CHECK_EQUAL("(null)", str(stil.getBug("/MUSICIANS/H/Hubbard_Rob/Commando.sid")));
+    CHECK_EQUAL(STIL::NOT_IN_BUG, stil.getError());
+}
+
+TEST_FIXTURE(TestFiles, TestLineEnds)
+{
+    writeText(STIL_FILE, STIL_TEXT, "\r\n");
+    writeText(BUG_FILE, BUG_TEXT, "\r");
+
+    STIL stil(STIL_FILE, BUG_FILE);
+    CHECK(stil.setBaseDir("."));
+
+    CHECK_EQUAL("   NAME: Delta\nCOMMENT: Tune three.\n",
+        str(stil.getEntry("/MUSICIANS/H/Hubbard_Rob/Delta.sid", 3)));
+    CHECK_EQUAL("BUG: Wrong speed.\n", str(stil.getBug("/MUSICIANS/H/Hubbard_Rob/Delta.sid", 2)));
+}
+
+TEST_FIXTURE(TestFiles, TestNotLoaded)
+{
+    STIL stil(STIL_FILE, BUG_FILE);
+    CHECK_EQUAL("(null)", str(stil.getEntry("/MUSICIANS/H/Hubbard_Rob/Commando.sid")));
+    CHECK_EQUAL(STIL::STIL_OPEN, stil.getError());
+
+    CHECK(!stil.setBaseDir("./missing"));
+    CHECK_EQUAL(STIL::STIL_OPEN, stil.getError());
+}
+
+#ifdef STIL_HAS_STRING_VIEW
+TEST_FIXTURE(TestFiles, TestConcurrent)
+{
+    STIL stil(STIL_FILE, BUG_FILE);
+    CHECK(stil.setBaseDir("."));
+
+    const unsigned int found = TestTunes::runConcurrently(4, 1000, [&stil](unsigned int)
+    {
+        return (stil.entry("/MUSICIANS/H/Hubbard_Rob/Delta.sid", 1, STIL::author) == " AUTHOR: Rob\n")
+            && (stil.globalComment("/MUSICIANS/H/Hubbard_Rob/") == "COMMENT: Global comment.\n")
+            && (stil.bug("/MUSICIANS/H/Hubbard_Rob/Delta.sid") == "(#2)\nBUG: Wrong speed.\n")
+            && stil.entry("/MUSICIANS/H/Hubbard_Rob/Missing.sid").empty();
+    });
+    CHECK_EQUAL(4000u, found);
+}
+#endif
+
+}
@@ -0,0 +1,186 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "utpp/utpp.h"
+
+#include "TestTunes.h"
+
+#include "sidplayfp/sidplayfp.h"
+#include "sidplayfp/SidConfig.h"
+#include "sidplayfp/SidInfo.h"
+#include "sidplayfp/SidTune.h"
+#include "sidplayfp/SidTuneInfo.h"
+#include "builders/sidlite-builder/sidlite.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace UnitTest;
+
+SUITE(SharedTune)
+{
+
+constexpr unsigned int CYCLES = 20000;
+constexpr unsigned int PLAY_CALLS = 50;
+
+/*
+ * Two PAL songs, the second one CIA timed.
+ */
+std::shared_ptr<const SidTune> makeTune()
+{
+    TestTunes::psid_t header;
+    header.songs = 2;
+    header.speed = 0x02;
+    header.flags = 0x04;        // PAL
+    const std::vector<uint8_t> psid = TestTunes::makePSID(header);
+    return std::make_shared<SidTune>(psid.data(), psid.size());
+}
+
+struct Player
+{
+    SIDLiteBuilder builder;
+    sidplayfp engine;
+    std::vector<short> buffer;
+
+    Player() :
+        builder("shared"),
+        buffer(CYCLES * 2)
+    {
+        SidConfig config = engine.config();
+        config.frequency = 48000;
+        config.sidEmulation = &builder;
+        config.powerOnDelay = 0;
+        engine.config(config);
+    }
+
+    bool play(std::shared_ptr<const SidTune> tune, unsigned int song)
+    {
+        return engine.load(std::move(tune), song) && run();
+    }
+
+    bool run()
+    {
+        engine.initMixer(false);
+        for (unsigned int i = 0; i < PLAY_CALLS; i++)
+        {
+            const int samples = engine.play(CYCLES);
+            if (samples <= 0)
+                return false;
+            engine.mix(buffer.data(), samples);
+        }
+        return true;
+    }
+};
+
+TEST(TestSelectSong)
+{
+    std::shared_ptr<const SidTune> tune = makeTune();
+    CHECK(tune->getStatus());
+
+    Player first;
+    Player second;
+    CHECK(first.play(tune, 0));
+    CHECK(second.play(tune, 2));
+
+    CHECK_EQUAL(0, first.engine.getRam()[TestTunes::SONG_ADDR]);
+    CHECK_EQUAL(1, second.engine.getRam()[TestTunes::SONG_ADDR]);
+    CHECK(first.engine.getRam()[TestTunes::COUNTER_ADDR] > 0);
+    CHECK(second.engine.getRam()[TestTunes::COUNTER_ADDR] > 0);
+
+    CHECK_EQUAL(std::string("50 Hz VBI (PAL)"), std::string(first.engine.info().speedString()));
+    CHECK_EQUAL(std::string("CIA (PAL)"), std::string(second.engine.info().speedString()));
+
+    // each player reports its own sub-song
+    const SidTuneInfo *firstInfo = first.engine.tuneInfo();
+    const SidTuneInfo *secondInfo = second.engine.tuneInfo();
+    CHECK(firstInfo != nullptr && secondInfo != nullptr);
+    CHECK_EQUAL(1u, firstInfo->currentSong());
+    CHECK_EQUAL(2u, secondInfo->currentSong());
+    CHECK_EQUAL(static_cast<int>(SidTuneInfo::SPEED_VBI), firstInfo->songSpeed());
+    CHECK_EQUAL(static_cast<int>(SidTuneInfo::SPEED_CIA_1A), secondInfo->songSpeed());
+    CHECK_EQUAL(SidTuneInfo::CLOCK_PAL, firstInfo->clockSpeed());
+    CHECK_EQUAL(SidTuneInfo::CLOCK_PAL, secondInfo->clockSpeed());
+
+    // the tune is left untouched
+    CHECK_EQUAL(0u, tune->getInfo()->currentSong());
+}
+
+TEST(TestTuneInfo)
+{
+    TestTunes::psid_t header;
+    header.flags = 0x08;        // NTSC
+    const std::vector<uint8_t> psid = TestTunes::makePSID(header);
+
+    Player first;
+    Player second;
+    CHECK(first.engine.tuneInfo() == nullptr);
+    CHECK(first.play(makeTune(), 2));
+    CHECK(second.play(std::make_shared<SidTune>(psid.data(), psid.size()), 0));
+
+    CHECK_EQUAL(2u, first.engine.tuneInfo()->currentSong());
+    CHECK_EQUAL(1u, second.engine.tuneInfo()->currentSong());
+    CHECK_EQUAL(SidTuneInfo::CLOCK_PAL, first.engine.tuneInfo()->clockSpeed());
+    CHECK_EQUAL(SidTuneInfo::CLOCK_NTSC, second.engine.tuneInfo()->clockSpeed());
+
+    CHECK(first.engine.load(nullptr, 0));
+    CHECK(first.engine.tuneInfo() == nullptr);
+}
+
+TEST(TestReference)
+{
+    std::shared_ptr<const SidTune> tune = makeTune();
+
+    Player player;
+    CHECK(player.engine.load(tune, 2));
+    CHECK_EQUAL(2, tune.use_count());
+
+    // the player keeps the tune alive
+    std::weak_ptr<const SidTune> loaded = tune;
+    tune.reset();
+    CHECK(!loaded.expired());
+    CHECK(player.engine.reset());
+    CHECK(player.run());
+    CHECK_EQUAL(1, player.engine.getRam()[TestTunes::SONG_ADDR]);
+
+    CHECK(player.engine.load(nullptr, 0));
+    CHECK(loaded.expired());
+
+    // a tune that failed to load is rejected
+    CHECK(!player.engine.load(std::make_shared<SidTune>(nullptr), 0));
+    CHECK_EQUAL(std::string("SIDPLAYER ERROR: No tune loaded"), std::string(player.engine.error()));
+}
+
+TEST(TestConcurrent)
+{
+    std::shared_ptr<const SidTune> tune = makeTune();
+
+    // the odd threads play the second song
+    const unsigned int played = TestTunes::runConcurrently(4, 1, [tune](unsigned int t)
+    {
+        Player player;
+        return player.play(tune, t % 2 + 1)
+            && (player.engine.getRam()[TestTunes::SONG_ADDR] == t % 2);
+    });
+    CHECK_EQUAL(4u, played);
+}
+
+}
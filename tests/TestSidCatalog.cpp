@@ -0,0 +1,281 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "utpp/utpp.h"
+
+#include "TestTunes.h"
+
+#include "utils/SidCatalog.h"
+#include "utils/SidDatabase.h"
+#include "utils/SidPack.h"
+#include "sidplayfp/SidTune.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#  include <filesystem>
+#endif
+
+using namespace UnitTest;
+
+SUITE(SidCatalog)
+{
+
+const char CATALOG[] = "TestSidCatalog.cat";
+const char PACK[] = "TestSidCatalog.spk";
+const char DATABASE[] = "TestSidCatalog.md5";
+
+const char SID_FILE[] = "TestSidCatalog.sid";
+const char MUS_FILE[] = "TestSidCatalog.mus";
+const char STR_FILE[] = "TestSidCatalog.str";
+const char TXT_FILE[] = "TestSidCatalog.txt";
+
+const char SID_MD5_NEW[] = "029605fc2938f2b32cdd1022e97e63ca";
+
+const uint8_t bufferMUS[] =
+{
+    0x52, 0x53,             // load address
+    0x04, 0x00,             // length of the data for Voice 1
+    0x04, 0x00,             // length of the data for Voice 2
+    0x04, 0x00,             // length of the data for Voice 3
+    0x00, 0x00, 0x01, 0x4F, // data for Voice 1
+    0x00, 0x00, 0x01, 0x4F, // data for Voice 2
+    0x00, 0x01, 0x01, 0x4F, // data for Voice 3
+    0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x00, // text description
+};
+
+/*
+ * Two songs for the 6581.
+ */
+std::vector<uint8_t> makePSID(const char *title)
+{
+    TestTunes::psid_t header;
+    header.songs = 2;
+    header.flags = 0x10;        // 6581
+    header.title = title;
+    header.author = "Author";
+    header.released = "1987 Firm";
+    return TestTunes::makePSID(header);
+}
+
+struct TestFiles : TestTunes::TempFiles
+{
+    SidDatabase database;
+    SidCatalog::options_t options;
+
+    TestFiles()
+    {
+        write(SID_FILE, makePSID("Title"));
+        write(MUS_FILE, bufferMUS, sizeof(bufferMUS));
+        write(STR_FILE, bufferMUS, sizeof(bufferMUS));
+        write(TXT_FILE, std::string("text"));
+        add(CATALOG);
+        add(PACK);
+        add(DATABASE);
+
+        std::ofstream db(DATABASE);
+        db << "[Database]\n"
+           << SID_MD5_NEW << "=1:00 0:30.5\n";
+        db.close();
+        database.open(DATABASE);
+
+        options.songlengths = &database;
+        options.stil = [](const char *path)
+            { return std::string(path) == "/TestSidCatalog.sid" ? "COMMENT: Test\n" : ""; };
+        options.threads = 2;
+    }
+
+    static bool pack()
+    {
+        const char *paths[] = { SID_FILE, MUS_FILE, STR_FILE, TXT_FILE };
+        return SidPack::create(".", paths, 4, PACK);
+    }
+};
+
+TEST_FIXTURE(TestFiles, TestBuild)
+{
+    CHECK(pack());
+
+    SidCatalog::stats_t stats;
+    CHECK(SidCatalog::build(PACK, CATALOG, options, &stats));
+    CHECK_EQUAL(4u, stats.files);
+    CHECK_EQUAL(2u, stats.tunes);
+    CHECK_EQUAL(2u, stats.loaded);
+    CHECK_EQUAL(0u, stats.reused);
+
+    SidCatalog catalog;
+    CHECK(catalog.open(CATALOG));
+    CHECK_EQUAL(2u, catalog.count());
+
+    size_t index;
+    CHECK(catalog.find("/TestSidCatalog.sid", index));
+    CHECK_EQUAL("Title", std::string(catalog.title(index)));
+    CHECK_EQUAL("Author", std::string(catalog.author(index)));
+    CHECK_EQUAL("1987 Firm", std::string(catalog.released(index)));
+    CHECK_EQUAL("COMMENT: Test\n", std::string(catalog.stil(index)));
+    CHECK_EQUAL(1987u, catalog.year(index));
+    CHECK_EQUAL(SidTuneInfo::SIDMODEL_6581, catalog.sidModel(index));
+    CHECK_EQUAL(1u, catalog.sidChips(index));
+    CHECK_EQUAL(2u, catalog.songs(index));
+    CHECK_EQUAL(0x7c + sizeof(TestTunes::tuneCode), catalog.size(index));
+    CHECK_EQUAL(60000, catalog.lengthMs(index, 1));
+    CHECK_EQUAL(30500, catalog.lengthMs(index, 2));
+    CHECK_EQUAL(-1, catalog.lengthMs(index, 3));
+
+    const std::vector<uint8_t> psid = makePSID("Title");
+    SidTune tune(psid.data(), psid.size());
+    char md5[33];
+    CHECK_EQUAL(SID_MD5_NEW, std::string(catalog.md5New(index, md5)));
+    CHECK_EQUAL(tune.createMD5(), std::string(catalog.md5(index, md5)));
+
+    // the STR part is listed with the MUS file
+    CHECK(catalog.find("/TestSidCatalog.mus", index));
+    CHECK_EQUAL(2u, catalog.sidChips(index));
+    CHECK_EQUAL("", std::string(catalog.stil(index)));
+    CHECK_EQUAL("", std::string(catalog.md5New(index, md5)));
+    CHECK_EQUAL(-1, catalog.lengthMs(index, 1));
+    CHECK(!catalog.find("/TestSidCatalog.str", index));
+    CHECK(!catalog.find("/TestSidCatalog.txt", index));
+}
+
+TEST_FIXTURE(TestFiles, TestRefresh)
+{
+    CHECK(pack());
+    CHECK(SidCatalog::build(PACK, CATALOG, options, nullptr));
+
+    options.previous = CATALOG;
+    SidCatalog::stats_t stats;
+    CHECK(SidCatalog::build(PACK, CATALOG, options, &stats));
+    CHECK_EQUAL(2u, stats.tunes);
+    CHECK_EQUAL(0u, stats.loaded);
+    CHECK_EQUAL(2u, stats.reused);
+
+    SidCatalog catalog;
+    CHECK(catalog.open(CATALOG));
+    size_t index;
+    CHECK(catalog.find("/TestSidCatalog.sid", index));
+    CHECK_EQUAL("Title", std::string(catalog.title(index)));
+    CHECK_EQUAL(30500, catalog.lengthMs(index, 2));
+
+    // tunes without fingerprints keep none
+    char md5[33];
+    CHECK(catalog.find("/TestSidCatalog.mus", index));
+    CHECK_EQUAL("", std::string(catalog.md5(index, md5)));
+    CHECK_EQUAL("", std::string(catalog.md5New(index, md5)));
+    catalog.close();
+
+    // only the changed tune is read again
+    write(SID_FILE, makePSID("Other"));
+    CHECK(pack());
+    CHECK(SidCatalog::build(PACK, CATALOG, options, &stats));
+    CHECK_EQUAL(1u, stats.loaded);
+    CHECK_EQUAL(1u, stats.reused);
+
+    CHECK(catalog.open(CATALOG));
+    CHECK(catalog.find("/TestSidCatalog.sid", index));
+    CHECK_EQUAL("Other", std::string(catalog.title(index)));
+    CHECK_EQUAL(-1, catalog.lengthMs(index, 1));
+}
+
+TEST_FIXTURE(TestFiles, TestBatches)
+{
+    // more tunes than a worker fingerprints at once
+    constexpr unsigned int TUNES = 40;
+    std::vector<std::string> names;
+    for (unsigned int i = 0; i < TUNES; i++)
+    {
+        names.push_back("TestSidCatalog" + std::to_string(i) + ".sid");
+        write(names.back().c_str(), makePSID(names.back().c_str()));
+    }
+
+    std::vector<const char*> paths;
+    for (const std::string &name: names)
+        paths.push_back(name.c_str());
+    CHECK(SidPack::create(".", paths.data(), paths.size(), PACK));
+
+    SidCatalog::stats_t stats;
+    CHECK(SidCatalog::build(PACK, CATALOG, options, &stats));
+    CHECK_EQUAL(TUNES, stats.tunes);
+
+    SidCatalog catalog;
+    CHECK(catalog.open(CATALOG));
+    for (const std::string &name: names)
+    {
+        const std::vector<uint8_t> psid = makePSID(name.c_str());
+        SidTune tune(psid.data(), psid.size());
+
+        size_t index;
+        char md5[33];
+        CHECK(catalog.find(("/" + name).c_str(), index));
+        CHECK_EQUAL(name, std::string(catalog.title(index)));
+        CHECK_EQUAL(tune.createMD5(), std::string(catalog.md5(index, md5)));
+        CHECK_EQUAL(tune.createMD5New(), std::string(catalog.md5New(index, md5)));
+    }
+}
+
+#if __cplusplus >= 201703L
+TEST_FIXTURE(TestFiles, TestDirectory)
+{
+    const char DIR[] = "TestSidCatalog.dir";
+    std::filesystem::create_directories(std::string(DIR) + "/MUSICIANS");
+    std::filesystem::copy_file(SID_FILE, std::string(DIR) + "/MUSICIANS/Tune.sid");
+
+    SidCatalog::stats_t stats;
+    CHECK(SidCatalog::build(DIR, CATALOG, options, &stats));
+    CHECK_EQUAL(1u, stats.tunes);
+
+    options.previous = CATALOG;
+    CHECK(SidCatalog::build(DIR, CATALOG, options, &stats));
+    CHECK_EQUAL(1u, stats.reused);
+
+    std::filesystem::remove_all(DIR);
+
+    SidCatalog catalog;
+    CHECK(catalog.open(CATALOG));
+    size_t index;
+    CHECK(catalog.find("/MUSICIANS/Tune.sid", index));
+    CHECK_EQUAL(60000, catalog.lengthMs(index, 1));
+}
+#endif
+
+TEST_FIXTURE(TestFiles, TestCorrupt)
+{
+    SidCatalog catalog;
+    CHECK(!catalog.open(CATALOG));
+    CHECK(!catalog.open(SID_FILE));
+
+    CHECK(pack());
+    CHECK(SidCatalog::build(PACK, CATALOG, options, nullptr));
+
+    // more tunes than fit in the file
+    {
+        std::ofstream file(CATALOG, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(10);
+        file.put(100);
+    }
+    CHECK(!catalog.open(CATALOG));
+    CHECK_EQUAL(0u, catalog.count());
+
+    CHECK(!SidCatalog::build("TestSidCatalog.missing", CATALOG, options, nullptr));
+}
+
+}
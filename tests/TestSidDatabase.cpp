@@ -0,0 +1,218 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "utpp/utpp.h"
+
+#include "TestTunes.h"
+
+#include "utils/SidDatabase.h"
+
+#include <fstream>
+
+using namespace UnitTest;
+
+SUITE(SidDatabase)
+{
+
+const char TEXT_DB[] = "TestSidDatabase.md5";
+const char BINARY_DB[] = "TestSidDatabase.sldb";
+
+const char MD5_A[] = "0123456789abcdef0123456789abcdef";
+const char MD5_B[] = "fedcba9876543210fedcba9876543210";
+const char MD5_C[] = "00000000000000000000000000000001";
+const char MD5_MISSING[] = "11111111111111111111111111111111";
+
+struct TestDatabase : TestTunes::TempFiles
+{
+    TestDatabase()
+    {
+        add(TEXT_DB);
+        add(BINARY_DB);
+
+        std::ofstream db(TEXT_DB);
+        db << "; comment\n"
+           << "[Other]\n"
+           << MD5_MISSING << "=1:00\n"
+           << "[Database]\n"
+           << "; /MUSICIANS/Test/Tune_B.sid\n"
+           << MD5_B << "=0:01.5 10:02.25 1:00.001\n"
+           << "; /MUSICIANS/Test/Tune_A.sid\n"
+           << MD5_A << "=2:30\r\n"
+           << MD5_A << "=9:99\n"
+           << MD5_C << "=0:10 bad 0:20\n";
+    }
+
+    /*
+     * The binary index must answer like the text database.
+     */
+    void compare(const char *md5, unsigned int song)
+    {
+        SidDatabase text;
+        SidDatabase binary;
+        CHECK(text.open(TEXT_DB));
+        CHECK(binary.open(BINARY_DB));
+        CHECK_EQUAL(text.lengthMs(md5, song), binary.lengthMs(md5, song));
+    }
+};
+
+TEST_FIXTURE(TestDatabase, TestText)
+{
+    SidDatabase db;
+    CHECK(db.open(TEXT_DB));
+
+    CHECK_EQUAL(150000, db.lengthMs(MD5_A, 1));
+    CHECK_EQUAL(1500, db.lengthMs(MD5_B, 1));
+    CHECK_EQUAL(602250, db.lengthMs(MD5_B, 2));
+    CHECK_EQUAL(60001, db.lengthMs(MD5_B, 3));
+    CHECK_EQUAL(602, db.length(MD5_B, 2));
+}
+
+TEST_FIXTURE(TestDatabase, TestBinary)
+{
+    CHECK(SidDatabase::convert(TEXT_DB, BINARY_DB));
+
+    SidDatabase db;
+    CHECK(db.open(BINARY_DB));
+
+    CHECK_EQUAL(150000, db.lengthMs(MD5_A, 1));
+    CHECK_EQUAL(1500, db.lengthMs(MD5_B, 1));
+    CHECK_EQUAL(602250, db.lengthMs(MD5_B, 2));
+    CHECK_EQUAL(60001, db.lengthMs(MD5_B, 3));
+    CHECK_EQUAL(602, db.length(MD5_B, 2));
+    CHECK_EQUAL(10000, db.lengthMs(MD5_C, 1));
+
+    CHECK_EQUAL(-1, db.lengthMs(MD5_B, 4));
+    CHECK_EQUAL(-1, db.lengthMs(MD5_MISSING, 1));
+    CHECK_EQUAL(-1, db.lengthMs("0123", 1));
+}
+
+TEST_FIXTURE(TestDatabase, TestSameAsText)
+{
+    CHECK(SidDatabase::convert(TEXT_DB, BINARY_DB));
+
+    for (unsigned int song = 1; song <= 4; song++)
+    {
+        compare(MD5_A, song);
+        compare(MD5_B, song);
+        compare(MD5_MISSING, song);
+    }
+    compare(MD5_C, 1);
+}
+
+TEST_FIXTURE(TestDatabase, TestCorrupt)
+{
+    CHECK(SidDatabase::convert(TEXT_DB, BINARY_DB));
+
+    // truncated index
+    {
+        std::ofstream db(BINARY_DB, std::ios::binary | std::ios::in | std::ios::out);
+        db.seekp(8);
+        db.put(100);
+    }
+
+    // not recognized as an index, parsed as text without a database section
+    SidDatabase db;
+    CHECK(db.open(BINARY_DB));
+    CHECK_EQUAL(-1, db.lengthMs(MD5_A, 1));
+}
+
+/*
+ * Same results from both formats.
+ */
+void checkLookup(const char *filename)
+{
+    SidDatabase db;
+    int_least32_t length = 0;
+    CHECK_EQUAL(SidDatabase::NOT_LOADED, db.lookup(MD5_A, 1, length));
+
+    CHECK(db.open(filename));
+    CHECK_EQUAL(SidDatabase::OK, db.lookup(MD5_B, 2, length));
+    CHECK_EQUAL(602250, length);
+    CHECK_EQUAL(SidDatabase::NOT_FOUND, db.lookup(MD5_MISSING, 1, length));
+    CHECK_EQUAL(SidDatabase::NO_SUBTUNE, db.lookup(MD5_B, 4, length));
+    CHECK_EQUAL(SidDatabase::NO_SUBTUNE, db.lookup(MD5_B, 0, length));
+    CHECK_EQUAL(602250, length);
+
+    const SidDatabase::query_t queries[] =
+    {
+        { MD5_A, 1 },
+        { MD5_MISSING, 1 },
+        { MD5_B, 3 },
+        { MD5_B, 4 },
+    };
+    int_least32_t lengths[4];
+    SidDatabase::status_t status[4];
+    CHECK_EQUAL(2u, db.lookup(queries, 4, lengths, status));
+    CHECK_EQUAL(150000, lengths[0]);
+    CHECK_EQUAL(-1, lengths[1]);
+    CHECK_EQUAL(60001, lengths[2]);
+    CHECK_EQUAL(-1, lengths[3]);
+    CHECK_EQUAL(SidDatabase::OK, status[0]);
+    CHECK_EQUAL(SidDatabase::NOT_FOUND, status[1]);
+    CHECK_EQUAL(SidDatabase::OK, status[2]);
+    CHECK_EQUAL(SidDatabase::NO_SUBTUNE, status[3]);
+
+    CHECK_EQUAL(-1, db.lengthMs(MD5_MISSING, 1));
+    CHECK_EQUAL(SidDatabase::statusString(SidDatabase::NOT_FOUND), db.error());
+}
+
+TEST_FIXTURE(TestDatabase, TestLookup)
+{
+    checkLookup(TEXT_DB);
+
+    CHECK(SidDatabase::convert(TEXT_DB, BINARY_DB));
+    checkLookup(BINARY_DB);
+}
+
+TEST_FIXTURE(TestDatabase, TestConcurrent)
+{
+    CHECK(SidDatabase::convert(TEXT_DB, BINARY_DB));
+
+    for (const char *filename: { TEXT_DB, BINARY_DB })
+    {
+        SidDatabase db;
+        CHECK(db.open(filename));
+
+        const SidDatabase::query_t queries[] =
+        {
+            { MD5_A, 1 },
+            { MD5_B, 1 },
+            { MD5_B, 2 },
+            { MD5_B, 3 },
+        };
+
+        const unsigned int found = TestTunes::runConcurrently(4, 1000, [&db, &queries](unsigned int)
+        {
+            int_least32_t lengths[4];
+            return (db.lookup(queries, 4, lengths) == 4)
+                && (lengths[0] == 150000) && (lengths[3] == 60001);
+        });
+        CHECK_EQUAL(4000u, found);
+    }
+}
+
+TEST(TestMissing)
+{
+    SidDatabase db;
+    CHECK(!db.open("TestSidDatabase.missing"));
+    CHECK(!SidDatabase::convert("TestSidDatabase.missing", BINARY_DB));
+}
+
+}
@@ -0,0 +1,202 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "utpp/utpp.h"
+
+#include "TestTunes.h"
+
+#include "utils/SidPack.h"
+#include "sidplayfp/SidTune.h"
+#include "sidplayfp/SidTuneInfo.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace UnitTest;
+
+SUITE(SidPack)
+{
+
+const char PACK[] = "TestSidPack.spk";
+
+const char MUS_FILE[] = "TestSidPack.mus";
+const char STR_FILE[] = "TestSidPack.str";
+const char BIG_FILE[] = "TestSidPack.bin";
+const char SID_FILE[] = "TestSidPack.sid";
+
+const uint8_t bufferMUS[] =
+{
+    0x52, 0x53,             // load address
+    0x04, 0x00,             // length of the data for Voice 1
+    0x04, 0x00,             // length of the data for Voice 2
+    0x04, 0x00,             // length of the data for Voice 3
+    0x00, 0x00, 0x01, 0x4F, // data for Voice 1
+    0x00, 0x00, 0x01, 0x4F, // data for Voice 2
+    0x00, 0x01, 0x01, 0x4F, // data for Voice 3
+    0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x00, // text description
+};
+
+const char MUS_MD5[] = "261061f5b6d3231fb180f5a61e2604a9";
+
+struct TestFiles : TestTunes::TempFiles
+{
+    TestFiles()
+    {
+        write(MUS_FILE, bufferMUS, sizeof(bufferMUS));
+        write(STR_FILE, bufferMUS, sizeof(bufferMUS));
+        write(BIG_FILE, std::vector<uint8_t>(5000, 0x55));
+        write(SID_FILE, TestTunes::makePSID());
+        add(PACK);
+    }
+
+    static bool create()
+    {
+        const char *paths[] = { BIG_FILE, "./TestSidPack.mus", STR_FILE, MUS_FILE };
+        return SidPack::create(".", paths, 4, PACK);
+    }
+};
+
+TEST_FIXTURE(TestFiles, TestFind)
+{
+    CHECK(create());
+
+    SidPack pack;
+    CHECK(pack.open(PACK));
+    CHECK_EQUAL(3u, pack.count());
+
+    SidPack::entry_t entry;
+    CHECK(pack.find("/TestSidPack.mus", entry));
+    CHECK_EQUAL("/TestSidPack.mus", std::string(entry.path));
+    CHECK_EQUAL(sizeof(bufferMUS), entry.size);
+    CHECK(std::equal(bufferMUS, bufferMUS + sizeof(bufferMUS), entry.data));
+    CHECK_EQUAL(MUS_MD5, std::string(entry.md5));
+
+    CHECK(pack.find("TestSidPack.bin", entry));
+    CHECK_EQUAL(5000u, entry.size);
+    CHECK(!pack.find("/TestSidPack.sid", entry));
+
+    // sorted by path
+    std::string previous;
+    for (size_t i = 0; i < pack.count(); i++)
+    {
+        CHECK(pack.entry(i, entry));
+        CHECK(previous < entry.path);
+        previous = entry.path;
+    }
+    CHECK(!pack.entry(pack.count(), entry));
+}
+
+TEST_FIXTURE(TestFiles, TestRead)
+{
+    CHECK(create());
+
+    SidPack pack;
+    CHECK(pack.open(PACK));
+
+    std::vector<uint8_t> buffer;
+    pack.read("/TestSidPack.str", buffer);
+    CHECK_EQUAL(sizeof(bufferMUS), buffer.size());
+
+    pack.read("/TestSidPack.sid", buffer);
+    CHECK(buffer.empty());
+}
+
+TEST_FIXTURE(TestFiles, TestLoad)
+{
+    CHECK(create());
+
+    SidPack pack;
+    CHECK(pack.open(PACK));
+
+    // the STR part is read from the pack too
+    SidTune tune(nullptr);
+    CHECK(pack.load("/TestSidPack.mus", tune));
+    CHECK_EQUAL(2, tune.getInfo()->sidChips());
+    CHECK_EQUAL("TestSidPack.mus", std::string(tune.getInfo()->dataFileName()));
+
+    CHECK(!pack.load("/TestSidPack.sid", tune));
+    CHECK(!tune.getStatus());
+}
+
+TEST_FIXTURE(TestFiles, TestLoadShared)
+{
+    const char *paths[] = { SID_FILE };
+    CHECK(SidPack::create(".", paths, 1, PACK));
+
+    SidPack pack;
+    CHECK(pack.open(PACK));
+    SidPack::entry_t entry;
+    CHECK(pack.find(SID_FILE, entry));
+
+    SidTune tune(nullptr);
+    CHECK(pack.load(SID_FILE, tune));
+    CHECK_EQUAL(TestTunes::LOAD_ADDR, tune.getInfo()->loadAddr());
+
+    // the tune keeps the pack mapped
+    const std::string md5(entry.md5);
+    pack.close();
+    CHECK_EQUAL(md5, std::string(tune.createMD5New()));
+}
+
+TEST_FIXTURE(TestFiles, TestCorrupt)
+{
+    SidPack pack;
+    CHECK(!pack.open(PACK));
+    CHECK(!pack.open(MUS_FILE));
+
+    CHECK(create());
+
+    // more entries than fit in the file
+    {
+        std::ofstream file(PACK, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(10);
+        file.put(100);
+    }
+    CHECK(!pack.open(PACK));
+    CHECK_EQUAL(0u, pack.count());
+
+    SidPack::entry_t entry;
+    CHECK(!pack.find("/TestSidPack.mus", entry));
+
+    const char *missing[] = { "TestSidPack.missing" };
+    CHECK(!SidPack::create(".", missing, 1, PACK));
+}
+
+TEST_FIXTURE(TestFiles, TestConcurrent)
+{
+    CHECK(create());
+
+    SidPack pack;
+    CHECK(pack.open(PACK));
+
+    const unsigned int found = TestTunes::runConcurrently(4, 100, [&pack](unsigned int)
+    {
+        SidTune tune(nullptr);
+        SidPack::entry_t entry;
+        return pack.find("/TestSidPack.bin", entry)
+            && (entry.size == 5000)
+            && pack.load("/TestSidPack.str", tune)
+            && (tune.getInfo()->sidChips() == 2);
+    });
+    CHECK_EQUAL(400u, found);
+}
+
+}
@@ -0,0 +1,125 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "utpp/utpp.h"
+
+#include "../src/streamer.h"
+#include "../src/streamer.cpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace UnitTest;
+using namespace libsidplayfp;
+
+SUITE(Streamer)
+{
+
+constexpr unsigned int BLOCK = 100;
+constexpr unsigned int FREQUENCY = 48000;
+
+/*
+ * Stereo frames holding a running counter on both channels,
+ * after the given number of frames the render fails.
+ */
+struct Counter
+{
+    std::atomic<int> next { 0 };
+    int limit;
+
+    explicit Counter(int limit = -1) : limit(limit) {}
+
+    int operator()(short *buffer)
+    {
+        if (limit >= 0 && next.load() >= limit)
+            return -1;
+
+        for (unsigned int i = 0; i < BLOCK; i++)
+        {
+            const short value = static_cast<short>(next++);
+            buffer[i * 2] = value;
+            buffer[i * 2 + 1] = -value;
+        }
+        return BLOCK * 2;
+    }
+};
+
+bool waitFill(const Streamer &streamer, unsigned int frames)
+{
+    for (int i = 0; i < 2000; i++)
+    {
+        if (streamer.fill() >= frames)
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+TEST(TestLookahead)
+{
+    Counter counter;
+    Streamer streamer(std::ref(counter), 2, BLOCK * 2, 1000, FREQUENCY);
+
+    CHECK(waitFill(streamer, 1000));
+    // the lookahead may be exceeded by at most a block
+    CHECK(streamer.fill() < 1000 + BLOCK);
+
+    std::vector<short> buffer(3000 * 2);
+    int expected = 0;
+    for (int round = 0; round < 3; round++)
+    {
+        CHECK(waitFill(streamer, 1000));
+        CHECK_EQUAL(1000u, streamer.read(buffer.data(), 1000));
+        for (unsigned int i = 0; i < 1000; i++, expected++)
+        {
+            CHECK_EQUAL(static_cast<short>(expected), buffer[i * 2]);
+            CHECK_EQUAL(static_cast<short>(-expected), buffer[i * 2 + 1]);
+        }
+    }
+
+    CHECK_EQUAL(0u, streamer.underruns());
+    CHECK(!streamer.failed());
+}
+
+TEST(TestUnderrun)
+{
+    Counter counter(500);
+    Streamer streamer(std::ref(counter), 2, BLOCK * 2, 1000, FREQUENCY);
+
+    for (int i = 0; i < 2000 && !streamer.failed(); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    CHECK(streamer.failed());
+    CHECK_EQUAL(500u, streamer.fill());
+
+    std::vector<short> buffer(600 * 2, 1);
+    CHECK_EQUAL(500u, streamer.read(buffer.data(), 600));
+    CHECK_EQUAL(1u, streamer.underruns());
+
+    // the missing frames are silent
+    for (unsigned int i = 500 * 2; i < 600 * 2; i++)
+        CHECK_EQUAL(0, buffer[i]);
+
+    CHECK_EQUAL(0u, streamer.read(buffer.data(), 10));
+    CHECK_EQUAL(2u, streamer.underruns());
+}
+
+}
@@ -0,0 +1,194 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2026 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef TESTTUNES_H
+#define TESTTUNES_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Test tune shared by the tests and the benchmarks:
+ * a tiny PSID at $1000 that stores the song number,
+ * sets up all three voices and the filter, then sweeps
+ * the frequencies and the cutoff on each play call.
+ * Also the helpers shared by the tests.
+ */
+namespace TestTunes
+{
+
+constexpr uint16_t LOAD_ADDR = 0x1000;
+constexpr uint16_t INIT_ADDR = 0x1000;
+constexpr uint16_t PLAY_ADDR = 0x1003;
+/// Address of an illegal instruction, use as play address to jam the CPU
+constexpr uint16_t JAM_ADDR = 0x1028;
+/// The song number passed to init, starting from zero
+constexpr uint16_t SONG_ADDR = 0x1030;
+/// Incremented on each play call
+constexpr uint16_t COUNTER_ADDR = 0x1031;
+
+const uint8_t tuneCode[] =
+{
+    0x4c, 0x06, 0x10,       // $1000 JMP init
+    0x4c, 0x18, 0x10,       // $1003 JMP play
+    0x8d, 0x30, 0x10,       // $1006 init: STA song
+    0xa2, 0x18,             // $1009 LDX #$18
+    0xbd, 0x32, 0x10,       // $100b LDA regs,X
+    0x9d, 0x00, 0xd4,       // $100e STA $D400,X
+    0xca,                   // $1011 DEX
+    0x10, 0xf7,             // $1012 BPL $100b
+    0x60,                   // $1014 RTS
+    0xea, 0xea, 0xea,
+    0xee, 0x31, 0x10,       // $1018 play: INC counter
+    0xad, 0x31, 0x10,       // $101b LDA counter
+    0x8d, 0x01, 0xd4,       // $101e STA $D401
+    0x8d, 0x08, 0xd4,       // $1021 STA $D408
+    0x8d, 0x16, 0xd4,       // $1024 STA $D416
+    0x60,                   // $1027 RTS
+    0x02,                   // $1028 JAM
+    0xea, 0xea, 0xea, 0xea, 0xea, 0xea, 0xea,
+    0x00,                   // $1030 song
+    0x00,                   // $1031 counter
+    // $1032 regs
+    0x00, 0x10, 0x00, 0x08, 0x21, 0x09, 0xf0,
+    0x00, 0x20, 0x00, 0x08, 0x41, 0x09, 0xf0,
+    0x00, 0x08, 0x00, 0x00, 0x81, 0x09, 0xf0,
+    0x00, 0x40, 0xf3, 0x1f
+};
+
+/**
+ * The PSID header fields the tests change.
+ */
+struct psid_t
+{
+    uint_least16_t playAddr = PLAY_ADDR;
+    unsigned int songs = 1;
+    /// One bit per song, set for CIA timing
+    uint_least32_t speed = 0;
+    uint_least16_t flags = 0;
+    uint8_t secondSid = 0;
+    const char *title = "";
+    const char *author = "";
+    const char *released = "";
+};
+
+/**
+ * Build a PSID v3 file around the test tune.
+ */
+inline std::vector<uint8_t> makePSID(const psid_t &header = psid_t())
+{
+    std::vector<uint8_t> psid(0x7c, 0);
+    std::memcpy(psid.data(), "PSID", 4);
+    psid[5] = 3;                                // version
+    psid[7] = 0x7c;                             // dataOffset
+    psid[8] = LOAD_ADDR >> 8;                   // loadAddress
+    psid[9] = LOAD_ADDR & 0xff;
+    psid[10] = INIT_ADDR >> 8;                  // initAddress
+    psid[11] = INIT_ADDR & 0xff;
+    psid[12] = header.playAddr >> 8;            // playAddress
+    psid[13] = header.playAddr & 0xff;
+    psid[14] = header.songs >> 8;               // songs
+    psid[15] = header.songs & 0xff;
+    psid[17] = 1;                               // startSong
+    for (int i = 0; i < 4; i++)                 // speed
+        psid[18 + i] = (header.speed >> (24 - i * 8)) & 0xff;
+    std::strncpy(reinterpret_cast<char*>(&psid[22]), header.title, 31);
+    std::strncpy(reinterpret_cast<char*>(&psid[54]), header.author, 31);
+    std::strncpy(reinterpret_cast<char*>(&psid[86]), header.released, 31);
+    psid[118] = header.flags >> 8;              // flags
+    psid[119] = header.flags & 0xff;
+    psid[122] = header.secondSid;               // secondSIDAddress
+    psid.resize(0x7c + sizeof(tuneCode));
+    std::memcpy(psid.data() + 0x7c, tuneCode, sizeof(tuneCode));
+    return psid;
+}
+
+/**
+ * Files in the working directory, removed
+ * when the fixture goes out of scope.
+ */
+class TempFiles
+{
+private:
+    std::vector<std::string> names;
+
+public:
+    ~TempFiles()
+    {
+        for (const std::string &name: names)
+            std::remove(name.c_str());
+    }
+
+    /**
+     * Remove the file at the end, for files created by the code under test.
+     */
+    void add(const char *name) { names.push_back(name); }
+
+    void write(const char *name, const uint8_t *data, size_t size)
+    {
+        add(name);
+        std::ofstream file(name, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data), size);
+    }
+
+    void write(const char *name, const std::vector<uint8_t> &data) { write(name, data.data(), data.size()); }
+
+    void write(const char *name, const std::string &text)
+    {
+        write(name, reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    }
+};
+
+/**
+ * Call fn(thread) the given number of times on each thread.
+ *
+ * @return the number of calls that returned true
+ */
+template<typename Func>
+unsigned int runConcurrently(unsigned int threads, unsigned int iterations, Func fn)
+{
+    std::vector<unsigned int> passed(threads, 0);
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&fn, &passed, iterations, t]()
+        {
+            for (unsigned int i = 0; i < iterations; i++)
+            {
+                if (fn(t))
+                    passed[t]++;
+            }
+        });
+    }
+    for (std::thread &worker: workers)
+        worker.join();
+
+    return std::accumulate(passed.begin(), passed.end(), 0u);
+}
+
+}
+
+#endif // TESTTUNES_H
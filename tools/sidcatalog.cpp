@@ -0,0 +1,164 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Tune collection catalog builder.
+ *
+ * Builds or refreshes the catalog of a collection directory
+ * or pack, joining the songlengths and the STIL entries:
+ *     sidcatalog -s Songlengths.md5 -t C64Music C64Music HVSC.cat
+ *
+ * Lists the content of a catalog:
+ *     sidcatalog -l HVSC.cat
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+#include "utils/SidCatalog.h"
+#include "utils/SidDatabase.h"
+#include "utils/STILview/stil.h"
+
+int list(const char *filename)
+{
+    SidCatalog catalog;
+    if (!catalog.open(filename))
+    {
+        std::fprintf(stderr, "%s\n", catalog.error());
+        return 1;
+    }
+
+    for (size_t i = 0; i < catalog.count(); i++)
+    {
+        char md5[33];
+        std::printf("%s %s | %s | %s | %u SID(s) |", catalog.md5New(i, md5), catalog.path(i),
+            catalog.title(i), catalog.author(i), catalog.sidChips(i));
+        for (unsigned int song = 1; song <= catalog.songs(i); song++)
+        {
+            const int_least32_t ms = catalog.lengthMs(i, song);
+            if (ms < 0)
+                std::printf(" ?");
+            else
+                std::printf(" %d:%02d.%03d", ms / 60000, (ms / 1000) % 60, ms % 1000);
+        }
+        std::printf("\n");
+    }
+
+    return 0;
+}
+
+void usage(const char *name)
+{
+    std::fprintf(stderr, "Usage: %s [-j threads] [-s songlengths] [-t HVSC root] [-f] <collection or pack> <catalog>\n", name);
+    std::fprintf(stderr, "       %s -l <catalog>\n", name);
+    std::fprintf(stderr, "  -j  number of worker threads, one per core by default\n");
+    std::fprintf(stderr, "  -s  join the songlength database\n");
+    std::fprintf(stderr, "  -t  join the STIL entries of the HVSC at the given root\n");
+    std::fprintf(stderr, "  -f  read all the tunes, don't refresh the existing catalog\n");
+}
+
+int main(int argc, char* argv[])
+{
+    if ((argc == 3) && (std::strcmp(argv[1], "-l") == 0))
+        return list(argv[2]);
+
+    SidCatalog::options_t options;
+    const char *songlengths = nullptr;
+    const char *hvsc = nullptr;
+    bool force = false;
+
+    int arg = 1;
+    for (; (arg < argc) && (argv[arg][0] == '-'); arg++)
+    {
+        if (std::strcmp(argv[arg], "-f") == 0)
+            force = true;
+        else if ((std::strcmp(argv[arg], "-j") == 0) && (arg + 1 < argc))
+            options.threads = std::atoi(argv[++arg]);
+        else if ((std::strcmp(argv[arg], "-s") == 0) && (arg + 1 < argc))
+            songlengths = argv[++arg];
+        else if ((std::strcmp(argv[arg], "-t") == 0) && (arg + 1 < argc))
+            hvsc = argv[++arg];
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (argc - arg != 2)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const char *source = argv[arg];
+    const char *output = argv[arg + 1];
+
+    SidDatabase database;
+    if (songlengths != nullptr)
+    {
+        if (!database.open(songlengths))
+        {
+            std::fprintf(stderr, "%s\n", database.error());
+            return 1;
+        }
+        options.songlengths = &database;
+    }
+
+    STIL stil;
+#ifndef STIL_HAS_STRING_VIEW
+    std::mutex stilLock;
+#endif
+    if (hvsc != nullptr)
+    {
+        if (!stil.setBaseDir(hvsc))
+        {
+            std::fprintf(stderr, "%s\n", stil.getErrorStr());
+            return 1;
+        }
+#ifdef STIL_HAS_STRING_VIEW
+        options.stil = [&stil](const char *path) { return std::string(stil.entry(path)); };
+#else
+        options.stil = [&stil, &stilLock](const char *path)
+        {
+            std::lock_guard<std::mutex> lock(stilLock);
+            const char *entry = stil.getEntry(path);
+            return std::string(entry != nullptr ? entry : "");
+        };
+#endif
+    }
+
+    if (!force)
+        options.previous = output;
+
+    SidCatalog::stats_t stats;
+    if (!SidCatalog::build(source, output, options, &stats))
+    {
+        std::fprintf(stderr, "Cataloging of %s failed\n", source);
+        return 1;
+    }
+
+    std::printf("%zu files, %zu tunes: %zu read, %zu unchanged\n",
+        stats.files, stats.tunes, stats.loaded, stats.reused);
+    return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Tune collection packer.
+ *
+ * Packs the files listed on standard input, relative
+ * to the collection root, into a single file:
+ *     cd C64Music && find . -type f | sidpack . ../HVSC.spk
+ *
+ * Lists the content of a pack:
+ *     sidpack -l HVSC.spk
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "utils/SidPack.h"
+
+int list(const char *filename)
+{
+    SidPack pack;
+    if (!pack.open(filename))
+    {
+        std::fprintf(stderr, "%s\n", pack.error());
+        return 1;
+    }
+
+    for (size_t i = 0; i < pack.count(); i++)
+    {
+        SidPack::entry_t entry;
+        if (!pack.entry(i, entry))
+        {
+            std::fprintf(stderr, "Corrupt entry %zu\n", i);
+            return 1;
+        }
+        std::printf("%s %8u %s\n", entry.md5, static_cast<unsigned int>(entry.size), entry.path);
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if ((argc == 3) && (std::strcmp(argv[1], "-l") == 0))
+        return list(argv[2]);
+
+    if (argc != 3)
+    {
+        std::fprintf(stderr, "Usage: %s <collection root> <output> < file list\n", argv[0]);
+        std::fprintf(stderr, "       %s -l <pack>\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<std::string> files;
+    std::string line;
+    while (std::getline(std::cin, line))
+    {
+        if (!line.empty() && (line.back() == '\r'))
+            line.pop_back();
+        if (!line.empty())
+            files.push_back(line);
+    }
+
+    std::vector<const char*> paths;
+    for (const std::string &file: files)
+        paths.push_back(file.c_str());
+
+    if (!SidPack::create(argv[1], paths.data(), paths.size(), argv[2]))
+    {
+        std::fprintf(stderr, "Packing of %s failed\n", argv[1]);
+        return 1;
+    }
+
+    SidPack pack;
+    if (!pack.open(argv[2]))
+    {
+        std::fprintf(stderr, "%s\n", pack.error());
+        return 1;
+    }
+
+    std::printf("%zu files packed\n", pack.count());
+    return 0;
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2026 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Songlength database converter.
+ *
+ * Writes the binary index of a Songlengths.md5 file,
+ * which SidDatabase::open() maps instead of parsing:
+ *     sldbconv Songlengths.md5 Songlengths.sldb
+ */
+
+#include <cstdio>
+
+#include "utils/SidDatabase.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::fprintf(stderr, "Usage: %s <Songlengths.md5> <output>\n", argv[0]);
+        return 1;
+    }
+
+    if (!SidDatabase::convert(argv[1], argv[2]))
+    {
+        std::fprintf(stderr, "Conversion of %s failed\n", argv[1]);
+        return 1;
+    }
+
+    SidDatabase database;
+    if (!database.open(argv[2]))
+    {
+        std::fprintf(stderr, "%s\n", database.error());
+        return 1;
+    }
+
+    return 0;
+}